@@ -162,10 +162,13 @@ CAuxPow::createAuxPow (const CPureBlockHeader& header)
 {
   assert (header.IsAuxpow ());
 
-  /* Build a minimal coinbase script input for merge-mining.  */
+  /* Build a minimal coinbase script input for merge-mining.  The merged
+     mining header is required by check.  */
   const uint256 blockHash = header.GetHash ();
-  valtype inputData(blockHash.begin (), blockHash.end ());
-  std::reverse (inputData.begin (), inputData.end ());
+  valtype inputData(pchMergedMiningHeader,
+                    pchMergedMiningHeader + sizeof (pchMergedMiningHeader));
+  inputData.insert (inputData.end (), blockHash.begin (), blockHash.end ());
+  std::reverse (inputData.end () - blockHash.size (), inputData.end ());
   inputData.push_back (1);
   inputData.insert (inputData.end (), 7, 0);
 
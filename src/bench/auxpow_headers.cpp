@@ -0,0 +1,67 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <arith_uint256.h>
+#include <auxpow.h>
+#include <bench/bench.h>
+#include <chainparams.h>
+#include <pow.h>
+#include <util/system.h>
+#include <validation.h>
+
+#include <boost/thread/thread.hpp>
+
+// As many headers as a full HEADERS message, so headers/sec is 2000 over the time per iteration
+static const int HEADERS = 2000;
+static const int MIN_CORES = 2;
+
+// Merge-mined headers with a minimal auxpow, each mined at the regtest difficulty
+static std::vector<CBlockHeader> CreateAuxpowHeaders(const Consensus::Params& params)
+{
+    std::vector<CBlockHeader> headers(HEADERS);
+    for (int i = 0; i < HEADERS; ++i) {
+        CBlockHeader& header = headers[i];
+        header.SetBaseVersion(4, params.nAuxpowChainId);
+        header.nTime = i;
+        header.nBits = UintToArith256(params.powLimit).GetCompact();
+        CPureBlockHeader& parent = CAuxPow::initAuxPow(header);
+        while (!CheckProofOfWork(parent.GetHash(), header.nBits, params)) {
+            ++parent.nNonce;
+        }
+    }
+    return headers;
+}
+
+// The checks ProcessNewBlockHeaders did one after another under cs_main
+static void HeadersPoWSerial(benchmark::State& state)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    const std::vector<CBlockHeader> headers = CreateAuxpowHeaders(params);
+    while (state.KeepRunning()) {
+        for (const CBlockHeader& header : headers) {
+            bool ret = CheckProofOfWork(header, params);
+            assert(ret);
+        }
+    }
+}
+
+// The same batch spread over the header-checking threads
+static void HeadersPoWParallel(benchmark::State& state)
+{
+    const Consensus::Params& params = Params().GetConsensus();
+    const std::vector<CBlockHeader> headers = CreateAuxpowHeaders(params);
+    boost::thread_group tg;
+    for (int i = 0; i < std::max(MIN_CORES, GetNumCores()) - 1; ++i) {
+        tg.create_thread([i] { ThreadHeaderCheck(i); });
+    }
+    while (state.KeepRunning()) {
+        bool ret = CheckHeadersProofOfWork(headers, params) == headers.size();
+        assert(ret);
+    }
+    tg.interrupt_all();
+    tg.join_all();
+}
+
+BENCHMARK(HeadersPoWSerial, 5);
+BENCHMARK(HeadersPoWParallel, 5);
@@ -0,0 +1,216 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <cachemap.h>
+#include <cachemultimap.h>
+#include <crypto/common.h>
+
+#include <list>
+#include <map>
+
+/**
+ * The std::list + std::map layout CacheMap used before, kept here to compare against
+ */
+template<typename K, typename V>
+class ListCacheMap
+{
+private:
+    typedef std::list<CacheItem<K, V>> list_t;
+    size_t nMaxSize;
+    list_t listItems;
+    std::map<K, typename list_t::iterator> mapIndex;
+
+public:
+    explicit ListCacheMap(size_t nMaxSizeIn) : nMaxSize(nMaxSizeIn) {}
+
+    bool Insert(const K& key, const V& value)
+    {
+        if (mapIndex.find(key) != mapIndex.end()) {
+            return false;
+        }
+        if (listItems.size() == nMaxSize) {
+            mapIndex.erase(listItems.back().key);
+            listItems.pop_back();
+        }
+        listItems.push_front(CacheItem<K, V>(key, value));
+        mapIndex.emplace(key, listItems.begin());
+        return true;
+    }
+
+    bool HasKey(const K& key) const
+    {
+        return mapIndex.find(key) != mapIndex.end();
+    }
+
+    void Erase(const K& key)
+    {
+        auto it = mapIndex.find(key);
+        if (it == mapIndex.end()) {
+            return;
+        }
+        listItems.erase(it->second);
+        mapIndex.erase(it);
+    }
+};
+
+/**
+ * The std::list + nested std::map layout CacheMultiMap used before
+ */
+template<typename K, typename V>
+class NestedCacheMultiMap
+{
+private:
+    typedef std::list<CacheItem<K, V>> list_t;
+    typedef std::map<V, typename list_t::iterator> it_map_t;
+    size_t nMaxSize;
+    list_t listItems;
+    std::map<K, it_map_t> mapIndex;
+
+    void PruneLast()
+    {
+        const CacheItem<K, V>& item = listItems.back();
+        auto mit = mapIndex.find(item.key);
+        mit->second.erase(item.value);
+        if (mit->second.empty()) {
+            mapIndex.erase(mit);
+        }
+        listItems.pop_back();
+    }
+
+public:
+    explicit NestedCacheMultiMap(size_t nMaxSizeIn) : nMaxSize(nMaxSizeIn) {}
+
+    bool Insert(const K& key, const V& value)
+    {
+        it_map_t& mapIt = mapIndex[key];
+        if (mapIt.count(value) > 0) {
+            return false;
+        }
+        if (listItems.size() == nMaxSize) {
+            PruneLast();
+        }
+        listItems.push_front(CacheItem<K, V>(key, value));
+        mapIndex[key].emplace(value, listItems.begin());
+        return true;
+    }
+
+    void Erase(const K& key, const V& value)
+    {
+        auto mit = mapIndex.find(key);
+        if (mit == mapIndex.end()) {
+            return;
+        }
+        auto it = mit->second.find(value);
+        if (it == mit->second.end()) {
+            return;
+        }
+        listItems.erase(it->second);
+        mit->second.erase(it);
+        if (mit->second.empty()) {
+            mapIndex.erase(mit);
+        }
+    }
+};
+
+static const size_t CACHE_BENCH_SIZE = 10000;
+
+static std::vector<uint256> CacheBenchKeys()
+{
+    std::vector<uint256> vecKeys(CACHE_BENCH_SIZE * 4);
+    for (size_t i = 0; i < vecKeys.size(); ++i) {
+        WriteLE64(vecKeys[i].begin(), i * 0x9E3779B97F4A7C15ULL);
+    }
+    return vecKeys;
+}
+
+// Mirrors the governance vote cache usage: insert with pruning, lookups and erases
+template<typename Cache>
+static void CacheChurn(benchmark::State& state, Cache& cache)
+{
+    const std::vector<uint256> vecKeys = CacheBenchKeys();
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        const uint256& key = vecKeys[n % vecKeys.size()];
+        cache.Insert(key, n);
+        cache.HasKey(vecKeys[(n * 7) % vecKeys.size()]);
+        if (n % 4 == 0) {
+            cache.Erase(vecKeys[(n / 2) % vecKeys.size()]);
+        }
+        ++n;
+    }
+}
+
+static void CacheMapChurn(benchmark::State& state)
+{
+    CacheMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    CacheChurn(state, cache);
+}
+
+static void ListCacheMapChurn(benchmark::State& state)
+{
+    ListCacheMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    CacheChurn(state, cache);
+}
+
+// Orphan votes: many votes for each object, each erased again once the object arrives
+template<typename Cache>
+static void MultiMapChurn(benchmark::State& state, Cache& cache, size_t nValuesPerKey)
+{
+    const std::vector<uint256> vecKeys = CacheBenchKeys();
+    size_t n = 0;
+    while (state.KeepRunning()) {
+        const uint256& key = vecKeys[(n / nValuesPerKey) % vecKeys.size()];
+        cache.Insert(key, n);
+        if (n % 4 == 0 && n >= nValuesPerKey / 2) {
+            cache.Erase(key, n - nValuesPerKey / 2);
+        }
+        ++n;
+    }
+}
+
+static void CacheMultiMapChurn10(benchmark::State& state)
+{
+    CacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 10);
+}
+
+static void NestedCacheMultiMapChurn10(benchmark::State& state)
+{
+    NestedCacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 10);
+}
+
+static void CacheMultiMapChurn500(benchmark::State& state)
+{
+    CacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 500);
+}
+
+static void NestedCacheMultiMapChurn500(benchmark::State& state)
+{
+    NestedCacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 500);
+}
+
+static void CacheMultiMapChurn5000(benchmark::State& state)
+{
+    CacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 5000);
+}
+
+static void NestedCacheMultiMapChurn5000(benchmark::State& state)
+{
+    NestedCacheMultiMap<uint256, size_t> cache(CACHE_BENCH_SIZE);
+    MultiMapChurn(state, cache, 5000);
+}
+
+BENCHMARK(CacheMapChurn, 1000 * 1000);
+BENCHMARK(ListCacheMapChurn, 1000 * 1000);
+BENCHMARK(CacheMultiMapChurn10, 1000 * 1000);
+BENCHMARK(NestedCacheMultiMapChurn10, 1000 * 1000);
+BENCHMARK(CacheMultiMapChurn500, 1000 * 1000);
+BENCHMARK(NestedCacheMultiMapChurn500, 1000 * 1000);
+BENCHMARK(CacheMultiMapChurn5000, 1000 * 1000);
+BENCHMARK(NestedCacheMultiMapChurn5000, 1000 * 1000);
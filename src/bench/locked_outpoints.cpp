@@ -0,0 +1,59 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/validation.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <services/assetconsensus.h>
+
+static const int LOCKED_OUTPOINTS = 100;
+static const int TX_INPUTS = 1000;
+
+// A locked outpoint database holding a few outpoints and a transaction spending none of them
+static CTransactionRef SetupLockedOutpoints()
+{
+    plockedoutpointsdb.reset(new CLockedOutpointsDB(1 << 20, true, true));
+    std::vector<COutPoint> vecLocked;
+    for (int i = 0; i < LOCKED_OUTPOINTS; ++i) {
+        vecLocked.emplace_back(GetRandHash(), i);
+    }
+    assert(plockedoutpointsdb->FlushWrite(vecLocked));
+
+    CMutableTransaction mtx;
+    for (int i = 0; i < TX_INPUTS; ++i) {
+        mtx.vin.emplace_back(COutPoint(GetRandHash(), i));
+    }
+    mtx.vout.emplace_back(1000, CScript() << OP_TRUE);
+    return MakeTransactionRef(mtx);
+}
+
+// The check done before a transaction is accepted, answered from memory
+static void LockedOutpointsCheck(benchmark::State& state)
+{
+    const CTransactionRef tx = SetupLockedOutpoints();
+    while (state.KeepRunning()) {
+        TxValidationState tx_state;
+        bool ret = CheckSyscoinLockedOutpoints(tx, tx_state);
+        assert(ret);
+    }
+    plockedoutpointsdb.reset();
+}
+
+// The same lookups going to the database for every input
+static void LockedOutpointsDBRead(benchmark::State& state)
+{
+    const CTransactionRef tx = SetupLockedOutpoints();
+    while (state.KeepRunning()) {
+        for (const CTxIn& txin : tx->vin) {
+            bool locked = false;
+            bool ret = plockedoutpointsdb->Read(txin.prevout, locked);
+            assert(!ret);
+        }
+    }
+    plockedoutpointsdb.reset();
+}
+
+BENCHMARK(LockedOutpointsCheck, 500);
+BENCHMARK(LockedOutpointsDBRead, 500);
@@ -0,0 +1,108 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <net.h>
+#include <netbase.h>
+#include <netmessagemaker.h>
+#include <protocol.h>
+#include <version.h>
+
+#include <limits>
+
+#include <sys/socket.h>
+
+static const int IDLE_PEERS = 400;
+static const int BUSY_PEERS = 10;
+
+struct CConnmanTest : public CConnman {
+    using CConnman::CConnman;
+
+    std::vector<SOCKET> vRemote;
+
+    // Connected socket pairs stand in for loopback peers, the remote end of every pair is kept to write to
+    void AddPeers(int nPeers)
+    {
+        LOCK(cs_vNodes);
+        for (int i = 0; i < nPeers; i++) {
+            int fds[2];
+            if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+                assert(false);
+            }
+            vRemote.push_back(fds[1]);
+            vNodes.push_back(new CNode(i, NODE_NONE, 0, fds[0], CAddress(), 0, 0, CAddress(), "", true));
+        }
+    }
+
+    void ClearPeers()
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodes) {
+            pnode->CloseSocketDisconnect();
+            delete pnode;
+        }
+        vNodes.clear();
+        for (SOCKET hSocket : vRemote) {
+            CloseSocket(hSocket);
+        }
+        vRemote.clear();
+    }
+
+    void Run(benchmark::State& state, SocketEventsMode mode)
+    {
+        CConnman::Options options;
+        options.nReceiveFloodSize = std::numeric_limits<unsigned int>::max();
+        options.m_peer_connect_timeout = std::numeric_limits<int>::max();
+        options.socketEventsMode = mode;
+        Init(options);
+#ifdef USE_EPOLL
+        if (mode == SOCKETEVENTS_EPOLL) {
+            assert(StartEpoll());
+        }
+#endif
+        AddPeers(IDLE_PEERS + BUSY_PEERS);
+
+        CSerializedNetMsg msg = CNetMsgMaker(INIT_PROTO_VERSION).Make(NetMsgType::PING, uint64_t{0});
+        std::vector<unsigned char> vPing;
+        V1TransportSerializer().prepareForTransport(msg, vPing);
+        vPing.insert(vPing.end(), msg.data.begin(), msg.data.end());
+
+        while (state.KeepRunning()) {
+            // a ping from every busy peer, the idle ones stay silent
+            for (int i = IDLE_PEERS; i < IDLE_PEERS + BUSY_PEERS; i++) {
+                assert(send(vRemote[i], (const char*)vPing.data(), vPing.size(), MSG_NOSIGNAL) == (ssize_t)vPing.size());
+            }
+            SocketHandler();
+        }
+
+        // the pings were read although the busy peers come last
+        for (int i = IDLE_PEERS; i < IDLE_PEERS + BUSY_PEERS; i++) {
+            assert(!vNodes[i]->vProcessMsg.empty());
+        }
+        ClearPeers();
+#ifdef USE_EPOLL
+        StopEpoll();
+#endif
+    }
+};
+
+#ifdef USE_POLL
+static void SocketEventsPoll(benchmark::State& state)
+{
+    CConnmanTest connman(0x1337, 0x1337);
+    connman.Run(state, SOCKETEVENTS_POLL);
+}
+
+BENCHMARK(SocketEventsPoll, 2000);
+#endif
+
+#ifdef USE_EPOLL
+static void SocketEventsEpoll(benchmark::State& state)
+{
+    CConnmanTest connman(0x1337, 0x1337);
+    connman.Run(state, SOCKETEVENTS_EPOLL);
+}
+
+BENCHMARK(SocketEventsEpoll, 2000);
+#endif
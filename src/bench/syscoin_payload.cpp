@@ -0,0 +1,64 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
+
+// ZDAG acceptance looks at the payload for the sender, the locked outpoint check,
+// the input checks and the zmq actors
+static const int ZDAG_PAYLOAD_READS = 4;
+static const int ZDAG_RECEIVERS = 10;
+
+static CMutableTransaction ZdagTx()
+{
+    CAssetAllocation assetAllocation;
+    assetAllocation.assetAllocationTuple = CAssetAllocationTuple(1234, CWitnessAddress(0, std::vector<unsigned char>(20, 1)));
+    for (int i = 0; i < ZDAG_RECEIVERS; ++i) {
+        assetAllocation.listSendingAllocationAmounts.emplace_back(CWitnessAddress(0, std::vector<unsigned char>(20, 2 + i)), 1000 + i);
+    }
+    std::vector<unsigned char> vchData;
+    assetAllocation.Serialize(vchData);
+
+    CMutableTransaction mtx;
+    mtx.nVersion = SYSCOIN_TX_VERSION_ALLOCATION_SEND;
+    mtx.vin.resize(1);
+    mtx.vout.resize(2);
+    mtx.vout[0].nValue = 1000;
+    mtx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    mtx.vout[1].nValue = 0;
+    mtx.vout[1].scriptPubKey = CScript() << OP_RETURN << vchData;
+    return mtx;
+}
+
+// Every consumer deserializes its own copy of the payload
+static void SyscoinPayloadParse(benchmark::State& state)
+{
+    const CMutableTransaction mtx = ZdagTx();
+    while (state.KeepRunning()) {
+        const CTransaction tx(mtx);
+        for (int i = 0; i < ZDAG_PAYLOAD_READS; ++i) {
+            CAssetAllocation assetAllocation(tx);
+            assert(!assetAllocation.assetAllocationTuple.IsNull());
+        }
+    }
+}
+
+// The payload is parsed on first use and shared afterwards
+static void SyscoinPayloadCached(benchmark::State& state)
+{
+    const CMutableTransaction mtx = ZdagTx();
+    while (state.KeepRunning()) {
+        const CTransaction tx(mtx);
+        for (int i = 0; i < ZDAG_PAYLOAD_READS; ++i) {
+            const auto payload = GetSyscoinPayload(tx);
+            assert(!payload->assetAllocation.assetAllocationTuple.IsNull());
+        }
+    }
+}
+
+BENCHMARK(SyscoinPayloadParse, 50 * 1000);
+BENCHMARK(SyscoinPayloadCached, 50 * 1000);
@@ -0,0 +1,77 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/validation.h>
+#include <crypto/sha256.h>
+#include <services/txload.h>
+#include <test/util/mining.h>
+#include <test/util/setup_common.h>
+#include <txmempool.h>
+#include <validation.h>
+
+#include <vector>
+
+static const int LOAD_CHAINS = 100;
+static const int LOAD_CHAIN_LENGTH = 5;
+
+static void TxLoad(benchmark::State& state, int nThreads)
+{
+    const std::vector<unsigned char> op_true{OP_TRUE};
+    CScriptWitness witness;
+    witness.stack.push_back(op_true);
+
+    uint256 witness_program;
+    CSHA256().Write(&op_true[0], op_true.size()).Finalize(witness_program.begin());
+
+    const CScript SCRIPT_PUB{CScript(OP_0) << std::vector<unsigned char>{witness_program.begin(), witness_program.end()}};
+
+    // Fan a mature coinbase out into one confirmed output per chain
+    CMutableTransaction fanout;
+    fanout.vin.push_back(MineBlock(g_testing_setup->m_node, SCRIPT_PUB));
+    fanout.vin.back().scriptWitness = witness;
+    for (int i = 0; i < COINBASE_MATURITY; ++i) {
+        MineBlock(g_testing_setup->m_node, SCRIPT_PUB);
+    }
+    CAmount nValue;
+    {
+        LOCK(::cs_main);
+        nValue = ::ChainstateActive().CoinsTip().AccessCoin(fanout.vin.back().prevout).out.nValue / (LOAD_CHAINS + 1);
+        for (int i = 0; i < LOAD_CHAINS; ++i) {
+            fanout.vout.emplace_back(nValue, SCRIPT_PUB);
+        }
+        TxValidationState tx_state;
+        bool ret{::AcceptToMemoryPool(::mempool, tx_state, MakeTransactionRef(fanout), nullptr /* plTxnReplaced */, false /* bypass_limits */, /* nAbsurdFee */ 0)};
+        assert(ret);
+    }
+    MineBlock(g_testing_setup->m_node, SCRIPT_PUB);
+
+    // Chains of spends so the load generator has to keep parents and children on one thread
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < LOAD_CHAINS; ++i) {
+        COutPoint prevout(fanout.GetHash(), i);
+        for (int j = 0; j < LOAD_CHAIN_LENGTH; ++j) {
+            CMutableTransaction tx;
+            tx.vin.emplace_back(prevout);
+            tx.vin.back().scriptWitness = witness;
+            tx.vout.emplace_back(nValue - (j + 1) * 1000, SCRIPT_PUB);
+            txs.push_back(MakeTransactionRef(tx));
+            prevout = COutPoint(txs.back()->GetHash(), 0);
+        }
+    }
+
+    // AcceptToMemoryPool holds cs_main, so the four thread run measures lock contention rather than parallel admission
+    while (state.KeepRunning()) {
+        CTxLoadGenerator load(g_testing_setup->m_node, txs, nThreads, false /* fRelay */);
+        load.Run();
+        assert(load.GetAccepted() == txs.size());
+        ::mempool.clear();
+    }
+}
+
+static void TxLoadOneThread(benchmark::State& state) { TxLoad(state, 1); }
+static void TxLoadFourThreads(benchmark::State& state) { TxLoad(state, 4); }
+
+BENCHMARK(TxLoadOneThread, 10);
+BENCHMARK(TxLoadFourThreads, 10);
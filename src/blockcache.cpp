@@ -0,0 +1,80 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockcache.h>
+
+#include <core_memusage.h>
+#include <memusage.h>
+
+CRecentBlockCache recentblockcache;
+
+size_t CRecentBlockCache::BlockMemory(const CBlock& block)
+{
+    // the block itself, its list entry and its index entry
+    return sizeof(CBlock) + RecursiveDynamicUsage(block) + memusage::MallocUsage(sizeof(BlockList::value_type) + 2 * sizeof(void*)) +
+        memusage::MallocUsage(sizeof(std::pair<const uint256, BlockList::iterator>) + sizeof(void*));
+}
+
+void CRecentBlockCache::Trim()
+{
+    while (nMemory > nMaxMemory && !listBlocks.empty()) {
+        nMemory -= BlockMemory(*listBlocks.back().second);
+        mapBlocks.erase(listBlocks.back().first);
+        listBlocks.pop_back();
+    }
+}
+
+void CRecentBlockCache::SetMaxMemory(size_t nMaxMemoryIn)
+{
+    LOCK(cs_cache);
+    nMaxMemory = nMaxMemoryIn;
+    Trim();
+}
+
+void CRecentBlockCache::Add(const std::shared_ptr<const CBlock>& pblock)
+{
+    const uint256 hash = pblock->GetHash();
+    const size_t nBlockMemory = BlockMemory(*pblock);
+    LOCK(cs_cache);
+    if (mapBlocks.count(hash) || nBlockMemory > nMaxMemory) {
+        return;
+    }
+    listBlocks.emplace_front(hash, pblock);
+    mapBlocks.emplace(hash, listBlocks.begin());
+    nMemory += nBlockMemory;
+    Trim();
+}
+
+std::shared_ptr<const CBlock> CRecentBlockCache::Get(const uint256& hash)
+{
+    LOCK(cs_cache);
+    auto it = mapBlocks.find(hash);
+    if (it == mapBlocks.end()) {
+        nMisses++;
+        return nullptr;
+    }
+    nHits++;
+    listBlocks.splice(listBlocks.begin(), listBlocks, it->second);
+    return it->second->second;
+}
+
+void CRecentBlockCache::Clear()
+{
+    LOCK(cs_cache);
+    listBlocks.clear();
+    mapBlocks.clear();
+    nMemory = 0;
+}
+
+UniValue CRecentBlockCache::ToJSON() const
+{
+    LOCK(cs_cache);
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("blocks", (uint64_t)listBlocks.size());
+    obj.pushKV("usage", (uint64_t)nMemory);
+    obj.pushKV("max", (uint64_t)nMaxMemory);
+    obj.pushKV("hits", nHits);
+    obj.pushKV("misses", nMisses);
+    return obj;
+}
@@ -0,0 +1,66 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_BLOCKCACHE_H
+#define SYSCOIN_BLOCKCACHE_H
+
+#include <crypto/common.h>
+#include <primitives/block.h>
+#include <sync.h>
+#include <uint256.h>
+#include <univalue.h>
+
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+/** Default for -blockcachesize, the memory (MiB) kept for recently connected blocks */
+static const int64_t DEFAULT_RECENT_BLOCK_CACHE = 32;
+
+/**
+ * Least recently used cache of deserialized blocks, filled as blocks are connected. RPCs, SPV proofs,
+ * masternode payment scans and index catch-up tend to read the same recent blocks again and again,
+ * they get them from here instead of deserializing them from the block files every time. Blocks
+ * are shared and immutable, so callers can keep using them after they were evicted.
+ */
+class CRecentBlockCache
+{
+private:
+    struct BlockHashHasher {
+        size_t operator()(const uint256& hash) const { return ReadLE64(hash.begin()); }
+    };
+
+    typedef std::list<std::pair<uint256, std::shared_ptr<const CBlock>>> BlockList;
+
+    mutable Mutex cs_cache;
+    /** Most recently used block first */
+    BlockList listBlocks GUARDED_BY(cs_cache);
+    std::unordered_map<uint256, BlockList::iterator, BlockHashHasher> mapBlocks GUARDED_BY(cs_cache);
+    size_t nMemory GUARDED_BY(cs_cache){0};
+    size_t nMaxMemory GUARDED_BY(cs_cache){DEFAULT_RECENT_BLOCK_CACHE << 20};
+    uint64_t nHits GUARDED_BY(cs_cache){0};
+    uint64_t nMisses GUARDED_BY(cs_cache){0};
+
+    static size_t BlockMemory(const CBlock& block);
+    void Trim() EXCLUSIVE_LOCKS_REQUIRED(cs_cache);
+
+public:
+    /** Set the memory allowed for the cached blocks, evicting the least recently used ones beyond it */
+    void SetMaxMemory(size_t nMaxMemoryIn);
+
+    /** Add a block, unless it alone exceeds the memory allowed */
+    void Add(const std::shared_ptr<const CBlock>& pblock);
+
+    /** The cached block with that hash, or nullptr. Counts as a hit or a miss. */
+    std::shared_ptr<const CBlock> Get(const uint256& hash);
+
+    void Clear();
+
+    /** Cached blocks, memory usage and the hits and misses of lookups */
+    UniValue ToJSON() const;
+};
+
+extern CRecentBlockCache recentblockcache;
+
+#endif // SYSCOIN_BLOCKCACHE_H
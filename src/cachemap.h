@@ -6,11 +6,19 @@
 #ifndef SYSCOIN_CACHEMAP_H
 #define SYSCOIN_CACHEMAP_H
 
-#include <map>
-#include <list>
 #include <cstddef>
-
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include <crypto/siphash.h>
+#include <primitives/transaction.h>
+#include <random.h>
 #include <serialize.h>
+#include <uint256.h>
 
 /**
  * Serializable structure for key/value items
@@ -39,56 +47,176 @@ struct CacheItem
     }
 };
 
+/**
+ * Salted hashers for the key types used with the caches below
+ */
+template<typename K>
+class CacheKeyHasher;
+
+template<>
+class CacheKeyHasher<uint256>
+{
+private:
+    uint64_t k0, k1;
+
+public:
+    CacheKeyHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+    size_t operator()(const uint256& key) const {
+        return SipHashUint256(k0, k1, key);
+    }
+};
+
+template<>
+class CacheKeyHasher<COutPoint>
+{
+private:
+    uint64_t k0, k1;
+
+public:
+    CacheKeyHasher() : k0(GetRand(std::numeric_limits<uint64_t>::max())), k1(GetRand(std::numeric_limits<uint64_t>::max())) {}
+
+    size_t operator()(const COutPoint& key) const {
+        return SipHashUint256Extra(k0, k1, key.hash, key.n);
+    }
+};
 
 /**
- * Map like container that keeps the N most recently added items
+ * Extra per slot data of a container built on CacheStorage, none by default
  */
-template<typename K, typename V, typename Size = uint32_t>
-class CacheMap
+struct CacheNoLinks
+{
+};
+
+/**
+ * Flat storage shared by CacheMap and CacheMultiMap.
+ *
+ * Items live in fixed size chunks of slots, so references to them stay valid while
+ * other items are inserted. Slots are chained into an intrusive doubly linked list
+ * ordered from the most to the least recently added item, and items sharing a key
+ * are chained together. Keys are found through an open addressing (linear probing)
+ * table of slot numbers. Unlike the former std::list + std::map layout this costs
+ * no allocation per insert.
+ */
+template<typename K, typename V, typename Size, typename Links = CacheNoLinks>
+class CacheStorage
 {
 public:
     typedef Size size_type;
 
     typedef CacheItem<K,V> item_t;
 
-    typedef std::list<item_t> list_t;
-
-    typedef typename list_t::iterator list_it;
-
-    typedef typename list_t::const_iterator list_cit;
+protected:
+    static const uint32_t NO_SLOT = std::numeric_limits<uint32_t>::max();
+    static const size_t NO_POS = std::numeric_limits<size_t>::max();
 
-    typedef std::map<K, list_it> map_t;
+    static const uint32_t CHUNK_BITS = 6;
+    static const uint32_t CHUNK_SIZE = 1 << CHUNK_BITS;
+    static const uint32_t CHUNK_MASK = CHUNK_SIZE - 1;
 
-    typedef typename map_t::iterator map_it;
+    struct slot_t : public Links
+    {
+        // raw storage, the item is only constructed while the slot is in use
+        typename std::aligned_storage<sizeof(item_t), alignof(item_t)>::type storage;
+        size_t nHash{0};
+        // list order, towards the more and the less recently added items
+        uint32_t nPrev{NO_SLOT};
+        uint32_t nNext{NO_SLOT};
+        // other items with the same key, only the first one is in vecTable
+        uint32_t nKeyPrev{NO_SLOT};
+        uint32_t nKeyNext{NO_SLOT};
+
+        item_t& Item() { return *reinterpret_cast<item_t*>(&storage); }
+        const item_t& Item() const { return *reinterpret_cast<const item_t*>(&storage); }
+    };
 
-    typedef typename map_t::const_iterator map_cit;
+    size_type nMaxSize;
 
 private:
-    size_type nMaxSize;
+    std::vector<std::unique_ptr<slot_t[]>> vecChunks;
+    uint32_t nSlotsUsed{0};
+    uint32_t nFree{NO_SLOT};
+    uint32_t nHead{NO_SLOT};
+    uint32_t nTail{NO_SLOT};
+    size_type nSize{0};
 
-    list_t listItems;
+    std::vector<uint32_t> vecTable;
+    size_t nKeys{0};
 
-    map_t mapIndex;
+    CacheKeyHasher<K> hasher;
 
 public:
-    explicit CacheMap(size_type nMaxSizeIn = 0)
-        : nMaxSize(nMaxSizeIn),
-          listItems(),
-          mapIndex()
+    /**
+     * Iterates over the items from the most to the least recently added one.
+     * Erasing other items or inserting new ones does not invalidate it.
+     */
+    class const_iterator
+    {
+    private:
+        const CacheStorage* pstorage;
+        uint32_t n;
+
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef item_t value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const item_t* pointer;
+        typedef const item_t& reference;
+
+        const_iterator(const CacheStorage* pstorageIn, uint32_t nIn) : pstorage(pstorageIn), n(nIn) {}
+
+        reference operator*() const { return pstorage->GetSlot(n).Item(); }
+        pointer operator->() const { return &pstorage->GetSlot(n).Item(); }
+
+        const_iterator& operator++() { n = pstorage->GetSlot(n).nNext; return *this; }
+        const_iterator operator++(int) { const_iterator ret = *this; ++(*this); return ret; }
+
+        bool operator==(const const_iterator& other) const { return n == other.n; }
+        bool operator!=(const const_iterator& other) const { return n != other.n; }
+    };
+
+    typedef const_iterator list_cit;
+
+    /**
+     * View of the items in list order as returned by GetItemList()
+     */
+    class list_t
+    {
+    private:
+        const CacheStorage* pstorage;
+
+    public:
+        explicit list_t(const CacheStorage* pstorageIn) : pstorage(pstorageIn) {}
+
+        const_iterator begin() const { return pstorage->begin(); }
+        const_iterator end() const { return pstorage->end(); }
+        size_type size() const { return pstorage->GetSize(); }
+        bool empty() const { return pstorage->GetSize() == 0; }
+    };
+
+    explicit CacheStorage(size_type nMaxSizeIn)
+        : nMaxSize(nMaxSizeIn)
     {}
 
-    explicit CacheMap(const CacheMap<K,V>& other)
-        : nMaxSize(other.nMaxSize),
-          listItems(other.listItems),
-          mapIndex()
+    CacheStorage(const CacheStorage&) = delete;
+    CacheStorage& operator=(const CacheStorage&) = delete;
+
+    ~CacheStorage()
     {
-        RebuildIndex();
+        DestroyItems();
     }
 
     void Clear()
     {
-        mapIndex.clear();
-        listItems.clear();
+        DestroyItems();
+        vecChunks.clear();
+        nSlotsUsed = 0;
+        nFree = NO_SLOT;
+        nHead = NO_SLOT;
+        nTail = NO_SLOT;
+        nSize = 0;
+        vecTable.clear();
+        nKeys = 0;
     }
 
     void SetMaxSize(size_type nMaxSizeIn)
@@ -101,88 +229,354 @@ public:
     }
 
     size_type GetSize() const {
-        return listItems.size();
+        return nSize;
     }
 
-    bool Insert(const K& key, const V& value)
+    bool HasKey(const K& key) const
     {
-        if(mapIndex.find(key) != mapIndex.end()) {
-            return false;
-        }
-        if(listItems.size() == nMaxSize) {
-            PruneLast();
+        return FindKey(key) != NO_SLOT;
+    }
+
+    const_iterator begin() const { return const_iterator(this, nHead); }
+    const_iterator end() const { return const_iterator(this, NO_SLOT); }
+
+    list_t GetItemList() const {
+        return list_t(this);
+    }
+
+    /** Serialized like the std::list of items it replaces */
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << nMaxSize;
+        WriteCompactSize(s, nSize);
+        for(uint32_t n = nHead; n != NO_SLOT; n = GetSlot(n).nNext) {
+            s << GetSlot(n).Item();
         }
-        listItems.push_front(item_t(key, value));
-        mapIndex.emplace(key, listItems.begin());
-        return true;
     }
 
-    bool HasKey(const K& key) const
+protected:
+    slot_t& GetSlot(uint32_t n) {
+        return vecChunks[n >> CHUNK_BITS][n & CHUNK_MASK];
+    }
+
+    const slot_t& GetSlot(uint32_t n) const {
+        return vecChunks[n >> CHUNK_BITS][n & CHUNK_MASK];
+    }
+
+    size_t HashKey(const K& key) const {
+        return hasher(key);
+    }
+
+    /** First slot holding key, the others follow through nKeyNext */
+    uint32_t FindKey(const K& key) const
     {
-        return (mapIndex.find(key) != mapIndex.end());
+        return FindKey(key, hasher(key));
     }
 
-    bool Get(const K& key, V& value) const
+    uint32_t FindKey(const K& key, size_t nHash) const
     {
-        map_cit it = mapIndex.find(key);
-        if(it == mapIndex.end()) {
-            return false;
+        size_t nPos = FindPos(key, nHash);
+        return nPos == NO_POS ? NO_SLOT : vecTable[nPos];
+    }
+
+    uint32_t GetTail() const {
+        return nTail;
+    }
+
+    uint32_t AddItem(const K& key, const V& value, bool fFront)
+    {
+        return AddItem(key, value, fFront, hasher(key));
+    }
+
+    /** New items with a key already stored are chained right behind its first slot */
+    uint32_t AddItem(const K& key, const V& value, bool fFront, size_t nHash)
+    {
+        const size_t nPos = FindPos(key, nHash);
+
+        const uint32_t n = AllocSlot();
+        slot_t& slot = GetSlot(n);
+        new (&slot.storage) item_t(key, value);
+        slot.nHash = nHash;
+
+        if(fFront) {
+            slot.nPrev = NO_SLOT;
+            slot.nNext = nHead;
+            if(nHead != NO_SLOT) {
+                GetSlot(nHead).nPrev = n;
+            } else {
+                nTail = n;
+            }
+            nHead = n;
+        } else {
+            slot.nPrev = nTail;
+            slot.nNext = NO_SLOT;
+            if(nTail != NO_SLOT) {
+                GetSlot(nTail).nNext = n;
+            } else {
+                nHead = n;
+            }
+            nTail = n;
         }
-        item_t& item = *(it->second);
-        value = item.value;
-        return true;
+
+        if(nPos != NO_POS) {
+            // chain up behind the first item with this key
+            slot_t& first = GetSlot(vecTable[nPos]);
+            slot.nKeyPrev = vecTable[nPos];
+            slot.nKeyNext = first.nKeyNext;
+            if(first.nKeyNext != NO_SLOT) {
+                GetSlot(first.nKeyNext).nKeyPrev = n;
+            }
+            first.nKeyNext = n;
+        } else {
+            slot.nKeyPrev = NO_SLOT;
+            slot.nKeyNext = NO_SLOT;
+            TableInsert(n, nHash);
+        }
+
+        ++nSize;
+        return n;
     }
 
-    void Erase(const K& key)
+    void RemoveItem(uint32_t n)
     {
-        map_it it = mapIndex.find(key);
-        if(it == mapIndex.end()) {
-            return;
+        slot_t& slot = GetSlot(n);
+
+        if(slot.nKeyPrev != NO_SLOT) {
+            GetSlot(slot.nKeyPrev).nKeyNext = slot.nKeyNext;
+            if(slot.nKeyNext != NO_SLOT) {
+                GetSlot(slot.nKeyNext).nKeyPrev = slot.nKeyPrev;
+            }
+        } else {
+            const size_t nPos = FindPos(slot.Item().key, slot.nHash);
+            if(slot.nKeyNext != NO_SLOT) {
+                vecTable[nPos] = slot.nKeyNext;
+                GetSlot(slot.nKeyNext).nKeyPrev = NO_SLOT;
+            } else {
+                TableErase(nPos);
+            }
         }
-        listItems.erase(it->second);
-        mapIndex.erase(it);
+
+        if(slot.nPrev != NO_SLOT) {
+            GetSlot(slot.nPrev).nNext = slot.nNext;
+        } else {
+            nHead = slot.nNext;
+        }
+        if(slot.nNext != NO_SLOT) {
+            GetSlot(slot.nNext).nPrev = slot.nPrev;
+        } else {
+            nTail = slot.nPrev;
+        }
+
+        // release whatever the item holds on to, the slot itself is reused
+        slot.Item().~item_t();
+        slot.nNext = nFree;
+        nFree = n;
+        --nSize;
     }
 
-    const list_t& GetItemList() const {
-        return listItems;
+    void PruneLast()
+    {
+        if(nTail != NO_SLOT) {
+            RemoveItem(nTail);
+        }
     }
 
-    CacheMap<K,V>& operator=(const CacheMap<K,V>& other)
+    void CopyFrom(const CacheStorage& other)
     {
+        Clear();
         nMaxSize = other.nMaxSize;
-        listItems = other.listItems;
-        RebuildIndex();
-        return *this;
+        for(uint32_t n = other.nHead; n != NO_SLOT; n = other.GetSlot(n).nNext) {
+            const item_t& item = other.GetSlot(n).Item();
+            AddItem(item.key, item.value, false);
+        }
     }
 
-    ADD_SERIALIZE_METHODS;
+    /** Collect every distinct key, in no particular order */
+    void GetDistinctKeys(std::vector<K>& vecKeys) const
+    {
+        vecKeys.reserve(vecKeys.size() + nKeys);
+        for(const uint32_t n : vecTable) {
+            if(n != NO_SLOT) {
+                vecKeys.push_back(GetSlot(n).Item().key);
+            }
+        }
+    }
 
-    template <typename Stream, typename Operation>
-    inline void SerializationOp(Stream& s, Operation ser_action)
+private:
+    void DestroyItems()
+    {
+        for(uint32_t n = nHead; n != NO_SLOT; n = GetSlot(n).nNext) {
+            GetSlot(n).Item().~item_t();
+        }
+    }
+
+    uint32_t AllocSlot()
     {
-        READWRITE(nMaxSize);
-        READWRITE(listItems);
-        if(ser_action.ForRead()) {
-            RebuildIndex();
+        if(nFree != NO_SLOT) {
+            const uint32_t n = nFree;
+            nFree = GetSlot(n).nNext;
+            return n;
         }
+        if(nSlotsUsed == vecChunks.size() * CHUNK_SIZE) {
+            vecChunks.emplace_back(new slot_t[CHUNK_SIZE]);
+        }
+        return nSlotsUsed++;
+    }
+
+    size_t FindPos(const K& key, size_t nHash) const
+    {
+        if(vecTable.empty()) {
+            return NO_POS;
+        }
+        const size_t nMask = vecTable.size() - 1;
+        for(size_t nPos = nHash & nMask; vecTable[nPos] != NO_SLOT; nPos = (nPos + 1) & nMask) {
+            const slot_t& slot = GetSlot(vecTable[nPos]);
+            if(slot.nHash == nHash && slot.Item().key == key) {
+                return nPos;
+            }
+        }
+        return NO_POS;
+    }
+
+    void TableInsert(uint32_t n, size_t nHash)
+    {
+        // keep the load factor at or below 1/2 so probe sequences stay short
+        if((nKeys + 1) * 2 > vecTable.size()) {
+            Rehash(std::max<size_t>(16, vecTable.size() * 2));
+        }
+        const size_t nMask = vecTable.size() - 1;
+        size_t nPos = nHash & nMask;
+        while(vecTable[nPos] != NO_SLOT) {
+            nPos = (nPos + 1) & nMask;
+        }
+        vecTable[nPos] = n;
+        ++nKeys;
+    }
+
+    void TableErase(size_t nPos)
+    {
+        // backward shift deletion, no tombstones needed
+        const size_t nMask = vecTable.size() - 1;
+        size_t nHole = nPos;
+        size_t nNext = nPos;
+        while(true) {
+            nNext = (nNext + 1) & nMask;
+            if(vecTable[nNext] == NO_SLOT) {
+                break;
+            }
+            const size_t nIdeal = GetSlot(vecTable[nNext]).nHash & nMask;
+            // leave the entry where it is if its ideal position lies cyclically in (nHole, nNext]
+            const bool fStays = (nHole <= nNext) ? (nHole < nIdeal && nIdeal <= nNext) : (nHole < nIdeal || nIdeal <= nNext);
+            if(fStays) {
+                continue;
+            }
+            vecTable[nHole] = vecTable[nNext];
+            nHole = nNext;
+        }
+        vecTable[nHole] = NO_SLOT;
+        --nKeys;
     }
 
+    void Rehash(size_t nNewSize)
+    {
+        std::vector<uint32_t> vecOld(nNewSize, NO_SLOT);
+        vecOld.swap(vecTable);
+        const size_t nMask = vecTable.size() - 1;
+        for(const uint32_t n : vecOld) {
+            if(n == NO_SLOT) {
+                continue;
+            }
+            size_t nPos = GetSlot(n).nHash & nMask;
+            while(vecTable[nPos] != NO_SLOT) {
+                nPos = (nPos + 1) & nMask;
+            }
+            vecTable[nPos] = n;
+        }
+    }
+};
+
+template<typename K, typename V, typename Size, typename Links>
+const uint32_t CacheStorage<K, V, Size, Links>::NO_SLOT;
+
+template<typename K, typename V, typename Size, typename Links>
+const size_t CacheStorage<K, V, Size, Links>::NO_POS;
+
+/**
+ * Map like container that keeps the N most recently added items
+ */
+template<typename K, typename V, typename Size = uint32_t>
+class CacheMap : public CacheStorage<K, V, Size>
+{
 private:
-    void PruneLast()
+    typedef CacheStorage<K, V, Size> base_t;
+
+public:
+    typedef typename base_t::size_type size_type;
+
+    typedef typename base_t::item_t item_t;
+
+    explicit CacheMap(size_type nMaxSizeIn = 0)
+        : base_t(nMaxSizeIn)
+    {}
+
+    explicit CacheMap(const CacheMap<K,V,Size>& other)
+        : base_t(other.nMaxSize)
     {
-        if(listItems.empty()) {
+        this->CopyFrom(other);
+    }
+
+    bool Insert(const K& key, const V& value)
+    {
+        if(this->HasKey(key)) {
+            return false;
+        }
+        if(this->GetSize() == this->nMaxSize) {
+            this->PruneLast();
+        }
+        this->AddItem(key, value, true);
+        return true;
+    }
+
+    bool Get(const K& key, V& value) const
+    {
+        uint32_t n = this->FindKey(key);
+        if(n == base_t::NO_SLOT) {
+            return false;
+        }
+        value = this->GetSlot(n).Item().value;
+        return true;
+    }
+
+    void Erase(const K& key)
+    {
+        uint32_t n = this->FindKey(key);
+        if(n == base_t::NO_SLOT) {
             return;
         }
-        item_t& item = listItems.back();
-        mapIndex.erase(item.key);
-        listItems.pop_back();
+        this->RemoveItem(n);
+    }
+
+    CacheMap<K,V,Size>& operator=(const CacheMap<K,V,Size>& other)
+    {
+        if(this != &other) {
+            this->CopyFrom(other);
+        }
+        return *this;
     }
 
-    void RebuildIndex()
+    template<typename Stream>
+    void Unserialize(Stream& s)
     {
-        mapIndex.clear();
-        for(list_it it = listItems.begin(); it != listItems.end(); ++it) {
-            mapIndex.emplace(it->key, it);
+        this->Clear();
+        s >> this->nMaxSize;
+        uint64_t nItems = ReadCompactSize(s);
+        for(uint64_t i = 0; i < nItems; ++i) {
+            item_t item;
+            s >> item;
+            if(!this->HasKey(item.key)) {
+                this->AddItem(item.key, item.value, false);
+            }
         }
     }
 };
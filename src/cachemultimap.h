@@ -6,242 +6,333 @@
 #ifndef SYSCOIN_CACHEMULTIMAP_H
 #define SYSCOIN_CACHEMULTIMAP_H
 
+#include <algorithm>
 #include <cstddef>
-#include <map>
-#include <list>
-#include <set>
+#include <vector>
 
 #include <serialize.h>
 
 #include <cachemap.h>
+#include <random.h>
 
 /**
- * Map like container that keeps the N most recently added items
+ * Treap links kept in every slot of a CacheMultiMap
  */
-template<typename K, typename V, typename Size = uint32_t>
-class CacheMultiMap
+struct CacheTreapLinks
 {
-public:
-    typedef Size size_type;
-
-    typedef CacheItem<K,V> item_t;
-
-    typedef std::list<item_t> list_t;
-
-    typedef typename list_t::iterator list_it;
-
-    typedef typename list_t::const_iterator list_cit;
-
-    typedef std::map<V,list_it> it_map_t;
-
-    typedef typename it_map_t::iterator it_map_it;
-
-    typedef typename it_map_t::const_iterator it_map_cit;
-
-    typedef std::map<K, it_map_t> map_t;
-
-    typedef typename map_t::iterator map_it;
-
-    typedef typename map_t::const_iterator map_cit;
+    uint32_t nLeft;
+    uint32_t nRight;
+    uint32_t nParent;
+    // only meaningful in the first slot of a key
+    uint32_t nRoot;
+    uint32_t nPriority;
+};
 
+/**
+ * Map like container that keeps the N most recently added items.
+ *
+ * The values of a key are chained in the flat storage and also linked into a treap
+ * ordered by value, whose links live in the slots themselves. Inserts, lookups and
+ * erases of a single value are logarithmic in the number of values of the key and,
+ * like the rest of the storage, cost no allocation per insert.
+ */
+template<typename K, typename V, typename Size = uint32_t>
+class CacheMultiMap : public CacheStorage<K, V, Size, CacheTreapLinks>
+{
 private:
-    size_type nMaxSize;
+    typedef CacheStorage<K, V, Size, CacheTreapLinks> base_t;
+    typedef typename base_t::slot_t slot_t;
 
-    list_t listItems;
-
-    map_t mapIndex;
+    FastRandomContext rng;
 
 public:
-    explicit CacheMultiMap(size_type nMaxSizeIn = 0)
-        : nMaxSize(nMaxSizeIn),
-          listItems(),
-          mapIndex()
-    {}
+    typedef typename base_t::size_type size_type;
 
-    explicit CacheMultiMap(const CacheMap<K,V>& other)
-        : nMaxSize(other.nMaxSize),
-          listItems(other.listItems),
-          mapIndex()
-    {
-        RebuildIndex();
-    }
+    typedef typename base_t::item_t item_t;
 
-    void Clear()
-    {
-        mapIndex.clear();
-        listItems.clear();
-    }
+    explicit CacheMultiMap(size_type nMaxSizeIn = 0)
+        : base_t(nMaxSizeIn)
+    {}
 
-    void SetMaxSize(size_type nMaxSizeIn)
+    CacheMultiMap(const CacheMultiMap<K,V,Size>& other)
+        : base_t(other.nMaxSize)
     {
-        nMaxSize = nMaxSizeIn;
-    }
-
-    size_type GetMaxSize() const {
-        return nMaxSize;
-    }
-
-    size_type GetSize() const {
-        return listItems.size();
+        CopyFrom(other);
     }
 
     bool Insert(const K& key, const V& value)
     {
-        map_it mit = mapIndex.find(key);
-        if(mit == mapIndex.end()) {
-            mit = mapIndex.emplace(key, it_map_t()).first;
-        }
-        it_map_t& mapIt = mit->second;
-
-        if(mapIt.count(value) > 0) {
+        if(!Add(key, value, true, this->HashKey(key))) {
             // Don't insert duplicates
             return false;
         }
-
-        if(listItems.size() == nMaxSize) {
-            PruneLast();
+        // the cache was full before, the new item went to the front so the tail is an older one
+        if(this->GetSize() > 1 && this->GetSize() - 1 == this->nMaxSize) {
+            Remove(this->GetTail());
         }
-        listItems.push_front(item_t(key, value));
-        mapIt.emplace(value, listItems.begin());
         return true;
     }
 
-    bool HasKey(const K& key) const
-    {
-        return (mapIndex.find(key) != mapIndex.end());
-    }
-
+    /** Get the lowest value stored for key */
     bool Get(const K& key, V& value) const
     {
-        map_cit it = mapIndex.find(key);
-        if(it == mapIndex.end()) {
+        const uint32_t nFirst = this->FindKey(key);
+        if(nFirst == base_t::NO_SLOT) {
             return false;
         }
-        const it_map_t& mapIt = it->second;
-        const item_t& item = *(mapIt.begin()->second);
-        value = item.value;
+        uint32_t n = this->GetSlot(nFirst).nRoot;
+        while(this->GetSlot(n).nLeft != base_t::NO_SLOT) {
+            n = this->GetSlot(n).nLeft;
+        }
+        value = this->GetSlot(n).Item().value;
         return true;
     }
 
+    /** Get all values stored for key, lowest first */
     bool GetAll(const K& key, std::vector<V>& vecValues)
     {
-        map_cit mit = mapIndex.find(key);
-        if(mit == mapIndex.end()) {
+        const uint32_t nFirst = this->FindKey(key);
+        if(nFirst == base_t::NO_SLOT) {
             return false;
         }
-        const it_map_t& mapIt = mit->second;
-
-        for(it_map_cit it = mapIt.begin(); it != mapIt.end(); ++it) {
-            const item_t& item = *(it->second);
-            vecValues.push_back(item.value);
+        // in order walk of the treap
+        std::vector<uint32_t> vecStack;
+        uint32_t n = this->GetSlot(nFirst).nRoot;
+        while(n != base_t::NO_SLOT || !vecStack.empty()) {
+            for(; n != base_t::NO_SLOT; n = this->GetSlot(n).nLeft) {
+                vecStack.push_back(n);
+            }
+            n = vecStack.back();
+            vecStack.pop_back();
+            vecValues.push_back(this->GetSlot(n).Item().value);
+            n = this->GetSlot(n).nRight;
         }
         return true;
     }
 
+    /** Get all distinct keys in ascending order */
     void GetKeys(std::vector<K>& vecKeys)
     {
-        for(map_cit it = mapIndex.begin(); it != mapIndex.end(); ++it) {
-            vecKeys.push_back(it->first);
-        }
+        const size_t nFirst = vecKeys.size();
+        this->GetDistinctKeys(vecKeys);
+        std::sort(vecKeys.begin() + nFirst, vecKeys.end());
     }
 
     void Erase(const K& key)
     {
-        map_it mit = mapIndex.find(key);
-        if(mit == mapIndex.end()) {
-            return;
+        // the treap goes away with the slots, links are set up again when a slot is reused
+        uint32_t n = this->FindKey(key);
+        while(n != base_t::NO_SLOT) {
+            const uint32_t nNext = this->GetSlot(n).nKeyNext;
+            this->RemoveItem(n);
+            n = nNext;
         }
-        it_map_t& mapIt = mit->second;
-
-        for(it_map_it it = mapIt.begin(); it != mapIt.end(); ++it) {
-            listItems.erase(it->second);
-        }
-
-        mapIndex.erase(mit);
     }
 
     void Erase(const K& key, const V& value)
     {
-        map_it mit = mapIndex.find(key);
-        if(mit == mapIndex.end()) {
+        uint32_t n = Find(key, value);
+        if(n == base_t::NO_SLOT) {
             return;
         }
-        it_map_t& mapIt = mit->second;
+        Remove(n);
+    }
 
-        it_map_it it = mapIt.find(value);
-        if(it == mapIt.end()) {
-            return;
+    CacheMultiMap<K,V,Size>& operator=(const CacheMultiMap<K,V,Size>& other)
+    {
+        if(this != &other) {
+            CopyFrom(other);
         }
+        return *this;
+    }
 
-        listItems.erase(it->second);
-        mapIt.erase(it);
-
-        if(mapIt.empty()) {
-            mapIndex.erase(mit);
+    template<typename Stream>
+    void Unserialize(Stream& s)
+    {
+        this->Clear();
+        s >> this->nMaxSize;
+        uint64_t nItems = ReadCompactSize(s);
+        for(uint64_t i = 0; i < nItems; ++i) {
+            item_t item;
+            s >> item;
+            Add(item.key, item.value, false, this->HashKey(item.key));
         }
     }
 
-    const list_t& GetItemList() const {
-        return listItems;
+private:
+    /** Slot holding an equivalent (neither less nor greater) value for key */
+    uint32_t Find(const K& key, const V& value) const
+    {
+        const uint32_t nFirst = this->FindKey(key);
+        return nFirst == base_t::NO_SLOT ? base_t::NO_SLOT : FindBelow(this->GetSlot(nFirst).nRoot, value);
     }
 
-    CacheMap<K,V>& operator=(const CacheMap<K,V>& other)
+    /** Slot holding an equivalent value in the treap rooted at n */
+    uint32_t FindBelow(uint32_t n, const V& value) const
     {
-        nMaxSize = other.nMaxSize;
-        listItems = other.listItems;
-        RebuildIndex();
-        return *this;
+        while(n != base_t::NO_SLOT) {
+            const slot_t& slot = this->GetSlot(n);
+            if(value < slot.Item().value) {
+                n = slot.nLeft;
+            } else if(slot.Item().value < value) {
+                n = slot.nRight;
+            } else {
+                break;
+            }
+        }
+        return n;
     }
 
-    ADD_SERIALIZE_METHODS;
-
-    template <typename Stream, typename Operation>
-    inline void SerializationOp(Stream& s, Operation ser_action)
+    /** Store a new item and link it into the treap of its key, unless an equivalent value is stored already */
+    bool Add(const K& key, const V& value, bool fFront, size_t nHash)
     {
-        READWRITE(nMaxSize);
-        READWRITE(listItems);
-        if(ser_action.ForRead()) {
-            RebuildIndex();
+        const uint32_t n = this->AddItem(key, value, fFront, nHash);
+        slot_t& slot = this->GetSlot(n);
+        slot.nLeft = base_t::NO_SLOT;
+        slot.nRight = base_t::NO_SLOT;
+        slot.nParent = base_t::NO_SLOT;
+        slot.nRoot = base_t::NO_SLOT;
+        // random priorities keep the treap balanced whatever order the values come in
+        slot.nPriority = rng.rand32();
+
+        // the first slot of the key stays put, new items are chained right behind it
+        slot_t& first = this->GetSlot(slot.nKeyPrev == base_t::NO_SLOT ? n : slot.nKeyPrev);
+        bool fDuplicate = false;
+        const uint32_t nRoot = TreapInsert(first.nRoot, n, fDuplicate);
+        if(fDuplicate) {
+            this->RemoveItem(n);
+            return false;
         }
+        first.nRoot = nRoot;
+        this->GetSlot(nRoot).nParent = base_t::NO_SLOT;
+        return true;
     }
 
-private:
-    void PruneLast()
+    void Remove(uint32_t n)
     {
-        if(listItems.empty()) {
-            return;
+        const slot_t& slot = this->GetSlot(n);
+        const uint32_t nChild = TreapErase(n);
+        if(slot.nParent == base_t::NO_SLOT) {
+            if(slot.nKeyPrev != base_t::NO_SLOT) {
+                this->GetSlot(this->FindKey(slot.Item().key, slot.nHash)).nRoot = nChild;
+            } else if(slot.nKeyNext != base_t::NO_SLOT) {
+                // RemoveItem makes the next slot of the key its first one
+                this->GetSlot(slot.nKeyNext).nRoot = nChild;
+            }
+        } else if(slot.nKeyPrev == base_t::NO_SLOT && slot.nKeyNext != base_t::NO_SLOT) {
+            this->GetSlot(slot.nKeyNext).nRoot = slot.nRoot;
         }
+        this->RemoveItem(n);
+    }
 
-        list_it lit = listItems.end();
-        --lit;
-        item_t& item = *lit;
+    void SetLeft(uint32_t n, uint32_t nChild)
+    {
+        this->GetSlot(n).nLeft = nChild;
+        if(nChild != base_t::NO_SLOT) {
+            this->GetSlot(nChild).nParent = n;
+        }
+    }
 
-        map_it mit = mapIndex.find(item.key);
+    void SetRight(uint32_t n, uint32_t nChild)
+    {
+        this->GetSlot(n).nRight = nChild;
+        if(nChild != base_t::NO_SLOT) {
+            this->GetSlot(nChild).nParent = n;
+        }
+    }
 
-        if(mit != mapIndex.end()) {
-            it_map_t& mapIt = mit->second;
+    /** Insert n into the treap rooted at nRoot and return the new root, leaves it untouched if it holds an equivalent value */
+    uint32_t TreapInsert(uint32_t nRoot, uint32_t n, bool& fDuplicate)
+    {
+        if(nRoot == base_t::NO_SLOT) {
+            return n;
+        }
+        const slot_t& root = this->GetSlot(nRoot);
+        const slot_t& slot = this->GetSlot(n);
+        if(slot.nPriority > root.nPriority) {
+            // the rest of the search path is split below n, look for the value along it first
+            if(FindBelow(nRoot, slot.Item().value) != base_t::NO_SLOT) {
+                fDuplicate = true;
+                return nRoot;
+            }
+            uint32_t nLower, nHigher;
+            TreapSplit(nRoot, slot.Item().value, nLower, nHigher);
+            SetLeft(n, nLower);
+            SetRight(n, nHigher);
+            return n;
+        }
+        if(slot.Item().value < root.Item().value) {
+            SetLeft(nRoot, TreapInsert(root.nLeft, n, fDuplicate));
+        } else if(root.Item().value < slot.Item().value) {
+            SetRight(nRoot, TreapInsert(root.nRight, n, fDuplicate));
+        } else {
+            fDuplicate = true;
+        }
+        return nRoot;
+    }
 
-            mapIt.erase(item.value);
+    /** Split into the nodes with lower values and the others */
+    void TreapSplit(uint32_t nRoot, const V& value, uint32_t& nLower, uint32_t& nHigher)
+    {
+        if(nRoot == base_t::NO_SLOT) {
+            nLower = nHigher = base_t::NO_SLOT;
+            return;
+        }
+        const slot_t& root = this->GetSlot(nRoot);
+        uint32_t nChild;
+        if(root.Item().value < value) {
+            TreapSplit(root.nRight, value, nChild, nHigher);
+            SetRight(nRoot, nChild);
+            nLower = nRoot;
+        } else {
+            TreapSplit(root.nLeft, value, nLower, nChild);
+            SetLeft(nRoot, nChild);
+            nHigher = nRoot;
+        }
+    }
 
-            if(mapIt.empty()) {
-                mapIndex.erase(item.key);
+    /** Unlink n from its treap, returns what took its place */
+    uint32_t TreapErase(uint32_t n)
+    {
+        const slot_t& slot = this->GetSlot(n);
+        const uint32_t nChild = TreapMerge(slot.nLeft, slot.nRight);
+        if(slot.nParent == base_t::NO_SLOT) {
+            if(nChild != base_t::NO_SLOT) {
+                this->GetSlot(nChild).nParent = base_t::NO_SLOT;
             }
+        } else if(this->GetSlot(slot.nParent).nLeft == n) {
+            SetLeft(slot.nParent, nChild);
+        } else {
+            SetRight(slot.nParent, nChild);
         }
+        return nChild;
+    }
 
-        listItems.pop_back();
+    /** Join two treaps, every value of the first one being lower */
+    uint32_t TreapMerge(uint32_t nLower, uint32_t nHigher)
+    {
+        if(nLower == base_t::NO_SLOT) {
+            return nHigher;
+        }
+        if(nHigher == base_t::NO_SLOT) {
+            return nLower;
+        }
+        const slot_t& lower = this->GetSlot(nLower);
+        const slot_t& higher = this->GetSlot(nHigher);
+        if(lower.nPriority > higher.nPriority) {
+            SetRight(nLower, TreapMerge(lower.nRight, nHigher));
+            return nLower;
+        }
+        SetLeft(nHigher, TreapMerge(nLower, higher.nLeft));
+        return nHigher;
     }
 
-    void RebuildIndex()
+    void CopyFrom(const CacheMultiMap<K,V,Size>& other)
     {
-        mapIndex.clear();
-        for(list_it lit = listItems.begin(); lit != listItems.end(); ++lit) {
-            item_t& item = *lit;
-            map_it mit = mapIndex.find(item.key);
-            if(mit == mapIndex.end()) {
-                mit = mapIndex.emplace(item.key, it_map_t()).first;
-            }
-            it_map_t& mapIt = mit->second;
-            mapIt.emplace(item.value, lit);
+        this->Clear();
+        this->nMaxSize = other.nMaxSize;
+        for(const item_t& item : other.GetItemList()) {
+            Add(item.key, item.value, false, this->HashKey(item.key));
         }
     }
 };
@@ -97,11 +97,20 @@ static void SetMaxOpenFiles(leveldb::Options *options) {
              options->max_open_files, default_open_files);
 }
 
-static leveldb::Options GetOptions(size_t nCacheSize)
+static leveldb::Options GetOptions(size_t nCacheSize, const CDBTuning& tuning)
 {
     leveldb::Options options;
-    options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
-    options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
+    // SYSCOIN
+    if (tuning.block_cache) {
+        options.block_cache = tuning.block_cache.get();
+        options.write_buffer_size = nCacheSize / 2; // up to two write buffers may be held in memory simultaneously
+    } else {
+        options.block_cache = leveldb::NewLRUCache(nCacheSize / 2);
+        options.write_buffer_size = nCacheSize / 4; // up to two write buffers may be held in memory simultaneously
+    }
+    if (tuning.nBlockSize > 0) {
+        options.block_size = tuning.nBlockSize;
+    }
     options.filter_policy = leveldb::NewBloomFilterPolicy(10);
     options.compression = leveldb::kNoCompression;
     options.info_log = new CSyscoinLevelDBLogger();
@@ -114,15 +123,15 @@ static leveldb::Options GetOptions(size_t nCacheSize)
     return options;
 }
 
-CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate)
-    : m_name{path.stem().string()}
+CDBWrapper::CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory, bool fWipe, bool obfuscate, const CDBTuning& tuning)
+    : m_name{path.stem().string()}, m_shared_block_cache{tuning.block_cache}
 {
     penv = nullptr;
     readoptions.verify_checksums = true;
     iteroptions.verify_checksums = true;
     iteroptions.fill_cache = false;
     syncoptions.sync = true;
-    options = GetOptions(nCacheSize);
+    options = GetOptions(nCacheSize, tuning);
     options.create_if_missing = true;
     if (fMemory) {
         penv = leveldb::NewMemEnv(leveldb::Env::Default());
@@ -174,7 +183,10 @@ CDBWrapper::~CDBWrapper()
     options.filter_policy = nullptr;
     delete options.info_log;
     options.info_log = nullptr;
-    delete options.block_cache;
+    // SYSCOIN
+    if (!m_shared_block_cache) {
+        delete options.block_cache;
+    }
     options.block_cache = nullptr;
     delete penv;
     options.env = nullptr;
@@ -206,6 +218,11 @@ size_t CDBWrapper::DynamicMemoryUsage() const {
     return stoul(memory);
 }
 
+// SYSCOIN
+bool CDBWrapper::GetProperty(const std::string& strProperty, std::string& strValue) const {
+    return pdb->GetProperty(strProperty, &strValue);
+}
+
 // Prefixed with null character to avoid collisions with other keys
 //
 // We must use a string constructor which specifies length so that we copy
@@ -214,6 +231,14 @@ const std::string CDBWrapper::OBFUSCATE_KEY_KEY("\000obfuscate_key", 14);
 
 const unsigned int CDBWrapper::OBFUSCATE_KEY_NUM_BYTES = 8;
 
+// SYSCOIN
+bool CDBWrapper::IsObfuscateKeyEntry(const std::vector<unsigned char>& vchKey) const
+{
+    CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+    ssKey << OBFUSCATE_KEY_KEY;
+    return vchKey.size() == ssKey.size() && std::equal(vchKey.begin(), vchKey.end(), ssKey.begin());
+}
+
 /**
  * Returns a string (consisting of 8 random bytes) suitable for use as an
  * obfuscating XOR key.
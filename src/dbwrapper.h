@@ -12,6 +12,8 @@
 #include <util/system.h>
 #include <util/strencodings.h>
 
+#include <memory>
+
 #include <leveldb/db.h>
 #include <leveldb/write_batch.h>
 
@@ -170,6 +172,27 @@ public:
         return piter->value().size();
     }
 
+    // SYSCOIN
+    /** Copy the serialized key and the deobfuscated serialized value of the current entry */
+    void GetRaw(std::vector<unsigned char>& vchKey, std::vector<unsigned char>& vchValue) {
+        leveldb::Slice slKey = piter->key();
+        vchKey.assign(slKey.data(), slKey.data() + slKey.size());
+        leveldb::Slice slValue = piter->value();
+        CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
+        ssValue.Xor(dbwrapper_private::GetObfuscateKey(parent));
+        vchValue.assign(ssValue.begin(), ssValue.end());
+    }
+
+};
+
+// SYSCOIN
+/** LevelDB settings a database can take over from a group of databases sharing one memory budget */
+struct CDBTuning
+{
+    //! block cache shared with other databases, nullptr for a private cache sized from nCacheSize
+    std::shared_ptr<leveldb::Cache> block_cache;
+    //! approximate size of user data packed per block, 0 keeps the LevelDB default
+    size_t nBlockSize{0};
 };
 
 class CDBWrapper
@@ -200,6 +223,10 @@ private:
     //! the name of this database
     std::string m_name;
 
+    // SYSCOIN
+    //! block cache shared with other databases, keeps it alive as long as this database
+    std::shared_ptr<leveldb::Cache> m_shared_block_cache;
+
     //! a key used for optional XOR-obfuscation of the database
     std::vector<unsigned char> obfuscate_key;
 
@@ -219,8 +246,10 @@ public:
      * @param[in] fWipe       If true, remove all existing data.
      * @param[in] obfuscate   If true, store data obfuscated via simple XOR. If false, XOR
      *                        with a zero'd byte array.
+     * @param[in] tuning      Shared block cache and block size. With a shared block cache
+     *                        nCacheSize only sizes the write buffers.
      */
-    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false);
+    CDBWrapper(const fs::path& path, size_t nCacheSize, bool fMemory = false, bool fWipe = false, bool obfuscate = false, const CDBTuning& tuning = CDBTuning());
     ~CDBWrapper();
 
     CDBWrapper(const CDBWrapper&) = delete;
@@ -309,6 +338,15 @@ public:
         return new CDBIterator(*this, pdb->NewIterator(iteroptions));
     }
 
+    // SYSCOIN
+    const std::string& GetName() const { return m_name; }
+
+    /** Read a LevelDB property such as "leveldb.stats" or "leveldb.num-files-at-level0" */
+    bool GetProperty(const std::string& strProperty, std::string& strValue) const;
+
+    /** Return true if vchKey is the serialized key of the obfuscation key entry */
+    bool IsObfuscateKeyEntry(const std::vector<unsigned char>& vchKey) const;
+
     /**
      * Return true if the database managed by this class contains no entries.
      */
@@ -10,9 +10,13 @@
 #include <clientversion.h>
 #include <hash.h>
 #include <streams.h>
+#include <util/system.h>
 
 #include <boost/filesystem.hpp>
 
+/** Read buffer used while streaming a flat database file */
+static const uint64_t FLATDB_READ_BUFFER_SIZE = 1 << 20;
+
 /** 
 *   Generic Dumping and Loading
 *   ---------------------------
@@ -43,30 +47,34 @@ private:
 
         int64_t nStart = GetTimeMillis();
 
-        // serialize, checksum data up to that point, then append checksum
-        CDataStream ssObj(SER_DISK, CLIENT_VERSION);
-        ssObj << strMagicMessage; // specific magic message for this type of object
-        ssObj << FLATDATA(Params().MessageStart()); // network specific magic number
-        ssObj << objToSave;
-        uint256 hash = Hash(ssObj.begin(), ssObj.end());
-        ssObj << hash;
+        // write to a temporary file first, so a failed dump never clobbers the previous one
+        boost::filesystem::path pathTmp = pathDB.string() + ".new";
 
         // open output file, and associate with CAutoFile
-        FILE *file = fopen(pathDB.string().c_str(), "wb");
+        FILE *file = fopen(pathTmp.string().c_str(), "wb");
         CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
         if (fileout.IsNull())
-            return error("%s: Failed to open file %s", __func__, pathDB.string());
+            return error("%s: Failed to open file %s", __func__, pathTmp.string());
 
-        // Write and commit header, data
+        // serialize straight into the file, checksum data up to that point, then append checksum
         try {
-            fileout << ssObj;
+            CHashedSourceWriter<CAutoFile> hashwriter(&fileout);
+            hashwriter << strMagicMessage; // specific magic message for this type of object
+            hashwriter << FLATDATA(Params().MessageStart()); // network specific magic number
+            hashwriter << objToSave;
+            fileout << hashwriter.GetHash();
         }
         catch (std::exception &e) {
             return error("%s: Serialize or I/O error - %s", __func__, e.what());
         }
+        if (!FileCommit(fileout.Get()))
+            return error("%s: Failed to flush file %s", __func__, pathTmp.string());
         fileout.fclose();
+        if (!RenameOver(pathTmp, pathDB))
+            return error("%s: Rename-into-place failed", __func__);
 
-        LogPrintf("Written info to %s  %dms\n", strFilename, GetTimeMillis() - nStart);
+        int64_t nTime = GetTimeMillis() - nStart;
+        LogPrintf("Written info to %s  %dms  %s\n", strFilename, nTime, FormatThroughput(boost::filesystem::file_size(pathDB), nTime));
         LogPrintf("     %s\n", objToSave.ToString());
 
         return true;
@@ -77,81 +85,96 @@ private:
         //LOCK(objToLoad.cs);
 
         int64_t nStart = GetTimeMillis();
-        // open input file, and associate with CAutoFile
+        // open input file, and associate with CBufferedFile
         FILE *file = fopen(pathDB.string().c_str(), "rb");
-        CAutoFile filein(file, SER_DISK, CLIENT_VERSION);
-        if (filein.IsNull())
+        if (!file)
         {
             error("%s: Failed to open file %s", __func__, pathDB.string());
             return FileError;
         }
+        CBufferedFile filein(file, FLATDB_READ_BUFFER_SIZE, 0, SER_DISK, CLIENT_VERSION);
 
-        // use file size to size memory buffer
-        int fileSize = boost::filesystem::file_size(pathDB);
-        int dataSize = fileSize - sizeof(uint256);
-        // Don't try to resize to a negative number if file is small
-        if (dataSize < 0)
-            dataSize = 0;
-        std::vector<unsigned char> vchData;
-        vchData.resize(dataSize);
-        uint256 hashIn;
+        // everything but the trailing checksum is hashed while it is deserialized,
+        // so the file is never held in memory as a whole
+        uint64_t nFileSize = boost::filesystem::file_size(pathDB);
+        uint64_t nDataSize = nFileSize > sizeof(uint256) ? nFileSize - sizeof(uint256) : 0;
+        CHashVerifier<CBufferedFile> verifier(&filein);
+        filein.SetLimit(nDataSize);
+
+        ReadResult readResult = Ok;
+        try {
+            // de-serialize file header (file specific magic message) and ..
+            std::string strMagicMessageTmp;
+            verifier >> strMagicMessageTmp;
+
+            // ... verify the message matches predefined one
+            if (strMagicMessage != strMagicMessageTmp)
+            {
+                readResult = IncorrectMagicMessage;
+            }
+            else
+            {
+                // de-serialize file header (network specific magic number) and ..
+                unsigned char pchMsgTmp[4];
+                verifier >> FLATDATA(pchMsgTmp);
+
+                // ... verify the network matches ours
+                if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
+                {
+                    readResult = IncorrectMagicNumber;
+                }
+                else
+                {
+                    // de-serialize data into T object
+                    verifier >> objToLoad;
+                }
+            }
+        }
+        catch (std::exception &e) {
+            error("%s: Deserialize or I/O error - %s", __func__, e.what());
+            readResult = IncorrectFormat;
+        }
 
-        // read data and checksum from file
+        // hash whatever was not consumed above, then read the checksum
+        uint256 hashIn;
         try {
-            filein.read((char *)&vchData[0], dataSize);
+            verifier.ignore(nDataSize - filein.GetPos());
+            filein.SetLimit();
             filein >> hashIn;
         }
         catch (std::exception &e) {
+            objToLoad.Clear();
             error("%s: Deserialize or I/O error - %s", __func__, e.what());
             return HashReadError;
         }
         filein.fclose();
 
-        CDataStream ssObj(vchData, SER_DISK, CLIENT_VERSION);
-
         // verify stored checksum matches input data
-        uint256 hashTmp = Hash(ssObj.begin(), ssObj.end());
-        if (hashIn != hashTmp)
+        if (hashIn != verifier.GetHash())
         {
+            objToLoad.Clear();
             error("%s: Checksum mismatch, data corrupted", __func__);
             return IncorrectHash;
         }
 
-
-        unsigned char pchMsgTmp[4];
-        std::string strMagicMessageTmp;
-        try {
-            // de-serialize file header (file specific magic message) and ..
-            ssObj >> strMagicMessageTmp;
-
-            // ... verify the message matches predefined one
-            if (strMagicMessage != strMagicMessageTmp)
-            {
-                error("%s: Invalid magic message", __func__);
-                return IncorrectMagicMessage;
-            }
-
-
-            // de-serialize file header (network specific magic number) and ..
-            ssObj >> FLATDATA(pchMsgTmp);
-
-            // ... verify the network matches ours
-            if (memcmp(pchMsgTmp, Params().MessageStart(), sizeof(pchMsgTmp)))
-            {
-                error("%s: Invalid network magic number", __func__);
-                return IncorrectMagicNumber;
-            }
-
-            // de-serialize data into T object
-            ssObj >> objToLoad;
+        if (readResult == IncorrectMagicMessage)
+        {
+            error("%s: Invalid magic message", __func__);
+            return readResult;
         }
-        catch (std::exception &e) {
+        if (readResult == IncorrectMagicNumber)
+        {
+            error("%s: Invalid network magic number", __func__);
+            return readResult;
+        }
+        if (readResult == IncorrectFormat)
+        {
             objToLoad.Clear();
-            error("%s: Deserialize or I/O error - %s", __func__, e.what());
-            return IncorrectFormat;
+            return readResult;
         }
 
-        LogPrintf("Loaded info from %s  %dms\n", strFilename, GetTimeMillis() - nStart);
+        int64_t nTime = GetTimeMillis() - nStart;
+        LogPrintf("Loaded info from %s  %dms  %s\n", strFilename, nTime, FormatThroughput(nFileSize, nTime));
         LogPrintf("     %s\n", objToLoad.ToString());
         if(!fDryRun) {
             LogPrintf("%s: Cleaning....\n", __func__);
@@ -162,6 +185,11 @@ private:
         return Ok;
     }
 
+    static std::string FormatThroughput(uint64_t nBytes, int64_t nTimeMillis)
+    {
+        return strprintf("%d bytes, %.2f MB/s", nBytes, nBytes / 1000.0 / std::max<int64_t>(nTimeMillis, 1));
+    }
+
 
 public:
     CFlatDB(std::string strFilenameIn, std::string strMagicMessageIn)
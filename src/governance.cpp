@@ -9,6 +9,7 @@
 #include <governancevalidators.h>
 #include <governancevote.h>
 #include <governanceclasses.h>
+#include <maintenance.h>
 #include <netmessagemaker.h>
 #include <masternode.h>
 #include <masternodesync.h>
@@ -73,6 +74,12 @@ int CGovernanceManager::GetVoteCount() const
     return (int)cmapVoteToObject.GetSize();
 }
 
+int CGovernanceManager::GetObjectCount() const
+{
+    LOCK(cs);
+    return (int)mapObjects.size();
+}
+
 bool CGovernanceManager::SerializeVoteForHash(const uint256& nHash, CDataStream& ss) const
 {
     LOCK(cs);
@@ -122,6 +129,57 @@ void CGovernanceManager::ProcessMessage(CNode* pfrom, const std::string& strComm
         LogPrint(BCLog::GOBJECT, "MNGOVERNANCESYNC -- syncing governance objects to our peer at %s\n", pfrom->addr.ToString());
     }
 
+    // SYSCOIN A PEER SENT A SKETCH OF ITS VOTES FOR AN OBJECT
+    else if (strCommand == NetMsgType::MNGOVERNANCERECON)
+    {
+        if(pfrom->nVersion < GOVERNANCE_RECON_PROTO_VERSION) {
+            LogPrint(BCLog::GOBJECT, "MNGOVERNANCERECON -- peer=%d using obsolete version %i\n", pfrom->GetId(), pfrom->nVersion);
+            return;
+        }
+
+        if (!masternodeSync.IsSynced()) return;
+
+        uint256 nProp;
+        uint32_t nTheirCount;
+        CVoteSketch sketch;
+        vRecv >> nProp >> nTheirCount >> sketch;
+
+        if(sketch.GetSize() > CVoteSketch::GetCellCount(GOVERNANCE_RECON_MAX_DIFF)) {
+            LOCK(cs_main);
+            Misbehaving(pfrom->GetId(), 20, strprintf("govrecon sketch of %u cells", sketch.GetSize()));
+            return;
+        }
+
+        // decoding costs a pass over all votes of the object, don't let a peer keep us busy with it
+        if(!ConsumeReconBudget(pfrom->GetId(), GetTime())) {
+            LogPrint(BCLog::GOBJECT, "MNGOVERNANCERECON -- too many sketches, ignoring %s, peer=%d\n", nProp.ToString(), pfrom->GetId());
+            return;
+        }
+
+        SyncSingleObjVotesFromSketch(pfrom, nProp, nTheirCount, sketch, connman);
+    }
+
+    // SYSCOIN OUR SKETCH WAS TOO SMALL FOR THE PEER TO FIND THE VOTES WE ARE MISSING
+    else if (strCommand == NetMsgType::MNGOVERNANCERECONFAIL)
+    {
+        uint256 nProp;
+        uint32_t nTheirCount;
+        vRecv >> nProp >> nTheirCount;
+
+        LOCK(cs);
+        auto it = mapReconRequests.find(std::make_pair(pfrom->GetId(), nProp));
+        if(it == mapReconRequests.end()) {
+            LogPrint(BCLog::GOBJECT, "MNGOVERNANCERECONFAIL -- no sketch sent for %s, peer=%d\n", nProp.ToString(), pfrom->GetId());
+            return;
+        }
+        const uint32_t nDiff = GetNextReconDiff(it->second.nDiff, it->second.nVoteCount, nTheirCount);
+        mapReconRequests.erase(it);
+        LogPrint(BCLog::GOBJECT, "MNGOVERNANCERECONFAIL -- hash %s their votes %u, retrying for %u differences, peer=%d\n", nProp.ToString(), nTheirCount, nDiff, pfrom->GetId());
+        if(nDiff > GOVERNANCE_RECON_MAX_DIFF || !RequestGovernanceObjectWithSketch(pfrom, nProp, nDiff, connman)) {
+            RequestGovernanceObjectWithFilter(pfrom, nProp, connman, true);
+        }
+    }
+
     // A NEW GOVERNANCE OBJECT HAS ARRIVED
     else if (strCommand == NetMsgType::MNGOVERNANCEOBJECT)
     {
@@ -370,101 +428,130 @@ void CGovernanceManager::UpdateCachesAndClean()
 
     std::vector<uint256> vecDirtyHashes = mnodeman.GetAndClearDirtyGovernanceObjectHashes();
 
-    LOCK2(cs_main, cs);
+    {
+        LOCK2(cs_main, cs);
 
-    for(size_t i = 0; i < vecDirtyHashes.size(); ++i) {
-        object_m_it it = mapObjects.find(vecDirtyHashes[i]);
-        if(it == mapObjects.end()) {
-            continue;
+        for(size_t i = 0; i < vecDirtyHashes.size(); ++i) {
+            object_m_it it = mapObjects.find(vecDirtyHashes[i]);
+            if(it == mapObjects.end()) {
+                continue;
+            }
+            it->second.ClearMasternodeVotes();
+            it->second.fDirtyCache = true;
         }
-        it->second.ClearMasternodeVotes();
-        it->second.fDirtyCache = true;
-    }
 
-    ScopedLockBool guard(cs, fRateChecksEnabled, false);
+        ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
-    // Clean up any expired or invalid triggers
-    triggerman.CleanAndRemove();
+        // Clean up any expired or invalid triggers
+        triggerman.CleanAndRemove();
+
+        // SYSCOIN forget the sketches peers answered or ignored
+        const int64_t nTime = GetTime();
+        for(auto it = mapReconRequests.begin(); it != mapReconRequests.end(); ) {
+            if(it->second.nExpiry < nTime) {
+                it = mapReconRequests.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
 
-    object_m_it it = mapObjects.begin();
     int64_t nNow = GetAdjustedTime();
 
-    while(it != mapObjects.end())
-    {
-        CGovernanceObject* pObj = &((*it).second);
+    // walk the objects in slices so cs_main is released between them
+    uint256 nHashNext;
+    bool fFirst = true;
+    bool fDone = false;
+    while (!fDone) {
+        LOCK2(cs_main, cs);
+        CMaintenanceSliceTimer slice("governance");
+        ScopedLockBool guard(cs, fRateChecksEnabled, false);
 
-        if(!pObj) {
-            ++it;
-            continue;
-        }
+        object_m_it it = fFirst ? mapObjects.begin() : mapObjects.lower_bound(nHashNext);
+        fFirst = false;
 
-        uint256 nHash = it->first;
-        std::string strHash = nHash.ToString();
+        for(; it != mapObjects.end() && slice.nItems < MAINTENANCE_SLICE_SIZE; ++slice.nItems)
+        {
+            CGovernanceObject* pObj = &((*it).second);
+
+            if(!pObj) {
+                ++it;
+                continue;
+            }
 
-        // IF CACHE IS NOT DIRTY, WHY DO THIS?
-        if(pObj->IsSetDirtyCache()) {
-            // UPDATE LOCAL VALIDITY AGAINST CRYPTO DATA
-            pObj->UpdateLocalValidity();
+            uint256 nHash = it->first;
+            std::string strHash = nHash.ToString();
 
-            // UPDATE SENTINEL SIGNALING VARIABLES
-            pObj->UpdateSentinelVariables();
-        }
+            // IF CACHE IS NOT DIRTY, WHY DO THIS?
+            if(pObj->IsSetDirtyCache()) {
+                // UPDATE LOCAL VALIDITY AGAINST CRYPTO DATA
+                pObj->UpdateLocalValidity();
 
-        // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
+                // UPDATE SENTINEL SIGNALING VARIABLES
+                pObj->UpdateSentinelVariables();
+            }
 
-        int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
+            // IF DELETE=TRUE, THEN CLEAN THE MESS UP!
 
-        LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
-                 strHash, pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
+            int64_t nTimeSinceDeletion = nNow - pObj->GetDeletionTime();
 
-        if((pObj->IsSetCachedDelete() || pObj->IsSetExpired()) &&
-           (nTimeSinceDeletion >= GOVERNANCE_DELETION_DELAY)) {
-            LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- erase obj %s\n", (*it).first.ToString());
-            mnodeman.RemoveGovernanceObject(pObj->GetHash());
+            LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- Checking object for deletion: %s, deletion time = %d, time since deletion = %d, delete flag = %d, expired flag = %d\n",
+                     strHash, pObj->GetDeletionTime(), nTimeSinceDeletion, pObj->IsSetCachedDelete(), pObj->IsSetExpired());
 
-            // Remove vote references
-            const object_ref_cm_t::list_t& listItems = cmapVoteToObject.GetItemList();
-            object_ref_cm_t::list_cit lit = listItems.begin();
-            while(lit != listItems.end()) {
-                if(lit->value == pObj) {
-                    uint256 nKey = lit->key;
-                    ++lit;
-                    cmapVoteToObject.Erase(nKey);
-                }
-                else {
-                    ++lit;
+            if((pObj->IsSetCachedDelete() || pObj->IsSetExpired()) &&
+               (nTimeSinceDeletion >= GOVERNANCE_DELETION_DELAY)) {
+                LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- erase obj %s\n", (*it).first.ToString());
+                mnodeman.RemoveGovernanceObject(pObj->GetHash());
+
+                // Remove vote references
+                hash_s_m_t::iterator vit = mapObjectVotes.find(nHash);
+                if(vit != mapObjectVotes.end()) {
+                    for(const uint256& nHashVote : vit->second) {
+                        CGovernanceObject* pVoteObj = nullptr;
+                        if(cmapVoteToObject.Get(nHashVote, pVoteObj) && pVoteObj == pObj) {
+                            cmapVoteToObject.Erase(nHashVote);
+                        }
+                    }
+                    mapObjectVotes.erase(vit);
                 }
-            }
 
-            int64_t nTimeExpired{0};
+                int64_t nTimeExpired{0};
 
-            if(pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                // keep hashes of deleted proposals forever
-                nTimeExpired = std::numeric_limits<int64_t>::max();
-            } else {
-                int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
-                nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
-            }
+                if(pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+                    // keep hashes of deleted proposals forever
+                    nTimeExpired = std::numeric_limits<int64_t>::max();
+                } else {
+                    int64_t nSuperblockCycleSeconds = Params().GetConsensus().nSuperblockCycle * Params().GetConsensus().nPowTargetSpacing;
+                    nTimeExpired = pObj->GetCreationTime() + 2 * nSuperblockCycleSeconds + GOVERNANCE_DELETION_DELAY;
+                }
 
-            mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
-            mapObjects.erase(it++);
-        } else {
-            // NOTE: triggers are handled via triggerman
-            // DO NOT USE THIS UNTIL MAY, 2018 on mainnet
-            if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
-                CProposalValidator validator(pObj->GetDataAsHexString());
-                if (!validator.Validate()) {
-                    LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- set for deletion expired obj %s\n", (*it).first.ToString());
-                    pObj->fCachedDelete = true;
-                    if (pObj->nDeletionTime == 0) {
-                        pObj->nDeletionTime = nNow;
+                mapErasedGovernanceObjects.insert(std::make_pair(nHash, nTimeExpired));
+                mapObjects.erase(it++);
+            } else {
+                // NOTE: triggers are handled via triggerman
+                // DO NOT USE THIS UNTIL MAY, 2018 on mainnet
+                if (pObj->GetObjectType() == GOVERNANCE_OBJECT_PROPOSAL) {
+                    CProposalValidator validator(pObj->GetDataAsHexString());
+                    if (!validator.Validate()) {
+                        LogPrint(BCLog::GOBJECT, "CGovernanceManager::UpdateCachesAndClean -- set for deletion expired obj %s\n", (*it).first.ToString());
+                        pObj->fCachedDelete = true;
+                        if (pObj->nDeletionTime == 0) {
+                            pObj->nDeletionTime = nNow;
+                        }
                     }
                 }
+                ++it;
             }
-            ++it;
+        }
+        if (it == mapObjects.end()) {
+            fDone = true;
+        } else {
+            nHashNext = it->first;
         }
     }
 
+    LOCK(cs);
+
     // forget about expired deleted objects
     hash_time_m_it s_it = mapErasedGovernanceObjects.begin();
     while(s_it != mapErasedGovernanceObjects.end()) {
@@ -589,7 +676,8 @@ void CGovernanceManager::DoMaintenance(CConnman& connman)
 bool CGovernanceManager::ConfirmInventoryRequest(const CInv& inv)
 {
     // do not request objects until it's time to sync
-    if(!masternodeSync.IsWinnersListSynced()) return false;
+    // SYSCOIN objects and votes only need the masternode list, they are fetched while the winners list syncs
+    if(!masternodeSync.IsMasternodeListSynced()) return false;
 
     LOCK(cs);
 
@@ -646,13 +734,12 @@ void CGovernanceManager::SyncSingleObjAndItsVotes(CNode* pnode, const uint256& n
     // do not provide any data until our node is synced
     if(!masternodeSync.IsSynced()) return;
 
-    int nVoteCount = 0;
-
     // SYNC GOVERNANCE OBJECTS WITH OTHER CLIENT
 
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- syncing single object to peer=%d, nProp = %s\n", __func__, pnode->GetId(), nProp.ToString());
 
-    LOCK2(cs_main, cs);
+    // SYSCOIN votes are checked against the masternode list, not the chain
+    LOCK(cs);
 
     // single valid object and its valid votes
     object_m_it it = mapObjects.find(nProp);
@@ -673,20 +760,84 @@ void CGovernanceManager::SyncSingleObjAndItsVotes(CNode* pnode, const uint256& n
 
     // Push the govobj inventory message over to the other client
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- syncing govobj: %s, peer=%d\n", __func__, strHash, pnode->GetId());
-    pnode->PushInventory(CInv(MSG_GOVERNANCE_OBJECT, it->first));
+    std::vector<uint256> vecVoteHashes;
+
+    // only votes not yet validated against the current masternode list need their signature checked
+    govobj.GetVoteFile().ForEachValidVote(mnodeman.GetListEpoch(),
+        [](const CGovernanceVote& vote) { return vote.IsValid(true); },
+        [&](const uint256& nVoteHash) {
+            if(!filter.contains(nVoteHash)) {
+                vecVoteHashes.push_back(nVoteHash);
+            }
+        });
 
-    auto fileVotes = govobj.GetVoteFile();
+    PushObjectAndVoteInvs(pnode, it->first, vecVoteHashes, connman);
+}
 
-    for (const auto& vote : fileVotes.GetVotes()) {
-        uint256 nVoteHash = vote.GetHash();
-        if(filter.contains(nVoteHash) || !vote.IsValid(true)) {
-            continue;
+void CGovernanceManager::SyncSingleObjVotesFromSketch(CNode* pnode, const uint256& nProp, uint32_t nTheirCount, const CVoteSketch& sketch, CConnman& connman)
+{
+    // do not provide any data until our node is synced
+    if(!masternodeSync.IsSynced()) return;
+
+    LOCK(cs);
+
+    object_m_it it = mapObjects.find(nProp);
+    if(it == mapObjects.end()) {
+        LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- no matching object for hash %s, peer=%d\n", __func__, nProp.ToString(), pnode->GetId());
+        return;
+    }
+    CGovernanceObject& govobj = it->second;
+
+    if(govobj.IsSetCachedDelete() || govobj.IsSetExpired()) {
+        LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- not syncing deleted/expired govobj: %s, peer=%d\n", __func__,
+                  nProp.ToString(), pnode->GetId());
+        return;
+    }
+
+    std::vector<uint256> vecValidHashes;
+    CVoteSketch diff(sketch.GetSize(), sketch.GetSalt());
+    govobj.GetVoteFile().ForEachValidVote(mnodeman.GetListEpoch(),
+        [](const CGovernanceVote& vote) { return vote.IsValid(true); },
+        [&](const uint256& nVoteHash) {
+            vecValidHashes.push_back(nVoteHash);
+            diff.Add(nVoteHash);
+        });
+
+    std::vector<uint64_t> vecOurs, vecTheirs;
+    if(!diff.Subtract(sketch) || !diff.Decode(vecOurs, vecTheirs)) {
+        LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- could not decode sketch of %u cells for %s (%u votes, we have %u), peer=%d\n", __func__,
+                  sketch.GetSize(), nProp.ToString(), nTheirCount, vecValidHashes.size(), pnode->GetId());
+        CNetMsgMaker msgMaker(pnode->GetSendVersion());
+        connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MNGOVERNANCERECONFAIL, nProp, (uint32_t)vecValidHashes.size()));
+        return;
+    }
+
+    // the peer has the votes only it added already, send the ones only we added
+    const std::set<uint64_t> setMissing(vecOurs.begin(), vecOurs.end());
+    std::vector<uint256> vecVoteHashes;
+    vecVoteHashes.reserve(setMissing.size());
+    for(const uint256& nVoteHash : vecValidHashes) {
+        if(setMissing.count(diff.GetShortId(nVoteHash))) {
+            vecVoteHashes.push_back(nVoteHash);
         }
+    }
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- decoded %u missing and %u extra votes for %s, peer=%d\n", __func__,
+              vecOurs.size(), vecTheirs.size(), nProp.ToString(), pnode->GetId());
+
+    PushObjectAndVoteInvs(pnode, nProp, vecVoteHashes, connman);
+}
+
+void CGovernanceManager::PushObjectAndVoteInvs(CNode* pnode, const uint256& nProp, const std::vector<uint256>& vecVoteHashes, CConnman& connman)
+{
+    // SYSCOIN queued in order, so the peer learns of the object before its votes and doesn't take them
+    // for orphans. Items the peer already knows are dropped by the inventory filter.
+    pnode->PushInventory(CInv(MSG_GOVERNANCE_OBJECT, nProp));
+    for(const uint256& nVoteHash : vecVoteHashes) {
         pnode->PushInventory(CInv(MSG_GOVERNANCE_OBJECT_VOTE, nVoteHash));
-        ++nVoteCount;
     }
 
     CNetMsgMaker msgMaker(pnode->GetSendVersion());
+    const int nVoteCount = vecVoteHashes.size();
     connman.PushMessage(pnode, msgMaker.Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_GOVOBJ, 1));
     connman.PushMessage(pnode, msgMaker.Make(NetMsgType::SYNCSTATUSCOUNT, MASTERNODE_SYNC_GOVOBJ_VOTE, nVoteCount));
     LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- sent 1 object and %d votes to peer=%d\n", __func__, nVoteCount, pnode->GetId());
@@ -887,6 +1038,9 @@ bool CGovernanceManager::ProcessVote(CNode* pfrom, const CGovernanceVote& vote,
     }
 
     bool fOk = govobj.ProcessVote(pfrom, vote, exception, connman) && cmapVoteToObject.Insert(nHashVote, &govobj);
+    if(fOk) {
+        mapObjectVotes[nHashGovobj].insert(nHashVote);
+    }
     LEAVE_CRITICAL_SECTION(cs);
     return fOk;
 }
@@ -1013,6 +1167,66 @@ void CGovernanceManager::RequestGovernanceObject(CNode* pfrom, const uint256& nH
 
     LogPrint(BCLog::GOBJECT, "CGovernanceObject::RequestGovernanceObject -- hash = %s (peer=%d)\n", nHash.ToString(), pfrom->GetId());
 
+    // SYSCOIN peers that know the object's votes can find the ones we miss from a sketch of ours,
+    // its size only depends on how many votes differ instead of how many there are
+    if(fUseFilter && pfrom->nVersion >= GOVERNANCE_RECON_PROTO_VERSION &&
+        RequestGovernanceObjectWithSketch(pfrom, nHash, GOVERNANCE_RECON_INITIAL_DIFF, connman)) {
+        return;
+    }
+
+    RequestGovernanceObjectWithFilter(pfrom, nHash, connman, fUseFilter);
+}
+
+void CGovernanceManager::RemoveReconRequests(NodeId nodeid)
+{
+    LOCK(cs);
+    auto it = mapReconRequests.lower_bound(std::make_pair(nodeid, uint256()));
+    while(it != mapReconRequests.end() && it->first.first == nodeid) {
+        it = mapReconRequests.erase(it);
+    }
+    mapReconBudgets.erase(nodeid);
+}
+
+bool CGovernanceManager::ConsumeReconBudget(NodeId nodeid, int64_t nNow)
+{
+    LOCK(cs);
+    auto it = mapReconBudgets.emplace(nodeid, ReconBudget{GOVERNANCE_RECON_MAX_BURST, nNow}).first;
+    ReconBudget& budget = it->second;
+    if(nNow > budget.nTime) {
+        budget.nSketches = std::min(GOVERNANCE_RECON_MAX_BURST, budget.nSketches + (nNow - budget.nTime) * GOVERNANCE_RECON_RATE);
+        budget.nTime = nNow;
+    }
+    if(budget.nSketches == 0) {
+        return false;
+    }
+    budget.nSketches--;
+    return true;
+}
+
+bool CGovernanceManager::RequestGovernanceObjectWithSketch(CNode* pfrom, const uint256& nHash, uint32_t nDiff, CConnman& connman)
+{
+    LOCK(cs);
+    CGovernanceObject* pObj = FindGovernanceObject(nHash);
+    if(!pObj) {
+        return false;
+    }
+
+    CVoteSketch sketch(CVoteSketch::GetCellCount(nDiff), GetRand(std::numeric_limits<uint64_t>::max()));
+    const std::vector<uint256> vecVoteHashes = pObj->GetVoteFile().GetVoteHashes();
+    for(const uint256& nVoteHash : vecVoteHashes) {
+        sketch.Add(nVoteHash);
+    }
+    const uint32_t nVoteCount = vecVoteHashes.size();
+    mapReconRequests[std::make_pair(pfrom->GetId(), nHash)] = ReconRequest{nDiff, nVoteCount, GetTime() + RELIABLE_PROPAGATION_TIME};
+
+    LogPrint(BCLog::GOBJECT, "CGovernanceManager::%s -- nHash %s nVoteCount %u nDiff %u cells %u peer=%d\n", __func__, nHash.ToString(), nVoteCount, nDiff, sketch.GetSize(), pfrom->GetId());
+    CNetMsgMaker msgMaker(pfrom->GetSendVersion());
+    connman.PushMessage(pfrom, msgMaker.Make(NetMsgType::MNGOVERNANCERECON, nHash, nVoteCount, sketch));
+    return true;
+}
+
+void CGovernanceManager::RequestGovernanceObjectWithFilter(CNode* pfrom, const uint256& nHash, CConnman& connman, bool fUseFilter)
+{
     CNetMsgMaker msgMaker(pfrom->GetSendVersion());
 
     if(pfrom->nVersion < GOVERNANCE_FILTER_PROTO_VERSION) {
@@ -1185,11 +1399,14 @@ void CGovernanceManager::RebuildIndexes()
     LOCK(cs);
 
     cmapVoteToObject.Clear();
+    mapObjectVotes.clear();
     for (auto& objPair : mapObjects) {
         CGovernanceObject& govobj = objPair.second;
         std::vector<CGovernanceVote> vecVotes = govobj.GetVoteFile().GetVotes();
         for(size_t i = 0; i < vecVotes.size(); ++i) {
-            cmapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj);
+            if(cmapVoteToObject.Insert(vecVotes[i].GetHash(), &govobj)) {
+                mapObjectVotes[objPair.first].insert(vecVotes[i].GetHash());
+            }
         }
     }
 }
@@ -14,6 +14,7 @@
 #include <chain.h>
 #include <governanceexceptions.h>
 #include <governanceobject.h>
+#include <governancerecon.h>
 #include <governancevote.h>
 #include <net.h>
 #include <sync.h>
@@ -205,6 +206,8 @@ public: // Types
 
     typedef hash_s_t::const_iterator hash_s_cit;
 
+    typedef std::map<uint256, hash_s_t> hash_s_m_t;
+
     typedef std::map<uint256, object_info_pair_t> object_info_m_t;
 
     typedef object_info_m_t::iterator object_info_m_it;
@@ -246,6 +249,10 @@ private:
 
     object_ref_cm_t cmapVoteToObject;
 
+    // vote hashes inserted into cmapVoteToObject per parent object hash, so deleting an object
+    // does not scan the whole cache. Votes the cache evicted since are left here until then.
+    hash_s_m_t mapObjectVotes;
+
     vote_cm_t cmapInvalidVotes;
 
     vote_cmm_t cmmapOrphanVotes;
@@ -256,6 +263,21 @@ private:
 
     hash_s_t setRequestedVotes;
 
+    // SYSCOIN sketches sent for an object, kept to size the next one if the peer fails to decode it
+    struct ReconRequest {
+        uint32_t nDiff;
+        uint32_t nVoteCount;
+        int64_t nExpiry;
+    };
+    std::map<std::pair<NodeId, uint256>, ReconRequest> mapReconRequests;
+
+    // SYSCOIN sketches each peer may still have us decode, see ConsumeReconBudget
+    struct ReconBudget {
+        int64_t nSketches;
+        int64_t nTime;
+    };
+    std::map<NodeId, ReconBudget> mapReconBudgets;
+
     bool fRateChecksEnabled;
 
     class ScopedLockBool
@@ -293,6 +315,8 @@ public:
     bool ConfirmInventoryRequest(const CInv& inv);
 
     void SyncSingleObjAndItsVotes(CNode* pnode, const uint256& nProp, const CBloomFilter& filter, CConnman& connman);
+    /** Announce the votes of nProp missing from the peer's sketch, or tell it the sketch was too small */
+    void SyncSingleObjVotesFromSketch(CNode* pnode, const uint256& nProp, uint32_t nTheirCount, const CVoteSketch& sketch, CConnman& connman);
     void SyncAll(CNode* pnode, CConnman& connman) const;
 
     void ProcessMessage(CNode* pfrom, const std::string& strCommand, CDataStream& vRecv, CConnman& connman);
@@ -312,6 +336,9 @@ public:
 
     void CheckAndRemove() {UpdateCachesAndClean();}
 
+    /** Forget the sketches sent to and decoded for a peer that disconnected */
+    void RemoveReconRequests(NodeId nodeid);
+
     void Clear()
     {
         LOCK(cs);
@@ -320,9 +347,12 @@ public:
         mapObjects.clear();
         mapErasedGovernanceObjects.clear();
         cmapVoteToObject.Clear();
+        mapObjectVotes.clear();
         cmapInvalidVotes.Clear();
         cmmapOrphanVotes.Clear();
         mapLastMasternodeObject.clear();
+        mapReconRequests.clear();
+        mapReconBudgets.clear();
     }
 
     std::string ToString() const;
@@ -366,6 +396,8 @@ public:
 
     int GetVoteCount() const;
 
+    int GetObjectCount() const;
+
     bool SerializeObjectForHash(const uint256& nHash, CDataStream& ss) const;
 
     bool SerializeVoteForHash(const uint256& nHash, CDataStream& ss) const;
@@ -413,6 +445,21 @@ public:
 private:
     void RequestGovernanceObject(CNode* pfrom, const uint256& nHash, CConnman& connman, bool fUseFilter = false);
 
+    /** Send a bloom filter of our votes for nHash (if fUseFilter), or an empty one to get all of them */
+    void RequestGovernanceObjectWithFilter(CNode* pfrom, const uint256& nHash, CConnman& connman, bool fUseFilter);
+
+    /** Send a sketch of our votes for nHash sized for nDiff differences, false if we don't have the object */
+    bool RequestGovernanceObjectWithSketch(CNode* pfrom, const uint256& nHash, uint32_t nDiff, CConnman& connman);
+
+    /**
+     * Take one sketch off the peer's budget, false if it is used up. The budget starts at
+     * GOVERNANCE_RECON_MAX_BURST and regains GOVERNANCE_RECON_RATE sketches per second.
+     */
+    bool ConsumeReconBudget(NodeId nodeid, int64_t nNow);
+
+    /** Announce the object and the given votes in bounded INV messages, followed by the sync counts */
+    void PushObjectAndVoteInvs(CNode* pnode, const uint256& nProp, const std::vector<uint256>& vecVoteHashes, CConnman& connman);
+
     void AddInvalidVote(const CGovernanceVote& vote)
     {
         cmapInvalidVotes.Insert(vote.GetHash(), vote);
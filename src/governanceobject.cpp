@@ -177,6 +177,8 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     }
 
     // Finally check that the vote is actually valid (done last because of cost of signature verification)
+    // SYSCOIN the epoch is read first so a masternode list change during the check invalidates it
+    const uint64_t nListEpoch = mnodeman.GetListEpoch();
     if(!vote.IsValid(true)) {
         std::ostringstream ostr;
         ostr << "CGovernanceObject::ProcessVote -- Invalid vote"
@@ -200,7 +202,7 @@ bool CGovernanceObject::ProcessVote(CNode* pfrom,
     }
 
     voteInstanceRef = vote_instance_t(vote.GetOutcome(), nVoteTimeUpdate, vote.GetTimestamp());
-    fileVotes.AddVote(vote);
+    fileVotes.AddVote(vote, nListEpoch);
     fDirtyCache = true;
     return true;
 }
@@ -0,0 +1,116 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <governancerecon.h>
+
+#include <crypto/siphash.h>
+
+#include <algorithm>
+
+CVoteSketch::CVoteSketch(uint32_t nCells, uint64_t nSaltIn) : nSalt(nSaltIn)
+{
+    // every sub-table gets the same number of cells
+    nCells = std::max<uint32_t>(nCells, HASH_COUNT);
+    vecCells.resize(nCells - nCells % HASH_COUNT);
+}
+
+uint32_t CVoteSketch::GetCellCount(uint32_t nDiff)
+{
+    // peeling needs about 1.3 cells per difference with four hashes, small sketches need some slack
+    const uint32_t nCells = nDiff + (nDiff + 1) / 2 + 6 * HASH_COUNT;
+    return nCells + (HASH_COUNT - nCells % HASH_COUNT) % HASH_COUNT;
+}
+
+uint64_t CVoteSketch::GetShortId(const uint256& nHash) const
+{
+    return SipHashUint256(nSalt, 0, nHash);
+}
+
+uint32_t CVoteSketch::GetCheckSum(uint64_t nShortId) const
+{
+    return (uint32_t)CSipHasher(nSalt, HASH_COUNT + 1).Write(nShortId).Finalize();
+}
+
+size_t CVoteSketch::GetCellIndex(uint64_t nShortId, int nHash) const
+{
+    const size_t nSubSize = vecCells.size() / HASH_COUNT;
+    return nHash * nSubSize + CSipHasher(nSalt, nHash + 1).Write(nShortId).Finalize() % nSubSize;
+}
+
+bool CVoteSketch::IsPure(const Cell& cell) const
+{
+    return (cell.nCount == 1 || cell.nCount == -1) && cell.nCheckSum == GetCheckSum(cell.nIdSum);
+}
+
+void CVoteSketch::Toggle(uint64_t nShortId, int32_t nDelta)
+{
+    const uint32_t nCheckSum = GetCheckSum(nShortId);
+    for (int i = 0; i < HASH_COUNT; i++) {
+        Cell& cell = vecCells[GetCellIndex(nShortId, i)];
+        cell.nCount += nDelta;
+        cell.nIdSum ^= nShortId;
+        cell.nCheckSum ^= nCheckSum;
+    }
+}
+
+bool CVoteSketch::Subtract(const CVoteSketch& other)
+{
+    if (other.nSalt != nSalt || other.vecCells.size() != vecCells.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < vecCells.size(); i++) {
+        vecCells[i].nCount -= other.vecCells[i].nCount;
+        vecCells[i].nIdSum ^= other.vecCells[i].nIdSum;
+        vecCells[i].nCheckSum ^= other.vecCells[i].nCheckSum;
+    }
+    return true;
+}
+
+bool CVoteSketch::Decode(std::vector<uint64_t>& vecOurs, std::vector<uint64_t>& vecTheirs) const
+{
+    vecOurs.clear();
+    vecTheirs.clear();
+    if (vecCells.empty()) {
+        return true;
+    }
+    CVoteSketch peel(*this);
+    // a cell holding a single short id can be peeled, which only changes the cells that id was added to.
+    // Those are the only ones to look at again, so every cell is checked once up front and then only when touched.
+    std::vector<size_t> vecQueue;
+    for (size_t i = 0; i < peel.vecCells.size(); i++) {
+        if (IsPure(peel.vecCells[i])) {
+            vecQueue.push_back(i);
+        }
+    }
+    while (!vecQueue.empty()) {
+        const Cell& cell = peel.vecCells[vecQueue.back()];
+        vecQueue.pop_back();
+        // peeled already through another cell of the same id
+        if (!IsPure(cell)) {
+            continue;
+        }
+        const int32_t nCount = cell.nCount;
+        const uint64_t nShortId = cell.nIdSum;
+        (nCount == 1 ? vecOurs : vecTheirs).push_back(nShortId);
+        // no more ids than cells can be recovered, which also stops a crafted sketch from looping
+        if (vecOurs.size() + vecTheirs.size() > vecCells.size()) {
+            return false;
+        }
+        peel.Toggle(nShortId, -nCount);
+        for (int i = 0; i < HASH_COUNT; i++) {
+            const size_t nIndex = peel.GetCellIndex(nShortId, i);
+            if (IsPure(peel.vecCells[nIndex])) {
+                vecQueue.push_back(nIndex);
+            }
+        }
+    }
+    return std::all_of(peel.vecCells.begin(), peel.vecCells.end(), [](const Cell& cell) { return cell.IsEmpty(); });
+}
+
+uint32_t GetNextReconDiff(uint32_t nPrevDiff, uint32_t nOurCount, uint32_t nTheirCount)
+{
+    // at least as many differences as the vote counts are apart, and at least twice as many as before
+    const uint32_t nCountDiff = nOurCount > nTheirCount ? nOurCount - nTheirCount : nTheirCount - nOurCount;
+    return std::max(2 * nPrevDiff, nPrevDiff + nCountDiff);
+}
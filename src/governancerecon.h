@@ -0,0 +1,89 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_GOVERNANCERECON_H
+#define SYSCOIN_GOVERNANCERECON_H
+
+#include <serialize.h>
+#include <uint256.h>
+
+#include <vector>
+
+/** Differences the first sketch for an object is sized for, nothing is known about the peer yet */
+static const uint32_t GOVERNANCE_RECON_INITIAL_DIFF = 16;
+/** Sketches are never sized for more differences, beyond that the bloom filter sync is used */
+static const uint32_t GOVERNANCE_RECON_MAX_DIFF = 4096;
+/** Sketches a peer may have us decode in a row, enough for one per object while it syncs */
+static const int64_t GOVERNANCE_RECON_MAX_BURST = 256;
+/** Sketches a peer may have us decode per second once its burst is used up */
+static const int64_t GOVERNANCE_RECON_RATE = 4;
+
+/**
+ * Invertible bloom lookup table over the vote hashes of a governance object. Votes are added as
+ * salted 64 bit short ids, each of them to one cell of every one of HASH_COUNT sub-tables. Subtracting
+ * the sketch of a peer from ours leaves only the votes one side has and the other hasn't, which can be
+ * peeled out again as long as the sketch has enough cells for that many differences. The size of a
+ * sketch only depends on the differences it is meant to recover, not on the number of votes.
+ */
+class CVoteSketch
+{
+public:
+    static const int HASH_COUNT = 4;
+
+    struct Cell
+    {
+        int32_t nCount;
+        uint64_t nIdSum;
+        uint32_t nCheckSum;
+
+        Cell() : nCount(0), nIdSum(0), nCheckSum(0) {}
+
+        bool IsEmpty() const { return nCount == 0 && nIdSum == 0 && nCheckSum == 0; }
+
+        SERIALIZE_METHODS(Cell, obj) { READWRITE(obj.nCount, obj.nIdSum, obj.nCheckSum); }
+    };
+
+private:
+    uint64_t nSalt;
+    std::vector<Cell> vecCells;
+
+    uint32_t GetCheckSum(uint64_t nShortId) const;
+    /** Index of the cell of sub-table nHash a short id is added to */
+    size_t GetCellIndex(uint64_t nShortId, int nHash) const;
+    /** A cell holding a single short id, which can be peeled out */
+    bool IsPure(const Cell& cell) const;
+    void Toggle(uint64_t nShortId, int32_t nDelta);
+
+public:
+    CVoteSketch() : nSalt(0) {}
+    CVoteSketch(uint32_t nCells, uint64_t nSaltIn);
+
+    /** Cells needed to recover nDiff differences with high probability, a multiple of HASH_COUNT */
+    static uint32_t GetCellCount(uint32_t nDiff);
+
+    /** Salted short id a vote hash is added to the sketch as */
+    uint64_t GetShortId(const uint256& nHash) const;
+
+    void Add(const uint256& nHash) { Toggle(GetShortId(nHash), 1); }
+
+    /** Subtract a sketch built with the same size and salt, false if they don't match */
+    bool Subtract(const CVoteSketch& other);
+
+    /**
+     * Peel the short ids out of a subtracted sketch: vecOurs gets the ones only added to this sketch,
+     * vecTheirs the ones only added to the subtracted one. False if the sketch was too small to recover
+     * all of them.
+     */
+    bool Decode(std::vector<uint64_t>& vecOurs, std::vector<uint64_t>& vecTheirs) const;
+
+    uint64_t GetSalt() const { return nSalt; }
+    size_t GetSize() const { return vecCells.size(); }
+
+    SERIALIZE_METHODS(CVoteSketch, obj) { READWRITE(obj.nSalt, obj.vecCells); }
+};
+
+/** Differences the next sketch is sized for after a peer failed to decode one sized for nPrevDiff */
+uint32_t GetNextReconDiff(uint32_t nPrevDiff, uint32_t nOurCount, uint32_t nTheirCount);
+
+#endif // SYSCOIN_GOVERNANCERECON_H
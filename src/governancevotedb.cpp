@@ -5,85 +5,273 @@
 
 #include <governancevotedb.h>
 
+#include <cachemap.h>
+
+const uint32_t CGovernanceObjectVoteFile::NO_VOTE;
+
+/** Home position of a vote hash in the index, salted once per process so peers can't aim votes at one probe sequence */
+static size_t IndexHash(const uint256& nHash)
+{
+    static const CacheKeyHasher<uint256> hasher;
+    return hasher(nHash);
+}
+
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile()
     : nMemoryVotes(0),
-      listVotes(),
-      mapVoteIndex()
+      nParentHash(),
+      vecVotes(),
+      vchSigArena(),
+      vecHashIndex(),
+      mapMasternodeVotes(),
+      nRemovedVotes(0)
 {}
 
 CGovernanceObjectVoteFile::CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other)
     : nMemoryVotes(other.nMemoryVotes),
-      listVotes(other.listVotes),
-      mapVoteIndex()
-{
-    RebuildIndex();
-}
+      nParentHash(other.nParentHash),
+      vecVotes(other.vecVotes),
+      vchSigArena(other.vchSigArena),
+      vecHashIndex(other.vecHashIndex),
+      mapMasternodeVotes(other.mapMasternodeVotes),
+      nRemovedVotes(other.nRemovedVotes)
+{}
 
-void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote)
+void CGovernanceObjectVoteFile::AddVote(const CGovernanceVote& vote, uint64_t nValidEpoch)
 {
     uint256 nHash = vote.GetHash();
     // make sure to never add/update already known votes
     if (HasVote(nHash))
         return;
-    listVotes.push_front(vote);
-    mapVoteIndex.emplace(nHash, listVotes.begin());
+    if (nMemoryVotes == 0) {
+        nParentHash = vote.GetParentHash();
+    } else if (vote.GetParentHash() != nParentHash) {
+        // all votes of a file belong to the same object
+        return;
+    }
+
+    CCompactVote cvote;
+    cvote.nHash = nHash;
+    cvote.masternodeOutpoint = vote.GetMasternodeOutpoint();
+    cvote.nTime = vote.GetTimestamp();
+    cvote.nVoteSignal = vote.nVoteSignal;
+    cvote.nVoteOutcome = vote.nVoteOutcome;
+    cvote.nSigOffset = vchSigArena.size();
+    cvote.nSigSize = vote.vchSig.size();
+    cvote.fRemoved = false;
+    cvote.nValidEpoch = nValidEpoch;
+    vchSigArena.insert(vchSigArena.end(), vote.vchSig.begin(), vote.vchSig.end());
+
+    const uint32_t nVote = vecVotes.size();
+    auto it = mapMasternodeVotes.emplace(cvote.masternodeOutpoint, NO_VOTE).first;
+    cvote.nMasternodeNext = it->second;
+    it->second = nVote;
+
+    vecVotes.push_back(cvote);
+    IndexInsert(nVote);
     ++nMemoryVotes;
 }
 
 bool CGovernanceObjectVoteFile::HasVote(const uint256& nHash) const
 {
-    return mapVoteIndex.find(nHash) != mapVoteIndex.end();
+    return FindVote(nHash) != NO_VOTE;
 }
 
 bool CGovernanceObjectVoteFile::SerializeVoteToStream(const uint256& nHash, CDataStream& ss) const
 {
-    vote_m_cit it = mapVoteIndex.find(nHash);
-    if(it == mapVoteIndex.end()) {
+    uint32_t nVote = FindVote(nHash);
+    if(nVote == NO_VOTE) {
         return false;
     }
-    ss << *(it->second);
+    ss << ExpandVote(vecVotes[nVote]);
     return true;
 }
 
 std::vector<CGovernanceVote> CGovernanceObjectVoteFile::GetVotes() const
 {
     std::vector<CGovernanceVote> vecResult;
-    for(vote_l_cit it = listVotes.begin(); it != listVotes.end(); ++it) {
-        vecResult.push_back(*it);
+    vecResult.reserve(nMemoryVotes);
+    for(auto it = vecVotes.rbegin(); it != vecVotes.rend(); ++it) {
+        if(!it->fRemoved) {
+            vecResult.push_back(ExpandVote(*it));
+        }
     }
     return vecResult;
 }
 
-void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
+std::vector<uint256> CGovernanceObjectVoteFile::GetVoteHashes() const
+{
+    std::vector<uint256> vecResult;
+    vecResult.reserve(nMemoryVotes);
+    for(auto it = vecVotes.rbegin(); it != vecVotes.rend(); ++it) {
+        if(!it->fRemoved) {
+            vecResult.push_back(it->nHash);
+        }
+    }
+    return vecResult;
+}
+
+void CGovernanceObjectVoteFile::ForEachValidVote(uint64_t nEpoch, const std::function<bool(const CGovernanceVote&)>& fnCheck, const std::function<void(const uint256&)>& fn) const
 {
-    vote_l_it it = listVotes.begin();
-    while(it != listVotes.end()) {
-        if(it->GetMasternodeOutpoint() == outpointMasternode) {
-            --nMemoryVotes;
-            mapVoteIndex.erase(it->GetHash());
-            listVotes.erase(it++);
+    for(auto it = vecVotes.rbegin(); it != vecVotes.rend(); ++it) {
+        if(it->fRemoved) {
+            continue;
         }
-        else {
-            ++it;
+        if(it->nValidEpoch != nEpoch) {
+            if(!fnCheck(ExpandVote(*it))) {
+                continue;
+            }
+            it->nValidEpoch = nEpoch;
         }
+        fn(it->nHash);
+    }
+}
+
+void CGovernanceObjectVoteFile::RemoveVotesFromMasternode(const COutPoint& outpointMasternode)
+{
+    auto it = mapMasternodeVotes.find(outpointMasternode);
+    if(it == mapMasternodeVotes.end()) {
+        return;
+    }
+    for(uint32_t nVote = it->second; nVote != NO_VOTE; nVote = vecVotes[nVote].nMasternodeNext) {
+        CCompactVote& cvote = vecVotes[nVote];
+        IndexErase(cvote.nHash);
+        cvote.fRemoved = true;
+        --nMemoryVotes;
+        ++nRemovedVotes;
+    }
+    mapMasternodeVotes.erase(it);
+
+    if(nRemovedVotes * 2 > vecVotes.size()) {
+        Compact();
     }
 }
 
-void CGovernanceObjectVoteFile::RebuildIndex()
+void CGovernanceObjectVoteFile::Clear()
 {
-    mapVoteIndex.clear();
     nMemoryVotes = 0;
-    vote_l_it it = listVotes.begin();
-    while(it != listVotes.end()) {
-        CGovernanceVote& vote = *it;
-        uint256 nHash = vote.GetHash();
-        if(mapVoteIndex.find(nHash) == mapVoteIndex.end()) {
-            mapVoteIndex[nHash] = it;
-            ++nMemoryVotes;
-            ++it;
+    nParentHash.SetNull();
+    vecVotes.clear();
+    vchSigArena.clear();
+    vecHashIndex.clear();
+    mapMasternodeVotes.clear();
+    nRemovedVotes = 0;
+}
+
+CGovernanceVote CGovernanceObjectVoteFile::ExpandVote(const CCompactVote& cvote) const
+{
+    CGovernanceVote vote;
+    vote.nVoteSignal = cvote.nVoteSignal;
+    vote.masternodeOutpoint = cvote.masternodeOutpoint;
+    vote.nParentHash = nParentHash;
+    vote.nVoteOutcome = cvote.nVoteOutcome;
+    vote.nTime = cvote.nTime;
+    auto itSig = vchSigArena.begin() + cvote.nSigOffset;
+    vote.vchSig.assign(itSig, itSig + cvote.nSigSize);
+    // the stored hash saves recomputing it
+    *const_cast<uint256*>(&vote.hash) = cvote.nHash;
+    return vote;
+}
+
+uint32_t CGovernanceObjectVoteFile::FindVote(const uint256& nHash) const
+{
+    if(vecHashIndex.empty()) {
+        return NO_VOTE;
+    }
+    const size_t nMask = vecHashIndex.size() - 1;
+    for(size_t nPos = IndexHash(nHash) & nMask; vecHashIndex[nPos] != NO_VOTE; nPos = (nPos + 1) & nMask) {
+        if(vecVotes[vecHashIndex[nPos]].nHash == nHash) {
+            return vecHashIndex[nPos];
+        }
+    }
+    return NO_VOTE;
+}
+
+void CGovernanceObjectVoteFile::IndexInsert(uint32_t nVote)
+{
+    // keep the load factor at or below 1/2 so probe sequences stay short
+    if((size_t(nMemoryVotes) + 1) * 2 > vecHashIndex.size()) {
+        // the new vote is already in vecVotes and gets picked up by the rebuild
+        IndexRebuild(std::max<size_t>(16, vecHashIndex.size() * 2));
+        return;
+    }
+    const size_t nMask = vecHashIndex.size() - 1;
+    size_t nPos = IndexHash(vecVotes[nVote].nHash) & nMask;
+    while(vecHashIndex[nPos] != NO_VOTE) {
+        nPos = (nPos + 1) & nMask;
+    }
+    vecHashIndex[nPos] = nVote;
+}
+
+void CGovernanceObjectVoteFile::IndexErase(const uint256& nHash)
+{
+    const size_t nMask = vecHashIndex.size() - 1;
+    size_t nHole = IndexHash(nHash) & nMask;
+    while(vecVotes[vecHashIndex[nHole]].nHash != nHash) {
+        nHole = (nHole + 1) & nMask;
+    }
+    // backward shift deletion, no tombstones needed
+    size_t nNext = nHole;
+    while(true) {
+        nNext = (nNext + 1) & nMask;
+        if(vecHashIndex[nNext] == NO_VOTE) {
+            break;
+        }
+        const size_t nIdeal = IndexHash(vecVotes[vecHashIndex[nNext]].nHash) & nMask;
+        // leave the entry where it is if its ideal position lies cyclically in (nHole, nNext]
+        const bool fStays = (nHole <= nNext) ? (nHole < nIdeal && nIdeal <= nNext) : (nHole < nIdeal || nIdeal <= nNext);
+        if(fStays) {
+            continue;
+        }
+        vecHashIndex[nHole] = vecHashIndex[nNext];
+        nHole = nNext;
+    }
+    vecHashIndex[nHole] = NO_VOTE;
+}
+
+void CGovernanceObjectVoteFile::IndexRebuild(size_t nSize)
+{
+    vecHashIndex.assign(nSize, NO_VOTE);
+    const size_t nMask = nSize - 1;
+    for(uint32_t nVote = 0; nVote < vecVotes.size(); ++nVote) {
+        if(vecVotes[nVote].fRemoved) {
+            continue;
+        }
+        size_t nPos = IndexHash(vecVotes[nVote].nHash) & nMask;
+        while(vecHashIndex[nPos] != NO_VOTE) {
+            nPos = (nPos + 1) & nMask;
         }
-        else {
-            listVotes.erase(it++);
+        vecHashIndex[nPos] = nVote;
+    }
+}
+
+void CGovernanceObjectVoteFile::Compact()
+{
+    std::vector<CCompactVote> vecOld;
+    std::vector<unsigned char> vchOldArena;
+    vecOld.swap(vecVotes);
+    vchOldArena.swap(vchSigArena);
+    mapMasternodeVotes.clear();
+    nRemovedVotes = 0;
+
+    vecVotes.reserve(nMemoryVotes);
+    for(CCompactVote& cvote : vecOld) {
+        if(cvote.fRemoved) {
+            continue;
         }
+        auto itSig = vchOldArena.begin() + cvote.nSigOffset;
+        cvote.nSigOffset = vchSigArena.size();
+        vchSigArena.insert(vchSigArena.end(), itSig, itSig + cvote.nSigSize);
+
+        const uint32_t nVote = vecVotes.size();
+        auto it = mapMasternodeVotes.emplace(cvote.masternodeOutpoint, NO_VOTE).first;
+        cvote.nMasternodeNext = it->second;
+        it->second = nVote;
+        vecVotes.push_back(cvote);
+    }
+
+    size_t nSize = 16;
+    while(size_t(nMemoryVotes) * 2 > nSize) {
+        nSize *= 2;
     }
+    IndexRebuild(nSize);
 }
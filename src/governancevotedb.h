@@ -6,9 +6,12 @@
 #ifndef SYSCOIN_GOVERNANCEVOTEDB_H
 #define SYSCOIN_GOVERNANCEVOTEDB_H
 
-#include <list>
-#include <map>
+#include <functional>
+#include <limits>
+#include <unordered_map>
+#include <vector>
 
+#include <coins.h>
 #include <governancevote.h>
 #include <serialize.h>
 #include <streams.h>
@@ -21,30 +24,52 @@
  *
  * Note: This is a stub implementation that doesn't limit the number of votes held
  * in memory and doesn't flush to disk.
+ *
+ * Votes are kept in a compact form: the parent hash is shared by the whole file,
+ * signatures are packed into a single arena and the vote hash is stored so it never
+ * has to be recomputed. Votes are found by hash through an open addressing table and
+ * by masternode outpoint through a per masternode index. Removed votes leave a hole
+ * which is reclaimed once holes make up half of the file.
  */
 class CGovernanceObjectVoteFile
 {
-public: // Types
-    typedef std::list<CGovernanceVote> vote_l_t;
+private:
+    static const int MAX_MEMORY_VOTES = -1;
 
-    typedef vote_l_t::iterator vote_l_it;
+    static const uint32_t NO_VOTE = std::numeric_limits<uint32_t>::max();
 
-    typedef vote_l_t::const_iterator vote_l_cit;
+    struct CCompactVote
+    {
+        uint256 nHash;
+        COutPoint masternodeOutpoint;
+        int64_t nTime;
+        int nVoteSignal;
+        int nVoteOutcome;
+        // signature bytes in vchSigArena
+        uint32_t nSigOffset;
+        uint32_t nSigSize;
+        // next vote of the same masternode
+        uint32_t nMasternodeNext;
+        bool fRemoved;
+        // masternode list epoch the vote was last fully validated against, 0 if never
+        mutable uint64_t nValidEpoch;
+    };
 
-    typedef std::map<uint256,vote_l_it> vote_m_t;
+    int nMemoryVotes;
 
-    typedef vote_m_t::iterator vote_m_it;
+    uint256 nParentHash;
 
-    typedef vote_m_t::const_iterator vote_m_cit;
+    std::vector<CCompactVote> vecVotes;
 
-private:
-    static const int MAX_MEMORY_VOTES = -1;
+    std::vector<unsigned char> vchSigArena;
 
-    int nMemoryVotes;
+    /** Open addressing table of vecVotes positions, keyed by vote hash */
+    std::vector<uint32_t> vecHashIndex;
 
-    vote_l_t listVotes;
+    /** Latest vote of each masternode, the others are chained through nMasternodeNext */
+    std::unordered_map<COutPoint, uint32_t, SaltedOutpointHasher> mapMasternodeVotes;
 
-    vote_m_t mapVoteIndex;
+    uint32_t nRemovedVotes;
 
 public:
     CGovernanceObjectVoteFile();
@@ -52,9 +77,9 @@ public:
     CGovernanceObjectVoteFile(const CGovernanceObjectVoteFile& other);
 
     /**
-     * Add a vote to the file
+     * Add a vote to the file, nValidEpoch is the masternode list epoch it was validated against
      */
-    void AddVote(const CGovernanceVote& vote);
+    void AddVote(const CGovernanceVote& vote, uint64_t nValidEpoch = 0);
 
     /**
      * Return true if the vote with this hash is currently cached in memory
@@ -66,28 +91,66 @@ public:
      */
     bool SerializeVoteToStream(const uint256& nHash, CDataStream& ss) const;
 
-    int GetVoteCount() {
+    int GetVoteCount() const {
         return nMemoryVotes;
     }
 
     std::vector<CGovernanceVote> GetVotes() const;
 
+    /** Hashes of all votes in the file, without expanding them */
+    std::vector<uint256> GetVoteHashes() const;
+
+    /**
+     * Call fn with the hash of every vote valid against masternode list epoch nEpoch, without
+     * expanding the votes. Only votes not yet validated for that epoch are expanded and passed to
+     * fnCheck, a successful check is remembered until the epoch changes.
+     */
+    void ForEachValidVote(uint64_t nEpoch, const std::function<bool(const CGovernanceVote&)>& fnCheck, const std::function<void(const uint256&)>& fn) const;
+
     void RemoveVotesFromMasternode(const COutPoint& outpointMasternode);
 
-    ADD_SERIALIZE_METHODS;
+    /** Serialized as the vote count followed by the list of votes */
+    template<typename Stream>
+    void Serialize(Stream& s) const
+    {
+        s << nMemoryVotes;
+        WriteCompactSize(s, nMemoryVotes);
+        // most recent vote first, like the former std::list
+        for(auto it = vecVotes.rbegin(); it != vecVotes.rend(); ++it) {
+            if(!it->fRemoved) {
+                s << ExpandVote(*it);
+            }
+        }
+    }
 
-    template <typename Stream, typename Operation>
-    inline void SerializationOp(Stream& s, Operation ser_action)
+    template<typename Stream>
+    void Unserialize(Stream& s)
     {
-        READWRITE(nMemoryVotes);
-        READWRITE(listVotes);
-        if(ser_action.ForRead()) {
-            RebuildIndex();
+        Clear();
+        int nVotes;
+        s >> nVotes;
+        std::vector<CGovernanceVote> vecRead;
+        s >> vecRead;
+        for(auto it = vecRead.rbegin(); it != vecRead.rend(); ++it) {
+            AddVote(*it);
         }
     }
+
 private:
-    void RebuildIndex();
+    void Clear();
+
+    CGovernanceVote ExpandVote(const CCompactVote& cvote) const;
+
+    uint32_t FindVote(const uint256& nHash) const;
+
+    void IndexInsert(uint32_t nVote);
+
+    void IndexErase(const uint256& nHash);
+
+    void IndexRebuild(size_t nSize);
 
+    /** Drop removed votes and their signatures, then rebuild the indexes */
+    void Compact();
 };
 
 #endif // SYSCOIN_GOVERNANCEVOTEDB_H
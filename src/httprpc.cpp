@@ -7,6 +7,7 @@
 #include <chainparams.h>
 #include <crypto/hmac_sha256.h>
 #include <httpserver.h>
+#include <rpc/jsonstream.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
 #include <ui_interface.h>
@@ -342,7 +343,19 @@ static bool HTTPReq_JSONRPC(HTTPRequest* req, const std::string &)
                 req->WriteReply(HTTP_FORBIDDEN);
                 return false;
             }
+            // SYSCOIN RPCs with large results may stream them in a chunked reply
+            jreq.replyStream = std::make_shared<JSONRPCReplyStream>(jreq.id,
+                [req] {
+                    req->WriteHeader("Content-Type", "application/json");
+                    req->StartChunkedReply(HTTP_OK);
+                },
+                [req](const std::string& strChunk) { req->WriteReplyChunk(strChunk); });
             UniValue result = tableRPC.execute(jreq);
+            if (jreq.replyStream->IsStarted()) {
+                jreq.replyStream->Finish();
+                req->EndChunkedReply();
+                return true;
+            }
 
             // Send reply
             strReply = JSONRPCReply(result, NullUniValue, jreq.id);
@@ -16,6 +16,7 @@
 #include <ui_interface.h>
 
 #include <deque>
+#include <future>
 #include <memory>
 #include <stdio.h>
 #include <stdlib.h>
@@ -42,6 +43,12 @@
 /** Maximum size of http request (request line + headers) */
 static const size_t MAX_HEADERS_SIZE = 8192;
 
+// SYSCOIN
+/** Chunks of a reply are held back while more than this is waiting to be sent on the connection */
+static const size_t MAX_CHUNKED_REPLY_BUFFERED = 1024 * 1024;
+/** How often the output buffer of a connection is looked at while a chunked reply waits for it */
+static const int CHUNKED_REPLY_DRAIN_POLL_MS = 10;
+
 /** HTTP request work item */
 class HTTPWorkItem final : public HTTPClosure
 {
@@ -523,7 +530,8 @@ void HTTPEvent::trigger(struct timeval* tv)
         evtimer_add(ev, tv); // trigger after timeval passed
 }
 HTTPRequest::HTTPRequest(struct evhttp_request* _req) : req(_req),
-                                                       replySent(false)
+                                                       replySent(false),
+                                                       replyChunked(false)
 {
 }
 HTTPRequest::~HTTPRequest()
@@ -579,9 +587,41 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
  * Replies must be sent in the main loop in the main http thread,
  * this cannot be done from worker threads.
  */
+// Re-enable reading from the socket once the reply was sent. This is the second part of the
+// libevent workaround in http_request_cb.
+static void http_reply_sent(struct evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
 {
     assert(!replySent && req);
+    // SYSCOIN the status of a chunked reply was already sent, so an error can't be reported anymore.
+    // Close the connection without the terminating chunk, the client then knows the body is incomplete.
+    if (replyChunked) {
+        LogPrintf("%s: Chunked reply to %s failed, closing the connection\n", __func__, GetURI());
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy]{
+            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
+            if (conn) {
+                evhttp_connection_free(conn);
+            }
+        });
+        ev->trigger(nullptr);
+        replySent = true;
+        replyChunked = false;
+        req = nullptr; // transferred back to main thread
+        return;
+    }
     if (ShutdownRequested()) {
         WriteHeader("Connection", "close");
     }
@@ -592,20 +632,80 @@ void HTTPRequest::WriteReply(int nStatus, const std::string& strReply)
     auto req_copy = req;
     HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02020001) {
-            evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
-        }
+        http_reply_sent(req_copy);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+// SYSCOIN
+/** Fulfill drained once the connection of req has at most MAX_CHUNKED_REPLY_BUFFERED bytes left to send, polled on the http thread */
+static void http_wait_drained(struct evhttp_request* req, const std::shared_ptr<std::promise<void>>& drained)
+{
+    evhttp_connection* conn = evhttp_request_get_connection(req);
+    bufferevent* bev = conn ? evhttp_connection_get_bufferevent(conn) : nullptr;
+    // don't keep a worker waiting on a stalled client during shutdown
+    if (!bev || evbuffer_get_length(bufferevent_get_output(bev)) <= MAX_CHUNKED_REPLY_BUFFERED || ShutdownRequested()) {
+        drained->set_value();
+        return;
+    }
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req, drained]{
+        http_wait_drained(req, drained);
+    });
+    struct timeval tv = {0, CHUNKED_REPLY_DRAIN_POLL_MS * 1000};
+    ev->trigger(&tv);
+}
+
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && !replyChunked && req);
+    if (ShutdownRequested()) {
+        WriteHeader("Connection", "close");
+    }
+    // The events of a request are handled by the main http thread in the order they were triggered
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+    replyChunked = true;
+}
+
+void HTTPRequest::WriteReplyChunk(const std::string& strChunk)
+{
+    assert(!replySent && replyChunked && req);
+    if (strChunk.empty()) {
+        // an empty chunk would end the reply
+        return;
+    }
+    struct evbuffer* evb = evbuffer_new();
+    assert(evb);
+    evbuffer_add(evb, strChunk.data(), strChunk.size());
+    auto req_copy = req;
+    auto drained = std::make_shared<std::promise<void>>();
+    std::future<void> fDrained = drained->get_future();
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, evb, drained]{
+        evhttp_send_reply_chunk(req_copy, evb);
+        evbuffer_free(evb);
+        http_wait_drained(req_copy, drained);
+    });
+    ev->trigger(nullptr);
+    // a client reading slower than the reply is produced must not make it pile up in memory
+    fDrained.wait();
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(!replySent && replyChunked && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy]{
+        evhttp_send_reply_end(req_copy);
+        http_reply_sent(req_copy);
     });
     ev->trigger(nullptr);
     replySent = true;
+    replyChunked = false;
     req = nullptr; // transferred back to main thread
 }
 
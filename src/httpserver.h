@@ -58,6 +58,8 @@ class HTTPRequest
 private:
     struct evhttp_request* req;
     bool replySent;
+    // SYSCOIN a chunked reply was started and is still being sent
+    bool replyChunked;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req);
@@ -114,6 +116,24 @@ public:
      * main thread, do not call any other HTTPRequest methods after calling this.
      */
     void WriteReply(int nStatus, const std::string& strReply = "");
+
+    // SYSCOIN
+    /**
+     * Start a reply with chunked transfer encoding, for bodies sent while they are still being
+     * produced. The body is sent with WriteReplyChunk() and the reply completed with EndChunkedReply().
+     * A WriteReply() after this means the reply failed: the status was already sent, so the connection
+     * is closed without the terminating chunk.
+     */
+    void StartChunkedReply(int nStatus);
+    /** Send a piece of the body, waits while too much of the reply is still queued on the connection */
+    void WriteReplyChunk(const std::string& strChunk);
+    /**
+     * Complete a chunked reply.
+     *
+     * @note As this gives the request back to the main thread, do not call any other HTTPRequest
+     * methods after calling this.
+     */
+    void EndChunkedReply();
 };
 
 /** Event handler closure.
@@ -12,6 +12,7 @@
 #include <addrman.h>
 #include <amount.h>
 #include <banman.h>
+#include <blockcache.h>
 #include <blockfilter.h>
 #include <chain.h>
 #include <chainparams.h>
@@ -87,6 +88,7 @@
 #include <activemasternode.h>
 #include <dsnotificationinterface.h>
 #include <governance.h>
+#include <maintenance.h>
 #include <masternodepayments.h>
 #include <masternodesync.h>
 #include <masternodeman.h>
@@ -249,6 +251,7 @@ void Shutdown(NodeContext& node)
     if (node.peer_logic) UnregisterValidationInterface(node.peer_logic.get());
     if (node.connman) node.connman->Stop();
     if (g_auxpow_miner != nullptr) {
+        g_auxpow_miner->stopBackgroundBlocks();
         g_auxpow_miner.reset();
     }
     StopTorControl();
@@ -256,6 +259,7 @@ void Shutdown(NodeContext& node)
     // After everything has been shut down, but before things get flushed, stop the
     // CScheduler/checkqueue threadGroup
     if (node.scheduler) node.scheduler->stop();
+    maintenanceman.Stop();
     threadGroup.interrupt_all();
     threadGroup.join_all();
 
@@ -441,6 +445,10 @@ void SetupServerArgs()
     gArgs.AddArg("-conf=<file>", strprintf("Specify configuration file. Relative paths will be prefixed by datadir location. (default: %s)", SYSCOIN_CONF_FILENAME), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-datadir=<dir>", "Specify data directory", ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbbatchsize", strprintf("Maximum database write batch size in bytes (default: %u)", nDefaultDbBatchSize), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    // SYSCOIN
+    gArgs.AddArg("-syscoindbshare=<name>:<weight>", "Weight of a Syscoin database in the split of the write buffer budget (assetallocations, assets, blockindex, assetindex, ethereumtxroots, ethereumminttx, lockedoutpoints). Can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
+    // SYSCOIN
+    gArgs.AddArg("-blockcachesize=<n>", strprintf("Keep at most <n> MiB of recently connected blocks in memory for RPC, REST, indexes and masternode payments (default: %d)", DEFAULT_RECENT_BLOCK_CACHE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-dbcache=<n>", strprintf("Maximum database cache size <n> MiB (%d to %d, default: %d). In addition, unused mempool memory is shared for this cache (see -maxmempool).", nMinDbCache, nMaxDbCache, nDefaultDbCache), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-debuglogfile=<file>", strprintf("Specify location of debug log file. Relative paths will be prefixed by a net-specific datadir location. (-nodebuglogfile to disable; default: %s)", DEFAULT_DEBUGLOGFILE), ArgsManager::ALLOW_ANY, OptionsCategory::OPTIONS);
     gArgs.AddArg("-feefilter", strprintf("Tell other nodes to filter invs to us by our mempool min fee (default: %u)", DEFAULT_FEEFILTER), ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::OPTIONS);
@@ -503,6 +511,8 @@ void SetupServerArgs()
     gArgs.AddArg("-listenonion", strprintf("Automatically create Tor hidden service (default: %d)", DEFAULT_LISTEN_ONION), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxconnections=<n>", strprintf("Maintain at most <n> connections to peers (default: %u)", DEFAULT_MAX_PEER_CONNECTIONS), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxreceivebuffer=<n>", strprintf("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXRECEIVEBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
+    // SYSCOIN
+    gArgs.AddArg("-socketevents=<mode>", strprintf("Socket events mode, which must be one of: %s (default: %s)", GetSupportedSocketEventsModes(), SocketEventsModeToString(DEFAULT_SOCKETEVENTS)), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxsendbuffer=<n>", strprintf("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)", DEFAULT_MAXSENDBUFFER), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxtimeadjustment", strprintf("Maximum allowed median peer time offset adjustment. Local perspective of time may be influenced by peers forward or backward by this amount. (default: %u seconds)", DEFAULT_MAX_TIME_ADJUSTMENT), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
     gArgs.AddArg("-maxuploadtarget=<n>", strprintf("Tries to keep outbound traffic under the given target (in MiB per 24h), 0 = no limit (default: %d)", DEFAULT_MAX_UPLOAD_TARGET), ArgsManager::ALLOW_ANY, OptionsCategory::CONNECTION);
@@ -547,6 +557,10 @@ void SetupServerArgs()
     gArgs.AddArg("-zmqpubethstatus=<address>", "Enable publish Ethereum status updates in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubnetworkstatus=<address>", "Enable publish network updates when a peer is connected or disconnected in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubwalletrawtx=<address>", "Enable publish all wallet related transactions in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetallocationdelta=<address>", "Enable publish binary asset allocation balance changes of transactions entering the mempool or a block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetzdagconflict=<address>", "Enable publish binary ZDAG double spend flags in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetmint=<address>", "Enable publish binary bridge mint events in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
+    gArgs.AddArg("-zmqpubassetburn=<address>", "Enable publish binary bridge burn events in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashblock=<address>", "Enable publish hash block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubhashtx=<address>", "Enable publish hash transaction in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
     gArgs.AddArg("-zmqpubrawblock=<address>", "Enable publish raw block in <address>", ArgsManager::ALLOW_ANY, OptionsCategory::ZMQ);
@@ -563,6 +577,10 @@ void SetupServerArgs()
     hidden_args.emplace_back("-zmqpubethstatus=<address>");
     hidden_args.emplace_back("-zmqpubnetworkstatus=<address>");
     hidden_args.emplace_back("-zmqpubwalletrawtx=<address>");
+    hidden_args.emplace_back("-zmqpubassetallocationdelta=<address>");
+    hidden_args.emplace_back("-zmqpubassetzdagconflict=<address>");
+    hidden_args.emplace_back("-zmqpubassetmint=<address>");
+    hidden_args.emplace_back("-zmqpubassetburn=<address>");
     hidden_args.emplace_back("-zmqpubhashblock=<address>");
     hidden_args.emplace_back("-zmqpubhashtx=<address>");
     hidden_args.emplace_back("-zmqpubrawblock=<address>");
@@ -627,11 +645,16 @@ void SetupServerArgs()
 
     gArgs.AddArg("-blockmaxweight=<n>", strprintf("Set maximum BIP141 block weight (default: %d)", DEFAULT_BLOCK_MAX_WEIGHT), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockmintxfee=<amt>", strprintf("Set lowest fee rate (in %s/kB) for transactions to be included in block creation. (default: %s)", CURRENCY_UNIT, FormatMoney(DEFAULT_BLOCK_MIN_TX_FEE)), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
+    // SYSCOIN
+    gArgs.AddArg("-auxpowtemplatemem=<n>", strprintf("Keep at most <n> MiB of block templates built for merge-mining with createauxblock (default: %u)", DEFAULT_AUXPOW_TEMPLATE_MEMORY), ArgsManager::ALLOW_ANY, OptionsCategory::BLOCK_CREATION);
     gArgs.AddArg("-blockversion=<n>", "Override block version to test forking scenarios", ArgsManager::ALLOW_ANY | ArgsManager::DEBUG_ONLY, OptionsCategory::BLOCK_CREATION);
 
     gArgs.AddArg("-rest", strprintf("Accept public REST requests (default: %u)", DEFAULT_REST_ENABLE), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcallowip=<ip>", "Allow JSON-RPC connections from specified source. Valid for <ip> are a single IP (e.g. 1.2.3.4), a network/netmask (e.g. 1.2.3.4/255.255.255.0) or a network/CIDR (e.g. 1.2.3.4/24). This option can be specified multiple times", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcauth=<userpw>", "Username and HMAC-SHA-256 hashed password for JSON-RPC connections. The field <userpw> comes in the format: <USERNAME>:<SALT>$<HASH>. A canonical python script is included in share/rpcauth. The client then connects normally using the rpcuser=<USERNAME>/rpcpassword=<PASSWORD> pair of arguments. This option can be specified multiple times", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
+    // SYSCOIN
+    gArgs.AddArg("-rpcbatchconcurrency=<n>", strprintf("Run at most <n> calls of one JSON-RPC batch at once when -rpcbatchthreads is set (default: %d)", DEFAULT_RPC_BATCH_CONCURRENCY), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
+    gArgs.AddArg("-rpcbatchthreads=<n>", strprintf("Set the number of threads the calls of a JSON-RPC batch fan out to, the calls may then run in any order. 0 runs them one after another (default: %d)", DEFAULT_RPC_BATCH_THREADS), ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcbind=<addr>[:port]", "Bind to given address to listen for JSON-RPC connections. Do not expose the RPC server to untrusted networks such as the public internet! This option is ignored unless -rpcallowip is also passed. Port is optional and overrides -rpcport. Use [host]:port notation for IPv6. This option can be specified multiple times (default: 127.0.0.1 and ::1 i.e., localhost)", ArgsManager::ALLOW_ANY | ArgsManager::NETWORK_ONLY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
     gArgs.AddArg("-rpccookiefile=<loc>", "Location of the auth cookie. Relative paths will be prefixed by a net-specific datadir location. (default: data dir)", ArgsManager::ALLOW_ANY, OptionsCategory::RPC);
     gArgs.AddArg("-rpcpassword=<pw>", "Password for JSON-RPC connections", ArgsManager::ALLOW_ANY | ArgsManager::SENSITIVE, OptionsCategory::RPC);
@@ -1377,6 +1400,11 @@ bool AppInitMain(NodeContext& node)
         for (int i = 0; i < script_threads; ++i) {
             threadGroup.create_thread([i]() { return ThreadScriptCheck(i); });
         }
+        // SYSCOIN the auxpow of header batches is checked on as many threads of its own
+        g_parallel_header_checks = true;
+        for (int i = 0; i < script_threads; ++i) {
+            threadGroup.create_thread([i]() { return ThreadHeaderCheck(i); });
+        }
     }
     
    
@@ -1458,6 +1486,8 @@ bool AppInitMain(NodeContext& node)
 
     node.peer_logic.reset(new PeerLogicValidation(node.connman.get(), node.banman.get(), *node.scheduler, *node.mempool));
     RegisterValidationInterface(node.peer_logic.get());
+    // SYSCOIN build the blocks merge-miners ask for in the background
+    g_auxpow_miner->startBackgroundBlocks(*node.mempool, std::max<int64_t>(gArgs.GetArg("-auxpowtemplatemem", DEFAULT_AUXPOW_TEMPLATE_MEMORY), 1) << 20);
 
     // sanitize comments per BIP-0014, format user agent and check total size
     std::vector<std::string> uacomments;
@@ -1608,6 +1638,9 @@ bool AppInitMain(NodeContext& node)
         filter_index_cache = max_cache / n_indexes;
         nTotalCache -= filter_index_cache * n_indexes;
     }
+    // SYSCOIN
+    int64_t nSyscoinDBCache = std::min(nTotalCache / 4, nMaxSyscoinDBCache << 20);
+    nTotalCache -= nSyscoinDBCache;
     int64_t nCoinDBCache = std::min(nTotalCache / 2, (nTotalCache / 4) + (1 << 23)); // use 25%-50% of the remainder for disk cache
     nCoinDBCache = std::min(nCoinDBCache, nMaxCoinsDBCache << 20); // cap total coins db cache
     nTotalCache -= nCoinDBCache;
@@ -1624,8 +1657,13 @@ bool AppInitMain(NodeContext& node)
         LogPrintf("* Using %.1f MiB for %s block filter index database\n",
                   filter_index_cache * (1.0 / 1024 / 1024), BlockFilterTypeName(filter_type));
     }
+    LogPrintf("* Using %.1f MiB for Syscoin asset databases\n", nSyscoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for chain state database\n", nCoinDBCache * (1.0 / 1024 / 1024));
     LogPrintf("* Using %.1f MiB for in-memory UTXO set (plus up to %.1f MiB of unused mempool space)\n", nCoinCacheUsage * (1.0 / 1024 / 1024), nMempoolSizeMax * (1.0 / 1024 / 1024));
+    // SYSCOIN
+    const int64_t nRecentBlockCache = std::max<int64_t>(gArgs.GetArg("-blockcachesize", DEFAULT_RECENT_BLOCK_CACHE), 0) << 20;
+    recentblockcache.SetMaxMemory(nRecentBlockCache);
+    LogPrintf("* Using %.1f MiB for recently connected blocks\n", nRecentBlockCache * (1.0 / 1024 / 1024));
 
     while (!fLoaded && !ShutdownRequested()) {
         bool fReset = fReindex;
@@ -1652,9 +1690,11 @@ bool AppInitMain(NodeContext& node)
                 pethereumtxmintdb.reset();
                 pblockindexdb.reset();
 				plockedoutpointsdb.reset();
-				plockedoutpointsdb.reset(new CLockedOutpointsDB(nCoinDBCache * 16, false, fReset));
-                passetdb.reset(new CAssetDB(nCoinDBCache*16, false, fReset || fReindexChainState));
-                passetallocationdb.reset(new CAssetAllocationDB(nCoinDBCache*32, false, fReset || fReindexChainState));
+                fAssetIndex = gArgs.GetBoolArg("-assetindex", false);
+                syscoindbbudget.Init(nSyscoinDBCache, fAssetIndex);
+				plockedoutpointsdb.reset(new CLockedOutpointsDB(syscoindbbudget.GetCacheSize("lockedoutpoints"), false, fReset));
+                passetdb.reset(new CAssetDB(syscoindbbudget.GetCacheSize("assets"), false, fReset || fReindexChainState));
+                passetallocationdb.reset(new CAssetAllocationDB(syscoindbbudget.GetCacheSize("assetallocations"), false, fReset || fReindexChainState));
                 passetallocationmempooldb.reset(new CAssetAllocationMempoolDB(0, false, fReset || fReindexChainState));
                 {
                     LOCK(cs_assetallocationmempoolbalance);
@@ -1669,12 +1709,15 @@ bool AppInitMain(NodeContext& node)
                     passetallocationmempooldb->ReadAssetAllocationMempoolToRemoveSet(setToRemoveFromMempool);
                 }           
                 // we don't need to ever reset the txroots db because it is an external chain not related to syscoin chain
-                pethereumtxrootsdb.reset(new CEthereumTxRootsDB(nCoinDBCache*16, false, false));
-                pethereumtxmintdb.reset(new CEthereumMintedTxDB(nCoinDBCache, false, fReset || fReindexChainState));
-                pblockindexdb.reset(new CBlockIndexDB(nCoinDBCache, false, fReset || fReindexChainState));
-                fAssetIndex = gArgs.GetBoolArg("-assetindex", false);	
+                pethereumtxrootsdb.reset(new CEthereumTxRootsDB(syscoindbbudget.GetCacheSize("ethereumtxroots"), false, false));
+                pethereumtxmintdb.reset(new CEthereumMintedTxDB(syscoindbbudget.GetCacheSize("ethereumminttx"), false, fReset || fReindexChainState));
+                pblockindexdb.reset(new CBlockIndexDB(syscoindbbudget.GetCacheSize("blockindex"), false, fReset || fReindexChainState));
                 if(fAssetIndex)	
-                    passetindexdb.reset(new CAssetIndexDB(nCoinDBCache*16, false, fReset));
+                    passetindexdb.reset(new CAssetIndexDB(syscoindbbudget.GetCacheSize("assetindex"), false, fReset));
+                if (IsAssetSnapshotLoading()) {
+                    strLoadError = _("The asset databases are incomplete, loading a snapshot into them was interrupted. You need to rebuild them using -reindex-chainstate.").translated;
+                    break;
+                }
                 // new CBlockTreeDB tries to delete the existing file, which
                 // fails if it's still open from the previous loop. Close it first:
                 pblocktree.reset();
@@ -1937,6 +1980,7 @@ bool AppInitMain(NodeContext& node)
     fZMQEthStatus = gArgs.IsArgSet("-zmqpubethstatus");
     fZMQNetworkStatus = gArgs.IsArgSet("-zmqpubnetworkstatus");
     fZMQWalletRawTx = gArgs.IsArgSet("-zmqpubwalletrawtx");
+    fZMQAssetZdagConflict = gArgs.IsArgSet("-zmqpubassetzdagconflict");
 
      //lite mode disables all masternode functionality
     fLiteMode = gArgs.GetBoolArg("-litemode", false);
@@ -2017,11 +2061,13 @@ bool AppInitMain(NodeContext& node)
     if (!fLiteMode) {
         node.scheduler->scheduleEvery(std::bind(&CNetFulfilledRequestManager::DoMaintenance, std::ref(netfulfilledman)), std::chrono::minutes{1});
         node.scheduler->scheduleEvery(std::bind(&CMasternodeSync::DoMaintenance, std::ref(masternodeSync), std::ref(*g_rpc_node->connman)), std::chrono::seconds{MASTERNODE_SYNC_TICK_SECONDS});
-        node.scheduler->scheduleEvery(std::bind(&CMasternodeMan::DoMaintenance, std::ref(mnodeman), std::ref(*g_rpc_node->connman)), std::chrono::minutes{1});
         node.scheduler->scheduleEvery(std::bind(&CActiveMasternode::DoMaintenance, std::ref(activeMasternode), std::ref(*g_rpc_node->connman)), std::chrono::seconds{MASTERNODE_MIN_MNP_SECONDS});
 
-        node.scheduler->scheduleEvery(std::bind(&CMasternodePayments::DoMaintenance, std::ref(mnpayments)), std::chrono::minutes{1});
-        node.scheduler->scheduleEvery(std::bind(&CGovernanceManager::DoMaintenance, std::ref(governance), std::ref(*g_rpc_node->connman)), std::chrono::minutes{5});
+        // full list passes run on their own low priority thread, see maintenance.h
+        maintenanceman.Start(threadGroup);
+        maintenanceman.ScheduleEvery("mnodeman", std::bind(&CMasternodeMan::DoMaintenance, std::ref(mnodeman), std::ref(*g_rpc_node->connman)), std::chrono::minutes{1});
+        maintenanceman.ScheduleEvery("mnpayments", std::bind(&CMasternodePayments::DoMaintenance, std::ref(mnpayments)), std::chrono::minutes{1});
+        maintenanceman.ScheduleEvery("governance", std::bind(&CGovernanceManager::DoMaintenance, std::ref(governance), std::ref(*g_rpc_node->connman)), std::chrono::minutes{5});
     }
     // ********************************************************* Step 12: start node
 
@@ -2063,6 +2109,11 @@ bool AppInitMain(NodeContext& node)
     connOptions.nMaxOutboundTimeframe = nMaxOutboundTimeframe;
     connOptions.nMaxOutboundLimit = nMaxOutboundLimit;
     connOptions.m_peer_connect_timeout = peer_connect_timeout;
+    // SYSCOIN
+    const std::string strSocketEvents = gArgs.GetArg("-socketevents", SocketEventsModeToString(DEFAULT_SOCKETEVENTS));
+    if (!SocketEventsModeFromString(strSocketEvents, connOptions.socketEventsMode)) {
+        return InitError(strprintf(_("Invalid -socketevents ('%s'), must be one of: %s").translated, strSocketEvents, GetSupportedSocketEventsModes()));
+    }
 
     for (const std::string& strBind : gArgs.GetArgs("-bind")) {
         CService addrBind;
@@ -0,0 +1,89 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <maintenance.h>
+#include <logging.h>
+#include <util/system.h>
+#include <util/time.h>
+
+#include <boost/thread.hpp>
+
+CMaintenanceManager maintenanceman;
+
+void CMaintenanceManager::Start(boost::thread_group& threadGroup)
+{
+    CScheduler::Function serviceLoop = [this]{
+        // maintenance is never latency critical, let everything else go first
+        ScheduleBatchPriority();
+        scheduler.serviceQueue();
+    };
+    threadGroup.create_thread(std::bind(&TraceThread<CScheduler::Function>, "mnmaint", serviceLoop));
+}
+
+void CMaintenanceManager::Stop()
+{
+    scheduler.stop();
+}
+
+void CMaintenanceManager::ScheduleEvery(const std::string& strJob, CScheduler::Function f, std::chrono::milliseconds delta)
+{
+    {
+        LOCK(cs);
+        mapJobStats.emplace(strJob, MaintenanceJobStats());
+    }
+    scheduler.scheduleEvery([strJob, f]{
+        CMaintenanceRunTimer timer(strJob);
+        f();
+    }, delta);
+}
+
+void CMaintenanceManager::RecordSlice(const std::string& strJob, int nItems, int64_t nMicros)
+{
+    LOCK(cs);
+    MaintenanceJobStats& stats = mapJobStats[strJob];
+    stats.nSlices++;
+    stats.nItems += nItems;
+    stats.nMaxSliceMicros = std::max(stats.nMaxSliceMicros, nMicros);
+}
+
+void CMaintenanceManager::RecordRun(const std::string& strJob, int64_t nMicros)
+{
+    LOCK(cs);
+    MaintenanceJobStats& stats = mapJobStats[strJob];
+    stats.nRuns++;
+    stats.nLastRunTime = GetTime();
+    stats.nLastRunMicros = nMicros;
+    stats.nMaxRunMicros = std::max(stats.nMaxRunMicros, nMicros);
+    stats.nTotalRunMicros += nMicros;
+}
+
+std::map<std::string, MaintenanceJobStats> CMaintenanceManager::GetJobStats() const
+{
+    LOCK(cs);
+    return mapJobStats;
+}
+
+CMaintenanceRunTimer::CMaintenanceRunTimer(const std::string& strJobIn) :
+    strJob(strJobIn),
+    nTimeStart(GetTimeMicros())
+{}
+
+CMaintenanceRunTimer::~CMaintenanceRunTimer()
+{
+    const int64_t nMicros = GetTimeMicros() - nTimeStart;
+    maintenanceman.RecordRun(strJob, nMicros);
+    LogPrint(BCLog::BENCH, "Maintenance job %s: %.2fms\n", strJob, nMicros * 0.001);
+}
+
+CMaintenanceSliceTimer::CMaintenanceSliceTimer(const std::string& strJobIn) :
+    strJob(strJobIn),
+    nTimeStart(GetTimeMicros())
+{}
+
+CMaintenanceSliceTimer::~CMaintenanceSliceTimer()
+{
+    const int64_t nMicros = GetTimeMicros() - nTimeStart;
+    maintenanceman.RecordSlice(strJob, nItems, nMicros);
+    LogPrint(BCLog::BENCH, "    - Maintenance slice %s: %d items, %.2fms\n", strJob, nItems, nMicros * 0.001);
+}
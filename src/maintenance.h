@@ -0,0 +1,93 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_MAINTENANCE_H
+#define SYSCOIN_MAINTENANCE_H
+
+#include <scheduler.h>
+#include <sync.h>
+
+#include <chrono>
+#include <map>
+#include <string>
+
+namespace boost {
+class thread_group;
+} // namespace boost
+
+class CMaintenanceManager;
+extern CMaintenanceManager maintenanceman;
+
+/** Maximum number of list entries processed per lock acquisition by incremental maintenance jobs */
+static const int MAINTENANCE_SLICE_SIZE = 100;
+
+/** Timing bookkeeping of one periodic maintenance job */
+struct MaintenanceJobStats {
+    int64_t nRuns{0};
+    int64_t nSlices{0};
+    int64_t nItems{0};
+    int64_t nLastRunTime{0};
+    int64_t nLastRunMicros{0};
+    int64_t nMaxRunMicros{0};
+    int64_t nTotalRunMicros{0};
+    int64_t nMaxSliceMicros{0};
+};
+
+// Runs the periodic masternode, payment and governance maintenance jobs on a dedicated
+// low priority thread so that full list passes never hold up the lightweight scheduler.
+// Jobs work through their lists in slices of MAINTENANCE_SLICE_SIZE entries and release
+// cs_main between slices, reporting timings through the BENCH log category.
+class CMaintenanceManager
+{
+private:
+    CScheduler scheduler;
+
+    mutable RecursiveMutex cs;
+    std::map<std::string, MaintenanceJobStats> mapJobStats GUARDED_BY(cs);
+
+public:
+    CMaintenanceManager() {}
+
+    /** Start the worker thread, it is joined together with the rest of threadGroup */
+    void Start(boost::thread_group& threadGroup);
+    void Stop();
+
+    /** Repeat a named job until stopped, first run is after delta has passed once */
+    void ScheduleEvery(const std::string& strJob, CScheduler::Function f, std::chrono::milliseconds delta);
+
+    /** Account for one slice of a job that processed nItems entries in nMicros */
+    void RecordSlice(const std::string& strJob, int nItems, int64_t nMicros);
+    /** Account for a completed run of a job */
+    void RecordRun(const std::string& strJob, int64_t nMicros);
+
+    std::map<std::string, MaintenanceJobStats> GetJobStats() const;
+};
+
+/** Times a whole maintenance run, the result is recorded when going out of scope */
+class CMaintenanceRunTimer
+{
+private:
+    const std::string strJob;
+    const int64_t nTimeStart;
+
+public:
+    explicit CMaintenanceRunTimer(const std::string& strJobIn);
+    ~CMaintenanceRunTimer();
+};
+
+/** Times a single slice of a maintenance job, construct it once the locks of the slice are held */
+class CMaintenanceSliceTimer
+{
+private:
+    const std::string strJob;
+    const int64_t nTimeStart;
+
+public:
+    int nItems{0};
+
+    explicit CMaintenanceSliceTimer(const std::string& strJobIn);
+    ~CMaintenanceSliceTimer();
+};
+
+#endif // SYSCOIN_MAINTENANCE_H
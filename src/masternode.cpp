@@ -56,6 +56,10 @@ bool CMasternode::UpdateFromNewBroadcast(CMasternodeBroadcast& mnb, CConnman& co
 {
     if(mnb.sigTime <= sigTime && !mnb.fRecovery) return false;
 
+    // SYSCOIN
+    if(pubKeyMasternode != mnb.pubKeyMasternode) {
+        mnodeman.IncrementListEpoch();
+    }
     pubKeyMasternode = mnb.pubKeyMasternode;
     sigTime = mnb.sigTime;
     vchSig = mnb.vchSig;
@@ -347,7 +351,7 @@ void CMasternode::UpdateLastPaid(const CBlockIndex *pindex, int nMaxBlocksToScan
             mnpayments.mapMasternodeBlocks[BlockReading->nHeight].HasPayeeWithVotes(mnpayee, 2, payee))
         {
             CBlock block;
-			if (!ReadBlockFromDisk(block, BlockReading, Params().GetConsensus())) {
+			if (!ReadBlockFromCacheOrDisk(block, BlockReading, Params().GetConsensus())) {
 				if (BlockReading->pprev == NULL) { assert(BlockReading); break; }
 				BlockReading = BlockReading->pprev;
 				LogPrint(BCLog::MNPAYMENT, "CMasternode::UpdateLastPaidBlock -- Could not read block from disk\n");
@@ -8,6 +8,7 @@
 #include <clientversion.h>
 #include <init.h>
 #include <governance.h>
+#include <maintenance.h>
 #include <masternodepayments.h>
 #include <masternodesync.h>
 #include <masternodeman.h>
@@ -27,15 +28,6 @@ CMasternodeMan mnodeman;
 const std::string CMasternodeMan::SERIALIZATION_VERSION_STRING = "CMasternodeMan-Version-7";
 const int CMasternodeMan::LAST_PAID_SCAN_BLOCKS = 100;
 
-struct CompareLastPaidBlock
-{
-    bool operator()(const std::pair<int, const CMasternode*>& t1,
-                    const std::pair<int, const CMasternode*>& t2) const
-    {
-        return (t1.first != t2.first) ? (t1.first < t2.first) : (t1.second->outpoint < t2.second->outpoint);
-    }
-};
-
 struct CompareScoreMN
 {
     bool operator()(const std::pair<arith_uint256, const CMasternode*>& t1,
@@ -80,7 +72,9 @@ bool CMasternodeMan::Add(CMasternode &mn)
 
     LogPrint(BCLog::MN, "CMasternodeMan::Add -- Adding new Masternode: addr=%s, %i now\n", mn.addr.ToString(), size() + 1);
     mapMasternodes[mn.outpoint] = mn;
+    AddToPaymentQueue(mapMasternodes[mn.outpoint]);
     fMasternodesAdded = true;
+    IncrementListEpoch();
     return true;
 }
 
@@ -130,11 +124,25 @@ bool CMasternodeMan::PoSeBan(const COutPoint &outpoint)
 
 void CMasternodeMan::Check(bool fForce)
 {
-    LOCK2(cs_main, cs);
-    for (auto& mnpair : mapMasternodes) {
-        // NOTE: internally it checks only every MASTERNODE_CHECK_SECONDS seconds
-        // since the last time, so expect some MNs to skip this
-        mnpair.second.Check(fForce);
+    // walk the list in slices so cs_main is released between them
+    COutPoint outpointNext;
+    bool fFirst = true;
+    bool fDone = false;
+    while (!fDone) {
+        LOCK2(cs_main, cs);
+        CMaintenanceSliceTimer slice("mnodeman");
+        auto it = fFirst ? mapMasternodes.begin() : mapMasternodes.lower_bound(outpointNext);
+        fFirst = false;
+        for (; it != mapMasternodes.end() && slice.nItems < MAINTENANCE_SLICE_SIZE; ++it, ++slice.nItems) {
+            // NOTE: internally it checks only every MASTERNODE_CHECK_SECONDS seconds
+            // since the last time, so expect some MNs to skip this
+            it->second.Check(fForce);
+        }
+        if (it == mapMasternodes.end()) {
+            fDone = true;
+        } else {
+            outpointNext = it->first;
+        }
     }
 }
 
@@ -143,69 +151,84 @@ void CMasternodeMan::CheckAndRemove(CConnman& connman)
     if(!masternodeSync.IsMasternodeListSynced()) return;
     int64_t now = GetTime();
     LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove\n");
-    
+
+    Check();
     {
-        // Need LOCK2 here to ensure consistent locking order because code below locks cs_main
-        // in CheckMnbAndUpdateMasternodeList()
-        LOCK2(cs_main, cs);
-        Check();
         // Remove spent masternodes, prepare structures and make requests to reasure the state of inactive ones
         rank_pair_vec_t vecMasternodeRanks;
         // ask for up to MNB_RECOVERY_MAX_ASK_ENTRIES masternode entries at a time
         int nAskForMnbRecovery = MNB_RECOVERY_MAX_ASK_ENTRIES;
-        std::map<COutPoint, CMasternode>::iterator it = mapMasternodes.begin();
-        while (it != mapMasternodes.end()) {
-            CMasternodeBroadcast mnb = CMasternodeBroadcast(it->second);
-            const uint256 &hash = mnb.GetHash();
-            // If collateral was spent ...
-            if (it->second.IsOutpointSpent()) {
-                LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove -- Removing Masternode: %s  addr=%s  %i now\n", it->second.GetStateString(), it->second.addr.ToString(), size() - 1);
-
-                // erase all of the broadcasts we've seen from this txin, ...
-                mapSeenMasternodeBroadcast.erase(hash);
-                mWeAskedForMasternodeListEntry.erase(it->first);
-
-                // and finally remove it from the list
-                it->second.FlagGovernanceItemsAsDirty();
-                mapMasternodes.erase(it++);
-                fMasternodesRemoved = true;
-            } else {
-                bool fAsk = (nAskForMnbRecovery > 0) &&
-                            masternodeSync.IsSynced() &&
-                            it->second.IsNewStartRequired() &&
-                            !IsMnbRecoveryRequested(hash) &&
-                            !gArgs.IsArgSet("-connect");
-                if(fAsk) {
-                    // this mn is in a non-recoverable state and we haven't asked other nodes yet
-                    std::set<CService> setRequested;
-                    // calculate only once and only when it's needed
-                    if(vecMasternodeRanks.empty()) {
-                        int nRandomBlockHeight = GetRandInt(nCachedBlockHeight);
-                        GetMasternodeRanks(vecMasternodeRanks, nRandomBlockHeight);
-                    }
-                    bool fAskedForMnbRecovery = false;
-                    // ask first MNB_RECOVERY_QUORUM_TOTAL masternodes we can connect to and we haven't asked recently
-                    for(int i = 0; setRequested.size() < MNB_RECOVERY_QUORUM_TOTAL && i < (int)vecMasternodeRanks.size(); i++) {
-                        // avoid banning
-                        if(mWeAskedForMasternodeListEntry.count(it->first) && mWeAskedForMasternodeListEntry[it->first].count(vecMasternodeRanks[i].second.addr)) continue;
-                        // didn't ask recently, ok to ask now
-                        CService addr = vecMasternodeRanks[i].second.addr;
-                        setRequested.insert(addr);
-                        listScheduledMnbRequestConnections.push_back(std::make_pair(addr, hash));
-                        fAskedForMnbRecovery = true;
-                    }
-                    if(fAskedForMnbRecovery) {
-                        LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove -- Recovery initiated, masternode=%s\n", it->first.ToStringShort());
-                        nAskForMnbRecovery--;
+        COutPoint outpointNext;
+        bool fFirst = true;
+        bool fDone = false;
+        while (!fDone) {
+            // Need LOCK2 here to ensure consistent locking order because code below locks cs_main
+            // in CheckMnbAndUpdateMasternodeList()
+            LOCK2(cs_main, cs);
+            CMaintenanceSliceTimer slice("mnodeman");
+            std::map<COutPoint, CMasternode>::iterator it = fFirst ? mapMasternodes.begin() : mapMasternodes.lower_bound(outpointNext);
+            fFirst = false;
+            for (; it != mapMasternodes.end() && slice.nItems < MAINTENANCE_SLICE_SIZE; ++slice.nItems) {
+                CMasternodeBroadcast mnb = CMasternodeBroadcast(it->second);
+                const uint256 &hash = mnb.GetHash();
+                // If collateral was spent ...
+                if (it->second.IsOutpointSpent()) {
+                    LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove -- Removing Masternode: %s  addr=%s  %i now\n", it->second.GetStateString(), it->second.addr.ToString(), size() - 1);
+
+                    // erase all of the broadcasts we've seen from this txin, ...
+                    mapSeenMasternodeBroadcast.erase(hash);
+                    mWeAskedForMasternodeListEntry.erase(it->first);
+
+                    // and finally remove it from the list
+                    it->second.FlagGovernanceItemsAsDirty();
+                    RemoveFromPaymentQueue(it->second.GetLastPaidBlock(), it->first);
+                    mapMasternodes.erase(it++);
+                    fMasternodesRemoved = true;
+                    IncrementListEpoch();
+                } else {
+                    bool fAsk = (nAskForMnbRecovery > 0) &&
+                                masternodeSync.IsSynced() &&
+                                it->second.IsNewStartRequired() &&
+                                !IsMnbRecoveryRequested(hash) &&
+                                !gArgs.IsArgSet("-connect");
+                    if(fAsk) {
+                        // this mn is in a non-recoverable state and we haven't asked other nodes yet
+                        std::set<CService> setRequested;
+                        // calculate only once and only when it's needed
+                        if(vecMasternodeRanks.empty()) {
+                            int nRandomBlockHeight = GetRandInt(nCachedBlockHeight);
+                            GetMasternodeRanks(vecMasternodeRanks, nRandomBlockHeight);
+                        }
+                        bool fAskedForMnbRecovery = false;
+                        // ask first MNB_RECOVERY_QUORUM_TOTAL masternodes we can connect to and we haven't asked recently
+                        for(int i = 0; setRequested.size() < MNB_RECOVERY_QUORUM_TOTAL && i < (int)vecMasternodeRanks.size(); i++) {
+                            // avoid banning
+                            if(mWeAskedForMasternodeListEntry.count(it->first) && mWeAskedForMasternodeListEntry[it->first].count(vecMasternodeRanks[i].second.addr)) continue;
+                            // didn't ask recently, ok to ask now
+                            CService addr = vecMasternodeRanks[i].second.addr;
+                            setRequested.insert(addr);
+                            listScheduledMnbRequestConnections.push_back(std::make_pair(addr, hash));
+                            fAskedForMnbRecovery = true;
+                        }
+                        if(fAskedForMnbRecovery) {
+                            LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove -- Recovery initiated, masternode=%s\n", it->first.ToStringShort());
+                            nAskForMnbRecovery--;
+                        }
+                        // wait for mnb recovery replies for MNB_RECOVERY_WAIT_SECONDS seconds
+                        mMnbRecoveryRequests[hash] = std::make_pair(now + MNB_RECOVERY_WAIT_SECONDS, setRequested);
                     }
-                    // wait for mnb recovery replies for MNB_RECOVERY_WAIT_SECONDS seconds
-                    mMnbRecoveryRequests[hash] = std::make_pair(now + MNB_RECOVERY_WAIT_SECONDS, setRequested);
+                    ++it;
                 }
-                ++it;
+            }
+            if (it == mapMasternodes.end()) {
+                fDone = true;
+            } else {
+                outpointNext = it->first;
             }
         }
-    
-
+    }
+    {
+        LOCK2(cs_main, cs);
         // process replies for MASTERNODE_NEW_START_REQUIRED masternodes
         LogPrint(BCLog::MN, "CMasternodeMan::CheckAndRemove -- mMnbRecoveryGoodReplies size=%d\n", (int)mMnbRecoveryGoodReplies.size());
         std::map<uint256, std::vector<CMasternodeBroadcast> >::iterator itMnbReplies = mMnbRecoveryGoodReplies.begin();
@@ -324,6 +347,9 @@ void CMasternodeMan::Clear()
 {
     LOCK(cs);
     mapMasternodes.clear();
+    IncrementListEpoch();
+    setPaymentQueue.clear();
+    mapCollateralConfirmations.clear();
     mAskedUsForMasternodeList.clear();
     mWeAskedForMasternodeList.clear();
     mWeAskedForMasternodeListEntry.clear();
@@ -470,6 +496,41 @@ bool CMasternodeMan::GetNextMasternodeInQueueForPayment(bool fFilterSigTime, int
     return GetNextMasternodeInQueueForPayment(nCachedBlockHeight, fFilterSigTime, nCountRet, mnInfoRet);
 }
 
+void CMasternodeMan::AddToPaymentQueue(const CMasternode& mn)
+{
+    setPaymentQueue.insert(CPaymentQueueEntry(mn.GetLastPaidBlock(), mn.outpoint));
+}
+
+void CMasternodeMan::RemoveFromPaymentQueue(int nBlockLastPaid, const COutPoint& outpoint)
+{
+    setPaymentQueue.erase(CPaymentQueueEntry(nBlockLastPaid, outpoint));
+}
+
+void CMasternodeMan::UpdatePaymentQueue(int nOldBlockLastPaid, const CMasternode& mn)
+{
+    if (mn.GetLastPaidBlock() == nOldBlockLastPaid) return;
+    RemoveFromPaymentQueue(nOldBlockLastPaid, mn.outpoint);
+    AddToPaymentQueue(mn);
+}
+
+int CMasternodeMan::GetCollateralConfirmations(const COutPoint& outpoint)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+
+    const uint256 hashTip = ::ChainActive().Tip() ? ::ChainActive().Tip()->GetBlockHash() : uint256();
+    if (hashTip != hashCollateralConfirmationsTip) {
+        mapCollateralConfirmations.clear();
+        hashCollateralConfirmationsTip = hashTip;
+    }
+
+    auto it = mapCollateralConfirmations.find(outpoint);
+    if (it == mapCollateralConfirmations.end()) {
+        it = mapCollateralConfirmations.emplace(outpoint, GetUTXOConfirmations(outpoint)).first;
+    }
+    return it->second;
+}
+
 bool CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCountRet, masternode_info_t& mnInfoRet)
 {
     mnInfoRet = masternode_info_t();
@@ -483,62 +544,68 @@ bool CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool f
     // Need LOCK2 here to ensure consistent locking order because the GetBlockHash call below locks cs_main
     LOCK2(cs_main,cs);
 
-    std::vector<std::pair<int, const CMasternode*> > vecMasternodeLastPaid;
+    int nMnCount = CountMasternodes();
+
+    // Look at 1/10 of the oldest nodes (by last payment), calculate their scores and pay the best one
+    //  -- This doesn't look at who is being paid in the +8-10 blocks, allowing for double payments very rarely
+    //  -- 1/100 payments should be a double payment on mainnet - (1/(3000/10))*2
+    //  -- (chance per block * chances before IsScheduled will fire)
+    const size_t nTenthNetwork = std::max(nMnCount/10, 1);
+    const int nMinProtocol = mnpayments.GetMinMasternodePaymentsProto();
+    const int64_t nAdjustedTime = GetAdjustedTime();
+
+    std::set<CScript> setScheduledPayees;
+    mnpayments.GetScheduledPayees(nBlockHeight, setScheduledPayees);
+
+    std::vector<const CMasternode*> vecCandidates;
+    vecCandidates.reserve(nTenthNetwork);
 
     /*
-        Make a vector with all of the last paid times
+        Walk the queue from the oldest payment on, counting all eligible masternodes
     */
 
-    int nMnCount = CountMasternodes();
+    for (const auto& entry : setPaymentQueue) {
+        const auto it = mapMasternodes.find(entry.outpoint);
+        if (it == mapMasternodes.end()) continue;
+        const CMasternode& mn = it->second;
 
-    for (const auto& mnpair : mapMasternodes) {
-        if(!mnpair.second.IsValidForPayment()) continue;
+        if(!mn.IsValidForPayment()) continue;
 
         //check protocol version
-        if(mnpair.second.nProtocolVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
+        if(mn.nProtocolVersion < nMinProtocol) continue;
 
         //it's in the list (up to 8 entries ahead of current block to allow propagation) -- so let's skip it
-        if(mnpayments.IsScheduled(mnpair.second, nBlockHeight)) continue;
+        if(setScheduledPayees.count(GetScriptForDestination(PKHash(mn.pubKeyCollateralAddress)))) continue;
 
         //it's too new, wait for a cycle
-        if(fFilterSigTime && mnpair.second.sigTime + (nMnCount*4*60) > GetAdjustedTime()) continue;
+        if(fFilterSigTime && mn.sigTime + (nMnCount*4*60) > nAdjustedTime) continue;
 
         //make sure it has at least as many confirmations as there are masternodes
-        if(GetUTXOConfirmations(mnpair.first) < nMnCount) continue;
+        if(GetCollateralConfirmations(entry.outpoint) < nMnCount) continue;
 
-        vecMasternodeLastPaid.push_back(std::make_pair(mnpair.second.GetLastPaidBlock(), &mnpair.second));
+        if(vecCandidates.size() < nTenthNetwork) {
+            vecCandidates.push_back(&mn);
+        }
+        nCountRet++;
     }
 
-    nCountRet = (int)vecMasternodeLastPaid.size();
-
     //when the network is in the process of upgrading, don't penalize nodes that recently restarted
     if(fFilterSigTime && nCountRet < nMnCount/3)
         return GetNextMasternodeInQueueForPayment(nBlockHeight, false, nCountRet, mnInfoRet);
 
-    // Sort them low to high
-    sort(vecMasternodeLastPaid.begin(), vecMasternodeLastPaid.end(), CompareLastPaidBlock());
-
     uint256 blockHash;
     if(!GetBlockHash(blockHash, nBlockHeight - 101)) {
         LogPrint(BCLog::MN, "CMasternode::GetNextMasternodeInQueueForPayment -- ERROR: GetBlockHash() failed at nBlockHeight %d\n", nBlockHeight - 101);
         return false;
     }
-    // Look at 1/10 of the oldest nodes (by last payment), calculate their scores and pay the best one
-    //  -- This doesn't look at who is being paid in the +8-10 blocks, allowing for double payments very rarely
-    //  -- 1/100 payments should be a double payment on mainnet - (1/(3000/10))*2
-    //  -- (chance per block * chances before IsScheduled will fire)
-    int nTenthNetwork = nMnCount/10;
-    int nCountTenth = 0;
     arith_uint256 nHighest = 0;
     const CMasternode *pBestMasternode = NULL;
-    for (const auto& s : vecMasternodeLastPaid) {
-        arith_uint256 nScore = s.second->CalculateScore(blockHash);
+    for (const auto pmn : vecCandidates) {
+        arith_uint256 nScore = pmn->CalculateScore(blockHash);
         if(nScore > nHighest){
             nHighest = nScore;
-            pBestMasternode = s.second;
+            pBestMasternode = pmn;
         }
-        nCountTenth++;
-        if(nCountTenth >= nTenthNetwork) break;
     }
     if (pBestMasternode) {
         mnInfoRet = pBestMasternode->GetInfo();
@@ -1472,7 +1539,11 @@ bool CMasternodeMan::CheckMnbAndUpdateMasternodeList(CNode* pfrom, CMasternodeBr
     CMasternode* pmn = Find(mnb.outpoint);
     if(pmn) {
         const CMasternodeBroadcast &mnbOld = mapSeenMasternodeBroadcast[CMasternodeBroadcast(*pmn).GetHash()].second;
-        if(!mnb.Update(pmn, nDos, connman)) {
+        const int nOldBlockLastPaid = pmn->GetLastPaidBlock();
+        const bool fUpdated = mnb.Update(pmn, nDos, connman);
+        // SYSCOIN keep the payment queue in sync with whatever the overwrite touched
+        UpdatePaymentQueue(nOldBlockLastPaid, *pmn);
+        if(!fUpdated) {
             LogPrint(BCLog::MN, "CMasternodeMan::CheckMnbAndUpdateMasternodeList -- Update() failed, masternode=%s\n", mnb.outpoint.ToStringShort());
             return false;
         }
@@ -1525,7 +1596,10 @@ void CMasternodeMan::UpdateLastPaid(const CBlockIndex* pindex)
                             nCachedBlockHeight, nLastRunBlockHeight, nMaxBlocksToScanBack);
 
     for (auto& mnpair : mapMasternodes) {
+        const int nOldBlockLastPaid = mnpair.second.GetLastPaidBlock();
         mnpair.second.UpdateLastPaid(pindex, nMaxBlocksToScanBack);
+        // a new payment moves the masternode to the back of the queue
+        UpdatePaymentQueue(nOldBlockLastPaid, mnpair.second);
     }
 
     nLastRunBlockHeight = nCachedBlockHeight;
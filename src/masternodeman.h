@@ -9,9 +9,25 @@
 #include <masternode.h>
 #include <sync.h>
 
+#include <atomic>
+
 class CMasternodeMan;
 class CConnman;
 
+/** Position of a masternode in the payment queue, ordered by last paid block then outpoint */
+struct CPaymentQueueEntry
+{
+    int nBlockLastPaid;
+    COutPoint outpoint;
+
+    CPaymentQueueEntry(int nBlockLastPaidIn, const COutPoint& outpointIn) : nBlockLastPaid(nBlockLastPaidIn), outpoint(outpointIn) {}
+
+    bool operator<(const CPaymentQueueEntry& b) const
+    {
+        return (nBlockLastPaid != b.nBlockLastPaid) ? (nBlockLastPaid < b.nBlockLastPaid) : (outpoint < b.outpoint);
+    }
+};
+
 extern CMasternodeMan mnodeman;
 
 class CMasternodeMan
@@ -73,7 +89,16 @@ private:
     /// Set when masternodes are removed, cleared when CGovernanceManager is notified
     bool fMasternodesRemoved;
 
+    /// Bumped whenever a masternode is added, removed or changes its key
+    std::atomic<uint64_t> nListEpoch{1};
+
     std::vector<uint256> vecDirtyGovernanceObjectHashes;
+
+    // all masternodes ordered by last paid block, kept up to date as payments land
+    std::set<CPaymentQueueEntry> setPaymentQueue;
+    // collateral confirmations of masternodes looked up at hashCollateralConfirmationsTip
+    std::map<COutPoint, int> mapCollateralConfirmations;
+    uint256 hashCollateralConfirmationsTip;
     
     int64_t nLastSentinelPingTime;
 
@@ -86,6 +111,13 @@ private:
 
     void PushDsegInvs(CNode* pnode, const CMasternode& mn);
 
+    void AddToPaymentQueue(const CMasternode& mn);
+    void RemoveFromPaymentQueue(int nBlockLastPaid, const COutPoint& outpoint);
+    /// Move a masternode whose last paid block changed from nOldBlockLastPaid to its new place in the queue
+    void UpdatePaymentQueue(int nOldBlockLastPaid, const CMasternode& mn);
+    /// Collateral confirmations of a masternode, cached until the tip changes
+    int GetCollateralConfirmations(const COutPoint& outpoint);
+
 public:
     // Keep track of all broadcasts I've seen
     std::map<uint256, std::pair<int64_t, CMasternodeBroadcast> > mapSeenMasternodeBroadcast;
@@ -110,6 +142,13 @@ public:
         }
 
         READWRITE(mapMasternodes);
+        if(ser_action.ForRead()) {
+            setPaymentQueue.clear();
+            for (const auto& mnpair : mapMasternodes) {
+                AddToPaymentQueue(mnpair.second);
+            }
+            IncrementListEpoch();
+        }
         READWRITE(mAskedUsForMasternodeList);
         READWRITE(mWeAskedForMasternodeList);
         READWRITE(mWeAskedForMasternodeListEntry);
@@ -125,6 +164,10 @@ public:
     }
 
     CMasternodeMan();
+
+    /// Signatures checked against the masternode list stay valid as long as this doesn't change
+    uint64_t GetListEpoch() const { return nListEpoch; }
+    void IncrementListEpoch() { ++nListEpoch; }
     /// Find an entry
     CMasternode* Find(const COutPoint& outpoint);
     
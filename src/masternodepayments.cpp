@@ -6,6 +6,7 @@
 #include <activemasternode.h>
 #include <consensus/validation.h>
 #include <governanceclasses.h>
+#include <maintenance.h>
 #include <masternodepayments.h>
 #include <masternodesync.h>
 #include <masternodeman.h>
@@ -465,6 +466,21 @@ bool CMasternodePayments::IsScheduled(const masternode_info_t& mnInfo, int nNotB
     return false;
 }
 
+void CMasternodePayments::GetScheduledPayees(int nNotBlockHeight, std::set<CScript>& setPayeesRet) const
+{
+    LOCK(cs_mapMasternodeBlocks);
+
+    if(!masternodeSync.IsMasternodeListSynced()) return;
+
+    CScript payee;
+    for(int64_t h = nCachedBlockHeight; h <= nCachedBlockHeight + 8; h++){
+        if(h == nNotBlockHeight) continue;
+        if(GetBlockPayee(h, payee)) {
+            setPayeesRet.insert(payee);
+        }
+    }
+}
+
 bool CMasternodePayments::AddOrUpdatePaymentVote(const CMasternodePaymentVote& vote, CConnman& connman)
 {
     uint256 blockHash = uint256();
@@ -682,22 +698,35 @@ void CMasternodePayments::CheckAndRemove()
 {
     if(!masternodeSync.IsBlockchainSynced()) return;
 
-    LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
-
     int nLimit = GetStorageLimit();
 
-    std::map<uint256, CMasternodePaymentVote>::iterator it = mapMasternodePaymentVotes.begin();
-    while(it != mapMasternodePaymentVotes.end()) {
-        CMasternodePaymentVote vote = (*it).second;
-
-        if(nCachedBlockHeight - vote.nBlockHeight > nLimit) {
-            LogPrint(BCLog::MNPAYMENT, "CMasternodePayments::CheckAndRemove -- Removing old Masternode payment: nBlockHeight=%d\n", vote.nBlockHeight);
-            mapMasternodePaymentVotes.erase(it++);
-            mapMasternodeBlocks.erase(vote.nBlockHeight);
+    // walk the votes in slices so the vote maps are released between them
+    uint256 nHashNext;
+    bool fFirst = true;
+    bool fDone = false;
+    while (!fDone) {
+        LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
+        CMaintenanceSliceTimer slice("mnpayments");
+        std::map<uint256, CMasternodePaymentVote>::iterator it = fFirst ? mapMasternodePaymentVotes.begin() : mapMasternodePaymentVotes.lower_bound(nHashNext);
+        fFirst = false;
+        for (; it != mapMasternodePaymentVotes.end() && slice.nItems < MAINTENANCE_SLICE_SIZE; ++slice.nItems) {
+            const int nBlockHeight = it->second.nBlockHeight;
+
+            if(nCachedBlockHeight - nBlockHeight > nLimit) {
+                LogPrint(BCLog::MNPAYMENT, "CMasternodePayments::CheckAndRemove -- Removing old Masternode payment: nBlockHeight=%d\n", nBlockHeight);
+                mapMasternodePaymentVotes.erase(it++);
+                mapMasternodeBlocks.erase(nBlockHeight);
+            } else {
+                ++it;
+            }
+        }
+        if (it == mapMasternodePaymentVotes.end()) {
+            fDone = true;
         } else {
-            ++it;
+            nHashNext = it->first;
         }
     }
+    LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePaymentVotes);
     LogPrint(BCLog::MNPAYMENT, "CMasternodePayments::CheckAndRemove -- %s\n", ToString());
 }
 
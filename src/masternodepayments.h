@@ -212,6 +212,8 @@ public:
 	bool GetBlockPayee(int nBlockHeight, CScript& payee, int &nStartHeightBlock) const;
     bool IsTransactionValid(const CTransaction& txNew, int nBlockHeight, const CAmount& fee, CAmount& nTotalRewardWithMasternodes) const;
     bool IsScheduled(const masternode_info_t& mnInfo, int nNotBlockHeight) const;
+    /// Payees of all blocks IsScheduled looks at, to check many masternodes at once
+    void GetScheduledPayees(int nNotBlockHeight, std::set<CScript>& setPayeesRet) const;
 
     bool UpdateLastVote(const CMasternodePaymentVote& vote);
 
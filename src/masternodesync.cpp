@@ -26,6 +26,10 @@ void CMasternodeSync::Fail()
 
 void CMasternodeSync::Reset()
 {
+    {
+        LOCK(cs_progress);
+        mapProgress.clear();
+    }
     nRequestedMasternodeAssets = MASTERNODE_SYNC_INITIAL;
     nRequestedMasternodeAttempt = 0;
     nTimeAssetSyncStarted = GetTime();
@@ -69,20 +73,28 @@ void CMasternodeSync::SwitchToNextAsset(CConnman& connman)
         case(MASTERNODE_SYNC_WAITING):
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Completed %s in %llds\n", GetAssetName(), GetTime() - nTimeAssetSyncStarted);
             nRequestedMasternodeAssets = MASTERNODE_SYNC_LIST;
+            StartAsset(MASTERNODE_SYNC_LIST, mnodeman.size());
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Starting %s\n", GetAssetName());
             break;
         case(MASTERNODE_SYNC_LIST):
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Completed %s in %llds\n", GetAssetName(), GetTime() - nTimeAssetSyncStarted);
+            FinishAsset(MASTERNODE_SYNC_LIST);
             nRequestedMasternodeAssets = MASTERNODE_SYNC_MNW;
+            StartAsset(MASTERNODE_SYNC_MNW, mnpayments.GetVoteCount());
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Starting %s\n", GetAssetName());
             break;
         case(MASTERNODE_SYNC_MNW):
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Completed %s in %llds\n", GetAssetName(), GetTime() - nTimeAssetSyncStarted);
+            FinishAsset(MASTERNODE_SYNC_MNW);
             nRequestedMasternodeAssets = MASTERNODE_SYNC_GOVERNANCE;
+            StartAsset(MASTERNODE_SYNC_GOVOBJ, governance.GetObjectCount());
+            StartAsset(MASTERNODE_SYNC_GOVOBJ_VOTE, governance.GetVoteCount());
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Starting %s\n", GetAssetName());
             break;
         case(MASTERNODE_SYNC_GOVERNANCE):
             LogPrint(BCLog::MNSYNC, "CMasternodeSync::SwitchToNextAsset -- Completed %s in %llds\n", GetAssetName(), GetTime() - nTimeAssetSyncStarted);
+            FinishAsset(MASTERNODE_SYNC_GOVOBJ);
+            FinishAsset(MASTERNODE_SYNC_GOVOBJ_VOTE);
             nRequestedMasternodeAssets = MASTERNODE_SYNC_FINISHED;
             uiInterface.NotifyAdditionalDataSyncProgressChanged(1);
             //try to activate our masternode if possible
@@ -125,7 +137,198 @@ void CMasternodeSync::ProcessMessage(CNode* pfrom, const std::string& strCommand
         vRecv >> nItemID >> nCount;
 
         LogPrint(BCLog::MNSYNC, "SYNCSTATUSCOUNT -- got inventory count: nItemID=%d  nCount=%d  peer=%d\n", nItemID, nCount, pfrom->GetId());
+
+        // SYSCOIN the counts tell us how much data to expect, the idle time starts once a peer answered
+        LOCK(cs_progress);
+        auto it = mapProgress.find(nItemID);
+        if(it == mapProgress.end() || nCount < 0) return;
+        it->second.Announce(pfrom->GetId(), nCount, GetTime());
+    }
+}
+
+void CMasternodeSyncProgress::Start(int nCount, int64_t nNow)
+{
+    if(nTimeStarted != 0) return;
+    nTimeStarted = nNow;
+    nStartCount = nLastCount = nCount;
+    nTimeLastChange = nNow;
+}
+
+void CMasternodeSyncProgress::Update(int nCount, int64_t nNow)
+{
+    if(nCount != nLastCount) {
+        nLastCount = nCount;
+        nTimeLastChange = nNow;
+    }
+}
+
+void CMasternodeSyncProgress::Announce(NodeId nodeId, int nCount, int64_t nNow)
+{
+    nAnnounced += nCount;
+    // a peer answering again replaces its count, so it can't stand in for several peers
+    mapPeerCounts[nodeId] = nCount;
+    nTimeLastChange = nNow;
+}
+
+int CMasternodeSyncProgress::GetExpected() const
+{
+    // the median, so a single empty, lagging or lying peer can't end the asset early (or hold it up)
+    if((int)mapPeerCounts.size() < MASTERNODE_SYNC_PARALLEL_PEERS) return -1;
+    std::vector<int> vecCounts;
+    vecCounts.reserve(mapPeerCounts.size());
+    for (const auto& pair : mapPeerCounts) {
+        vecCounts.push_back(pair.second);
+    }
+    std::nth_element(vecCounts.begin(), vecCounts.begin() + vecCounts.size() / 2, vecCounts.end());
+    return vecCounts[vecCounts.size() / 2];
+}
+
+bool CMasternodeSyncProgress::IsAnnouncedReceived(int nCount) const
+{
+    const int nExpected = GetExpected();
+    return nExpected >= 0 && nCount >= nExpected;
+}
+
+bool CMasternodeSyncProgress::IsComplete(int nCount, bool fEnoughData, int64_t nNow)
+{
+    Update(nCount, nNow);
+    if(mapPeerCounts.empty()) return false;
+    return fEnoughData || nNow - nTimeLastChange > MASTERNODE_SYNC_IDLE_SECONDS;
+}
+
+UniValue CMasternodeSyncProgress::ToJSON(int64_t nNow) const
+{
+    const int64_t nElapsed = nTimeStarted == 0 ? 0 : (nTimeFinished != 0 ? nTimeFinished : nNow) - nTimeStarted;
+    const int nReceived = nLastCount - nStartCount;
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("started", nTimeStarted);
+    obj.pushKV("finished", nTimeFinished != 0);
+    obj.pushKV("elapsed", nElapsed);
+    obj.pushKV("peers_asked", nPeersAsked);
+    obj.pushKV("peers_answered", (int)mapPeerCounts.size());
+    obj.pushKV("announced", nAnnounced);
+    obj.pushKV("expected", GetExpected());
+    obj.pushKV("count", nLastCount);
+    obj.pushKV("received", nReceived);
+    obj.pushKV("rate", nElapsed > 0 ? double(nReceived) / nElapsed : 0.0);
+    return obj;
+}
+
+void CMasternodeSync::StartAsset(int nAsset, int nCount)
+{
+    LOCK(cs_progress);
+    mapProgress[nAsset].Start(nCount, GetTime());
+}
+
+void CMasternodeSync::FinishAsset(int nAsset)
+{
+    LOCK(cs_progress);
+    CMasternodeSyncProgress& progress = mapProgress[nAsset];
+    if(progress.nTimeStarted != 0 && progress.nTimeFinished == 0) {
+        progress.nTimeFinished = GetTime();
+    }
+}
+
+void CMasternodeSync::RequestAsset(int nAsset, const std::vector<CNode*>& vecPeers, int nCount, CConnman& connman)
+{
+    std::string strRequest;
+    int nMinProto;
+    switch(nAsset) {
+        case MASTERNODE_SYNC_LIST:   strRequest = "masternode-list-sync";    nMinProto = mnpayments.GetMinMasternodePaymentsProto(); break;
+        case MASTERNODE_SYNC_MNW:    strRequest = "masternodepayment-sync";  nMinProto = mnpayments.GetMinMasternodePaymentsProto(); break;
+        case MASTERNODE_SYNC_GOVOBJ: strRequest = "governancesync";          nMinProto = MIN_GOVERNANCE_PEER_PROTO_VERSION; break;
+        default: return;
+    }
+
+    StartAsset(nAsset, nCount);
+    for (const auto& pnode : vecPeers) {
+        {
+            LOCK(cs_progress);
+            if(mapProgress[nAsset].nPeersAsked >= MASTERNODE_SYNC_PARALLEL_PEERS) return;
+        }
+        // don't mark peers too old to answer, they are not asked and do not count as asked
+        if(pnode->nVersion < nMinProto) continue;
+        // only request once from each peer
+        if(netfulfilledman.HasFulfilledRequest(pnode->addr, strRequest)) continue;
+        netfulfilledman.AddFulfilledRequest(pnode->addr, strRequest);
+
+        {
+            LOCK(cs_progress);
+            mapProgress[nAsset].nPeersAsked++;
+        }
+        if(nAsset == nRequestedMasternodeAssets || (nAsset == MASTERNODE_SYNC_GOVOBJ && nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE)) {
+            nRequestedMasternodeAttempt++;
+        }
+        LogPrint(BCLog::MNSYNC, "CMasternodeSync::RequestAsset -- requesting %s from peer=%d\n", strRequest, pnode->GetId());
+
+        if(nAsset == MASTERNODE_SYNC_LIST) {
+            mnodeman.DsegUpdate(pnode, connman);
+        } else if(nAsset == MASTERNODE_SYNC_MNW) {
+            // ask node for all payment votes it has (new nodes will only return votes for future payments)
+            connman.PushMessage(pnode, CNetMsgMaker(pnode->GetSendVersion()).Make(NetMsgType::MASTERNODEPAYMENTSYNC));
+            // ask node for missing pieces only (old nodes will not be asked)
+            mnpayments.RequestLowDataPaymentBlocks(pnode, connman);
+        } else {
+            SendGovernanceSyncRequest(pnode, connman);
+        }
+    }
+}
+
+bool CMasternodeSync::IsAssetComplete(int nAsset, int nCount, bool fEnoughData, int64_t nNow)
+{
+    LOCK(cs_progress);
+    return mapProgress[nAsset].IsComplete(nCount, fEnoughData, nNow);
+}
+
+CMasternodeSyncProgress CMasternodeSync::GetAssetProgress(int nAsset) const
+{
+    LOCK(cs_progress);
+    const auto it = mapProgress.find(nAsset);
+    return it == mapProgress.end() ? CMasternodeSyncProgress() : it->second;
+}
+
+bool CMasternodeSync::IsAssetTimedOut(int nAsset, int64_t nNow)
+{
+    LOCK(cs_progress);
+    const CMasternodeSyncProgress& progress = mapProgress[nAsset];
+    return progress.nTimeStarted != 0 && nNow - progress.nTimeLastChange > MASTERNODE_SYNC_TIMEOUT_SECONDS;
+}
+
+UniValue CMasternodeSync::GetProgressJSON() const
+{
+    const int64_t nNow = GetTime();
+    UniValue obj(UniValue::VOBJ);
+    LOCK(cs_progress);
+    for (const auto& pair : mapProgress) {
+        std::string strName;
+        switch(pair.first) {
+            case MASTERNODE_SYNC_LIST:          strName = "list"; break;
+            case MASTERNODE_SYNC_MNW:           strName = "winners"; break;
+            case MASTERNODE_SYNC_GOVOBJ:        strName = "governance_objects"; break;
+            case MASTERNODE_SYNC_GOVOBJ_VOTE:   strName = "governance_votes"; break;
+            default: continue;
+        }
+        obj.pushKV(strName, pair.second.ToJSON(nNow));
+    }
+    return obj;
+}
+
+int CMasternodeSync::SyncGovernance(const std::vector<CNode*>& vecPeers, CConnman& connman)
+{
+    RequestAsset(MASTERNODE_SYNC_GOVOBJ, vecPeers, governance.GetObjectCount(), connman);
+
+    // request votes on per-obj basis from the peers we asked for the objects
+    std::vector<CNode*> vecGovernancePeers;
+    for (const auto& pnode : vecPeers) {
+        if(netfulfilledman.HasFulfilledRequest(pnode->addr, "governancesync")) {
+            vecGovernancePeers.push_back(pnode);
+        }
     }
+    if(vecGovernancePeers.empty()) {
+        return -1;
+    }
+    StartAsset(MASTERNODE_SYNC_GOVOBJ_VOTE, governance.GetVoteCount());
+    return governance.RequestGovernanceObjectVotes(vecGovernancePeers, connman);
 }
 
 void CMasternodeSync::ProcessTick(CConnman& connman)
@@ -156,6 +359,9 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
 
     // gradually request the rest of the votes after sync finished
     if(IsSynced()) {
+        static int64_t nTimeLastVotesRequest = 0;
+        if(nTimeLastProcess - nTimeLastVotesRequest < MASTERNODE_SYNC_VOTES_SECONDS) return;
+        nTimeLastVotesRequest = nTimeLastProcess;
         std::vector<CNode*> vNodesCopy = connman.CopyNodeVector(CConnman::FullyConnectedOnly);
         governance.RequestGovernanceObjectVotes(vNodesCopy, connman);
         connman.ReleaseNodeVector(vNodesCopy);
@@ -163,11 +369,13 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
     }
 
     // Calculate "progress" for LOG reporting / GUI notification
-    double nSyncProgress = double(nRequestedMasternodeAttempt + (nRequestedMasternodeAssets - 1) * 8) / (8*4);
+    double nSyncProgress = double(std::min(nRequestedMasternodeAttempt, 8) + (nRequestedMasternodeAssets - 1) * 8) / (8*4);
     LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nRequestedMasternodeAttempt %d nSyncProgress %f\n", nTick, nRequestedMasternodeAssets, nRequestedMasternodeAttempt, nSyncProgress);
     uiInterface.NotifyAdditionalDataSyncProgressChanged(nSyncProgress);
 
     std::vector<CNode*> vNodesCopy = connman.CopyNodeVector(CConnman::FullyConnectedOnly);
+    // SYSCOIN peers we can sync from, each asset is requested from several of them at once
+    std::vector<CNode*> vecPeers;
 
     for (auto& pnode : vNodesCopy)
     {
@@ -178,7 +386,7 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
         // Inbound connection this early is most likely a "masternode" connection
         // initiated from another node, so skip it too.
         // also skip syncing with nodes that are on an old unsupported version or something like bitcoinj which doesn't support these messages
-        if(pnode->nVersion < PROTOCOL_VERSION || pnode->fMasternode || (fMasternodeMode && pnode->fInbound)) continue;
+        if(pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto() || pnode->fMasternode || (fMasternodeMode && pnode->fInbound)) continue;
 
         // QUICK MODE (REGTEST ONLY!)
         if(Params().NetworkIDString() == CBaseChainParams::REGTEST)
@@ -198,199 +406,115 @@ void CMasternodeSync::ProcessTick(CConnman& connman)
         }
 
         // NORMAL NETWORK MODE - TESTNET/MAINNET
-        {
-            if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-sync")) {
-                // We already fully synced from this node recently,
-                // disconnect to free this connection slot for another peer.
-                pnode->fDisconnect = true;
-                LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- disconnecting from recently synced peer=%d\n", pnode->GetId());
-                continue;
-            }
+        if(netfulfilledman.HasFulfilledRequest(pnode->addr, "full-sync")) {
+            // We already fully synced from this node recently,
+            // disconnect to free this connection slot for another peer.
+            pnode->fDisconnect = true;
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- disconnecting from recently synced peer=%d\n", pnode->GetId());
+            continue;
+        }
 
-            // SPORK : ALWAYS ASK FOR SPORKS AS WE SYNC
+        // SPORK : ALWAYS ASK FOR SPORKS AS WE SYNC
 
-            if(!netfulfilledman.HasFulfilledRequest(pnode->addr, "spork-sync")) {
-                // always get sporks first, only request once from each peer
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "spork-sync");
-                // get current network sporks
-                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETSPORKS));
-                LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- requesting sporks from peer=%d\n", nTick, nRequestedMasternodeAssets, pnode->GetId());
-            }
+        if(!netfulfilledman.HasFulfilledRequest(pnode->addr, "spork-sync")) {
+            // always get sporks first, only request once from each peer
+            netfulfilledman.AddFulfilledRequest(pnode->addr, "spork-sync");
+            // get current network sporks
+            connman.PushMessage(pnode, msgMaker.Make(NetMsgType::GETSPORKS));
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- requesting sporks from peer=%d\n", nTick, nRequestedMasternodeAssets, pnode->GetId());
+        }
+        vecPeers.push_back(pnode);
+    }
 
-            // INITIAL TIMEOUT
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_WAITING) {
-                if(nTimeLastProcess - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    // At this point we know that:
-                    // a) there are peers (because we are looping on at least one of them);
-                    // b) we waited for at least MASTERNODE_SYNC_TIMEOUT_SECONDS since we reached
-                    //    the headers tip the last time (i.e. since we switched from
-                    //     MASTERNODE_SYNC_INITIAL to MASTERNODE_SYNC_WAITING and bumped time);
-                    // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
-                    //    for at least MASTERNODE_SYNC_TIMEOUT_SECONDS.
-                    // We must be at the tip already, let's move to the next asset.
-                    SwitchToNextAsset(connman);
-                }
-            }
+    if(vecPeers.empty()) {
+        connman.ReleaseNodeVector(vNodesCopy);
+        return;
+    }
 
-            // MNLIST : SYNC MASTERNODE LIST FROM OTHER CONNECTED CLIENTS
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
-                LogPrint(BCLog::MN, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld nTimeLastProcess %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, nTimeLastProcess, nTimeLastProcess - nTimeLastBumped);
-                // check for timeout first
-                if(nTimeLastProcess - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if (nRequestedMasternodeAttempt == 0) {
-                        LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
-                        // there is no way we can continue without masternode list, fail here and try later
-                        Fail();
-                        connman.ReleaseNodeVector(vNodesCopy);
-                        return;
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-	            // request from three peers max
-				if (nRequestedMasternodeAttempt > 2) {
-					connman.ReleaseNodeVector(vNodesCopy);
-					return;
-					
-				}
-                // only request once from each peer
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternode-list-sync")) continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "masternode-list-sync");
-
-                if (pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
-                nRequestedMasternodeAttempt++;
+    // INITIAL TIMEOUT
+
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_WAITING) {
+        if(nTimeLastProcess - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
+            // At this point we know that:
+            // a) there are peers (because we found at least one of them);
+            // b) we waited for at least MASTERNODE_SYNC_TIMEOUT_SECONDS since we reached
+            //    the headers tip the last time (i.e. since we switched from
+            //     MASTERNODE_SYNC_INITIAL to MASTERNODE_SYNC_WAITING and bumped time);
+            // c) there were no blocks (UpdatedBlockTip, NotifyHeaderTip) or headers (AcceptedBlockHeader)
+            //    for at least MASTERNODE_SYNC_TIMEOUT_SECONDS.
+            // We must be at the tip already, let's move to the next asset.
+            SwitchToNextAsset(connman);
+        }
+    }
 
-                mnodeman.DsegUpdate(pnode, connman);
+    // MNLIST : SYNC MASTERNODE LIST FROM OTHER CONNECTED CLIENTS
 
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
-            }
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_LIST) {
+        const int nCount = mnodeman.size();
+        RequestAsset(MASTERNODE_SYNC_LIST, vecPeers, nCount, connman);
+        bool fAnnouncedReceived;
+        {
+            LOCK(cs_progress);
+            fAnnouncedReceived = mapProgress[MASTERNODE_SYNC_LIST].IsAnnouncedReceived(nCount);
+        }
+        // done once we have as many masternodes as our peers announced or they stopped coming
+        if(IsAssetComplete(MASTERNODE_SYNC_LIST, nCount, fAnnouncedReceived, nTimeLastProcess)) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- found enough data\n", nTick, nRequestedMasternodeAssets);
+            SwitchToNextAsset(connman);
+        } else if(IsAssetTimedOut(MASTERNODE_SYNC_LIST, nTimeLastProcess)) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
+            // there is no way we can continue without masternode list, fail here and try later
+            Fail();
+            connman.ReleaseNodeVector(vNodesCopy);
+            return;
+        }
+    }
 
-            // MNW : SYNC MASTERNODE PAYMENT VOTES FROM OTHER CONNECTED CLIENTS
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
-                LogPrint(BCLog::MNPAYMENT, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld nTimeLastProcess %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, nTimeLastProcess, nTimeLastProcess - nTimeLastBumped);
-                // check for timeout first
-                // This might take a lot longer than MASTERNODE_SYNC_TIMEOUT_SECONDS due to new blocks,
-                // but that should be OK and it should timeout eventually.
-                if(nTimeLastProcess - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if (nRequestedMasternodeAttempt == 0) {
-                        LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
-                        // probably not a good idea to proceed without winner list
-                        Fail();
-                        connman.ReleaseNodeVector(vNodesCopy);
-                        return;
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // check for data
-                // if mnpayments already has enough blocks and votes, switch to the next asset
-                // try to fetch data from at least two peers though
-                if(nRequestedMasternodeAttempt > 1 && mnpayments.IsEnoughData()) {
-                    LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- found enough data\n", nTick, nRequestedMasternodeAssets);
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-				// request from three peers max
-				if (nRequestedMasternodeAttempt > 2) {
-					connman.ReleaseNodeVector(vNodesCopy);
-					return;
-
-				}
-
-                // only request once from each peer
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "masternodepayment-sync")) continue;
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "masternodepayment-sync");
-
-                if(pnode->nVersion < mnpayments.GetMinMasternodePaymentsProto()) continue;
-                nRequestedMasternodeAttempt++;
-
-                // ask node for all payment votes it has (new nodes will only return votes for future payments)
-                //sync payment votes
-                
-                connman.PushMessage(pnode, msgMaker.Make(NetMsgType::MASTERNODEPAYMENTSYNC));
-                
-                // ask node for missing pieces only (old nodes will not be asked)
-                mnpayments.RequestLowDataPaymentBlocks(pnode, connman);
-
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
-            }
+    // MNW : SYNC MASTERNODE PAYMENT VOTES FROM OTHER CONNECTED CLIENTS
 
-            // GOVOBJ : SYNC GOVERNANCE ITEMS FROM OUR PEERS
-
-            if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
-                LogPrint(BCLog::GOBJECT, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d nTimeLastBumped %lld nTimeLastProcess %lld diff %lld\n", nTick, nRequestedMasternodeAssets, nTimeLastBumped, nTimeLastProcess, nTimeLastProcess - nTimeLastBumped);
-
-                // check for timeout first
-                if(nTimeLastProcess - nTimeLastBumped > MASTERNODE_SYNC_TIMEOUT_SECONDS) {
-                    LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
-                    if(nRequestedMasternodeAttempt == 0) {
-                        LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- WARNING: failed to sync %s\n", GetAssetName());
-                        // it's kind of ok to skip this for now, hopefully we'll catch up later?
-                    }
-                    SwitchToNextAsset(connman);
-                    connman.ReleaseNodeVector(vNodesCopy);
-                    return;
-                }
-
-                // only request obj sync once from each peer, then request votes on per-obj basis
-                if(netfulfilledman.HasFulfilledRequest(pnode->addr, "governancesync")) {
-                    int nObjsLeftToAsk = governance.RequestGovernanceObjectVotes(pnode, connman);
-                    static int64_t nTimeNoObjectsLeft = 0;
-                    // check for data
-                    if(nObjsLeftToAsk == 0) {
-                        static int nLastTick = 0;
-                        static int nLastVotes = 0;
-                        if(nTimeNoObjectsLeft == 0) {
-                            // asked all objects for votes for the first time
-                            nTimeNoObjectsLeft = nTimeLastProcess;
-                        }
-                        // make sure the condition below is checked only once per tick
-                        if(nLastTick == nTick) continue;
-                        if(nTimeLastProcess - nTimeNoObjectsLeft > MASTERNODE_SYNC_TIMEOUT_SECONDS &&
-                            governance.GetVoteCount() - nLastVotes < std::max(int(0.0001 * nLastVotes), MASTERNODE_SYNC_TICK_SECONDS)
-                        ) {
-                            // We already asked for all objects, waited for MASTERNODE_SYNC_TIMEOUT_SECONDS
-                            // after that and less then 0.01% or MASTERNODE_SYNC_TICK_SECONDS
-                            // (i.e. 1 per second) votes were received during the last tick.
-                            // We can be pretty sure that we are done syncing.
-                            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- asked for all objects, nothing to do\n", nTick, nRequestedMasternodeAssets);
-                            // reset nTimeNoObjectsLeft to be able to use the same condition on resync
-                            nTimeNoObjectsLeft = 0;
-                            SwitchToNextAsset(connman);
-                            connman.ReleaseNodeVector(vNodesCopy);
-                            return;
-                        }
-                        nLastTick = nTick;
-                        nLastVotes = governance.GetVoteCount();
-                    }
-                    continue;
-                }
-                netfulfilledman.AddFulfilledRequest(pnode->addr, "governancesync");
-
-                if (pnode->nVersion < MIN_GOVERNANCE_PEER_PROTO_VERSION) continue;
-                nRequestedMasternodeAttempt++;
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_MNW) {
+        const int nCount = mnpayments.GetVoteCount();
+        RequestAsset(MASTERNODE_SYNC_MNW, vecPeers, nCount, connman);
+        // governance objects only need the masternode list, fetch them meanwhile
+        SyncGovernance(vecPeers, connman);
 
-                SendGovernanceSyncRequest(pnode, connman);
+        // This might take a lot longer than MASTERNODE_SYNC_TIMEOUT_SECONDS due to new blocks,
+        // but that should be OK and it should timeout eventually.
+        if(IsAssetComplete(MASTERNODE_SYNC_MNW, nCount, mnpayments.IsEnoughData(), nTimeLastProcess)) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- found enough data\n", nTick, nRequestedMasternodeAssets);
+            SwitchToNextAsset(connman);
+        } else if(IsAssetTimedOut(MASTERNODE_SYNC_MNW, nTimeLastProcess)) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- ERROR: failed to sync %s\n", GetAssetName());
+            // probably not a good idea to proceed without winner list
+            Fail();
+            connman.ReleaseNodeVector(vNodesCopy);
+            return;
+        }
+    }
 
-                connman.ReleaseNodeVector(vNodesCopy);
-                return; //this will cause each peer to get one request each six seconds for the various assets we need
-            }
+    // GOVOBJ : SYNC GOVERNANCE ITEMS FROM OUR PEERS
+
+    if(nRequestedMasternodeAssets == MASTERNODE_SYNC_GOVERNANCE) {
+        const int nObjsLeftToAsk = SyncGovernance(vecPeers, connman);
+
+        const int nObjCount = governance.GetObjectCount();
+        const int nVoteCount = governance.GetVoteCount();
+        // asked for the votes of every object (if there are any) and objects and votes stopped coming
+        const bool fObjectsDone = IsAssetComplete(MASTERNODE_SYNC_GOVOBJ, nObjCount, false, nTimeLastProcess);
+        // without objects no votes are requested, so no peer will ever answer for them
+        const bool fVotesDone = nObjsLeftToAsk == -2 || IsAssetComplete(MASTERNODE_SYNC_GOVOBJ_VOTE, nVoteCount, false, nTimeLastProcess);
+        if((nObjsLeftToAsk == 0 || nObjsLeftToAsk == -2) && fObjectsDone && fVotesDone) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- asked for all objects, nothing to do\n", nTick, nRequestedMasternodeAssets);
+            SwitchToNextAsset(connman);
+        } else if(IsAssetTimedOut(MASTERNODE_SYNC_GOVOBJ, nTimeLastProcess) && IsAssetTimedOut(MASTERNODE_SYNC_GOVOBJ_VOTE, nTimeLastProcess)) {
+            LogPrint(BCLog::MNSYNC, "CMasternodeSync::ProcessTick -- nTick %d nRequestedMasternodeAssets %d -- timeout\n", nTick, nRequestedMasternodeAssets);
+            // it's kind of ok to skip this for now, hopefully we'll catch up later?
+            SwitchToNextAsset(connman);
         }
     }
-    // looped through all nodes, release them
+
     connman.ReleaseNodeVector(vNodesCopy);
 }
 
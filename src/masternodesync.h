@@ -7,9 +7,12 @@
 
 #include <chain.h>
 #include <net.h>
+#include <sync.h>
 
 #include <univalue.h>
 
+#include <map>
+
 class CMasternodeSync;
 
 static const int MASTERNODE_SYNC_FAILED          = -1;
@@ -22,20 +25,60 @@ static const int MASTERNODE_SYNC_GOVOBJ          = 10;
 static const int MASTERNODE_SYNC_GOVOBJ_VOTE     = 11;
 static const int MASTERNODE_SYNC_FINISHED        = 999;
 
-static const int MASTERNODE_SYNC_TICK_SECONDS    = 30;
+static const int MASTERNODE_SYNC_TICK_SECONDS    = 6;
 static const int MASTERNODE_SYNC_TIMEOUT_SECONDS = 30; // our blocks are 1 minute so 30 seconds should be fine
+// SYSCOIN an asset a peer answered for is done once nothing new arrived for this long
+static const int MASTERNODE_SYNC_IDLE_SECONDS    = 2 * MASTERNODE_SYNC_TICK_SECONDS;
+// SYSCOIN how often the remaining governance votes are requested once synced
+static const int MASTERNODE_SYNC_VOTES_SECONDS   = 30;
 
 static const int MASTERNODE_SYNC_ENOUGH_PEERS    = 6;
+// SYSCOIN peers each asset is requested from at the same time
+static const int MASTERNODE_SYNC_PARALLEL_PEERS  = 3;
 
 extern CMasternodeSync masternodeSync;
 
+/** SYSCOIN What we asked our peers for one asset, what they announced and how much of it arrived */
+struct CMasternodeSyncProgress
+{
+    int64_t nTimeStarted{0};
+    int64_t nTimeFinished{0};
+    int nPeersAsked{0};
+    // sum of the counts announced by our peers and the last count of each of them
+    int nAnnounced{0};
+    std::map<NodeId, int> mapPeerCounts;
+    // items we had when the asset started and now, and when that last changed
+    int nStartCount{0};
+    int nLastCount{0};
+    int64_t nTimeLastChange{0};
+
+    void Start(int nCount, int64_t nNow);
+    void Update(int nCount, int64_t nNow);
+    void Announce(NodeId nodeId, int nCount, int64_t nNow);
+    /** Median of the counts announced by our peers once MASTERNODE_SYNC_PARALLEL_PEERS of them answered, -1 before */
+    int GetExpected() const;
+    /** We have at least as many items as GetExpected() */
+    bool IsAnnouncedReceived(int nCount) const;
+    /** A peer answered and either fEnoughData or nothing new arrived for MASTERNODE_SYNC_IDLE_SECONDS */
+    bool IsComplete(int nCount, bool fEnoughData, int64_t nNow);
+    UniValue ToJSON(int64_t nNow) const;
+};
+
 //
 // CMasternodeSync : Sync masternode assets in stages
 //
+// SYSCOIN the stages still unlock one after the other, but each of them is requested from several
+// peers at once and is done when the data announced by our peers arrived instead of after fixed
+// timeouts. Governance objects are fetched while the winners list is being synced.
+//
 
 class CMasternodeSync
 {
 private:
+    mutable Mutex cs_progress;
+    // SYSCOIN progress of MASTERNODE_SYNC_LIST, MASTERNODE_SYNC_MNW, MASTERNODE_SYNC_GOVOBJ and MASTERNODE_SYNC_GOVOBJ_VOTE
+    std::map<int, CMasternodeSyncProgress> mapProgress GUARDED_BY(cs_progress);
+
     // Keep track of current asset
     int nRequestedMasternodeAssets;
     // Count peers we've requested the asset from
@@ -50,9 +93,21 @@ private:
 
     void Fail();
 
+    /** No peer answered, or nothing arrived, for MASTERNODE_SYNC_TIMEOUT_SECONDS since the asset started */
+    bool IsAssetTimedOut(int nAsset, int64_t nNow);
+    void StartAsset(int nAsset, int nCount);
+    void FinishAsset(int nAsset);
+    /** Fetch governance objects and their votes, returns the objects left to ask votes for or -1 without peers */
+    int SyncGovernance(const std::vector<CNode*>& vecPeers, CConnman& connman);
+
 public:
     CMasternodeSync() { Reset(); }
 
+    /** Ask peers we haven't asked yet for nAsset until MASTERNODE_SYNC_PARALLEL_PEERS were asked */
+    void RequestAsset(int nAsset, const std::vector<CNode*>& vecPeers, int nCount, CConnman& connman);
+    /** See CMasternodeSyncProgress::IsComplete */
+    bool IsAssetComplete(int nAsset, int nCount, bool fEnoughData, int64_t nNow);
+    CMasternodeSyncProgress GetAssetProgress(int nAsset) const;
 
     void SendGovernanceSyncRequest(CNode* pnode, CConnman& connman);
 
@@ -68,6 +123,8 @@ public:
     int64_t GetAssetStartTime() { return nTimeAssetSyncStarted; }
     std::string GetAssetName();
     std::string GetSyncStatus();
+    /** Peers, announced and received counts and receive rates of each asset */
+    UniValue GetProgressJSON() const;
 
     void Reset();
     void SwitchToNextAsset(CConnman& connman);
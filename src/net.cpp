@@ -31,6 +31,10 @@
 #ifdef USE_POLL
 #include <poll.h>
 #endif
+// SYSCOIN
+#ifdef USE_EPOLL
+#include <sys/epoll.h>
+#endif
 
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
@@ -76,6 +80,11 @@ enum BindFlags {
 // The set of sockets cannot be modified while waiting
 // The sleep time needs to be small to avoid new sockets stalling
 static const uint64_t SELECT_TIMEOUT_MILLISECONDS = 50;
+// SYSCOIN
+/** Most socket events taken from epoll at once, the rest are returned by the next call */
+static const int EPOLL_MAX_EVENTS = 1024;
+/** Payload still to come below which a read goes through the socket read buffer instead of straight into the message */
+static const unsigned int MIN_DIRECT_RECV_SIZE = 16 * 1024;
 
 const std::string NET_MESSAGE_COMMAND_OTHER = "*other*";
 
@@ -583,20 +592,7 @@ bool CNode::ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete
         nBytes -= handled;
 
         if (m_deserializer->Complete()) {
-            // decompose a transport agnostic CNetMessage from the deserializer
-            CNetMessage msg = m_deserializer->GetMessage(Params().MessageStart(), nTimeMicros);
-
-            //store received bytes per message command
-            //to prevent a memory DOS, only allow valid commands
-            mapMsgCmdSize::iterator i = mapRecvBytesPerMsgCmd.find(msg.m_command);
-            if (i == mapRecvBytesPerMsgCmd.end())
-                i = mapRecvBytesPerMsgCmd.find(NET_MESSAGE_COMMAND_OTHER);
-            assert(i != mapRecvBytesPerMsgCmd.end());
-            i->second += msg.m_raw_message_size;
-
-            // push the message to the process queue,
-            vRecvMsg.push_back(std::move(msg));
-
+            QueueReceivedMessage(nTimeMicros);
             complete = true;
         }
     }
@@ -604,6 +600,36 @@ bool CNode::ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete
     return true;
 }
 
+void CNode::ReceiveMsgDirect(unsigned int nBytes, bool& complete)
+{
+    int64_t nTimeMicros = GetTimeMicros();
+    LOCK(cs_vRecv);
+    nLastRecv = nTimeMicros / 1000000;
+    nRecvBytes += nBytes;
+    m_deserializer->ReadDirect(nBytes);
+    complete = m_deserializer->Complete();
+    if (complete) {
+        QueueReceivedMessage(nTimeMicros);
+    }
+}
+
+void CNode::QueueReceivedMessage(int64_t nTimeMicros)
+{
+    // decompose a transport agnostic CNetMessage from the deserializer
+    CNetMessage msg = m_deserializer->GetMessage(Params().MessageStart(), nTimeMicros);
+
+    //store received bytes per message command
+    //to prevent a memory DOS, only allow valid commands
+    mapMsgCmdSize::iterator i = mapRecvBytesPerMsgCmd.find(msg.m_command);
+    if (i == mapRecvBytesPerMsgCmd.end())
+        i = mapRecvBytesPerMsgCmd.find(NET_MESSAGE_COMMAND_OTHER);
+    assert(i != mapRecvBytesPerMsgCmd.end());
+    i->second += msg.m_raw_message_size;
+
+    // push the message to the process queue,
+    vRecvMsg.push_back(std::move(msg));
+}
+
 void CNode::SetSendVersion(int nVersionIn)
 {
     // Send version may only be changed in the version message, and
@@ -658,6 +684,9 @@ int V1TransportDeserializer::readHeader(const char *pch, unsigned int nBytes)
 
     // switch state to reading message data
     in_data = true;
+    // SYSCOIN into a pooled buffer that fits the payload
+    recvbufferpool.Release(std::move(vRecv));
+    vRecv = recvbufferpool.Get(hdr.nMessageSize, hdrbuf.GetType(), hdrbuf.GetVersion());
 
     return nCopy;
 }
@@ -667,18 +696,50 @@ int V1TransportDeserializer::readData(const char *pch, unsigned int nBytes)
     unsigned int nRemaining = hdr.nMessageSize - nDataPos;
     unsigned int nCopy = std::min(nRemaining, nBytes);
 
-    if (vRecv.size() < nDataPos + nCopy) {
-        // Allocate up to 256 KiB ahead, but never more than the total message size.
-        vRecv.resize(std::min(hdr.nMessageSize, nDataPos + nCopy + 256 * 1024));
-    }
+    GrowBuffer(nDataPos + nCopy);
 
     hasher.Write((const unsigned char*)pch, nCopy);
     memcpy(&vRecv[nDataPos], pch, nCopy);
     nDataPos += nCopy;
+    // SYSCOIN
+    recvbufferpool.AddReceived(nCopy, false);
+    recvbufferpool.AddCopied(nCopy);
 
     return nCopy;
 }
 
+void V1TransportDeserializer::GrowBuffer(unsigned int nNeeded)
+{
+    if (vRecv.size() < nNeeded) {
+        // Allocate up to 256 KiB ahead, but never more than the total message size.
+        const unsigned int nSize = std::min(hdr.nMessageSize, nNeeded + 256 * 1024);
+        // SYSCOIN growing beyond the capacity moves what was received so far
+        if (nSize > vRecv.capacity()) {
+            recvbufferpool.AddCopied(vRecv.size());
+        }
+        vRecv.resize(nSize);
+    }
+}
+
+char* V1TransportDeserializer::GetDirectBuffer(unsigned int& nSize)
+{
+    nSize = 0;
+    if (!in_data || Complete()) {
+        return nullptr;
+    }
+    GrowBuffer(nDataPos + 1);
+    nSize = vRecv.size() - nDataPos;
+    return &vRecv[nDataPos];
+}
+
+void V1TransportDeserializer::ReadDirect(unsigned int nBytes)
+{
+    assert(in_data && nDataPos + nBytes <= vRecv.size());
+    hasher.Write((const unsigned char*)&vRecv[nDataPos], nBytes);
+    nDataPos += nBytes;
+    recvbufferpool.AddReceived(nBytes, true);
+}
+
 const uint256& V1TransportDeserializer::GetMessageHash() const
 {
     assert(Complete());
@@ -1052,9 +1113,7 @@ void CConnman::AcceptConnection(const ListenSocket& hListenSocket) {
     }
     // SYSCOIN
     if(fZMQNetworkStatus){
-        UniValue oNetworkStatus(UniValue::VOBJ);
-        oNetworkStatus.pushKV("connections", (int)GetNodeCount(CConnman::CONNECTIONS_ALL));
-        GetMainSignals().NotifySyscoinUpdate(oNetworkStatus.write().c_str(), "networkstatus");
+        NotifyNetworkStatus();
     } 
 
     // We received a new connection, harvest entropy from the time (and our peer count)
@@ -1172,6 +1231,54 @@ void CConnman::InactivityCheck(CNode *pnode)
     }
 }
 
+// SYSCOIN
+std::vector<SocketEventsMode> GetSupportedSocketEventsModeList()
+{
+    // select is only built where poll isn't used, IsSelectableSocket doesn't keep
+    // descriptors below FD_SETSIZE otherwise
+    return {
+#ifdef USE_POLL
+        SOCKETEVENTS_POLL,
+#else
+        SOCKETEVENTS_SELECT,
+#endif
+#ifdef USE_EPOLL
+        SOCKETEVENTS_EPOLL,
+#endif
+    };
+}
+
+bool SocketEventsModeFromString(const std::string& strMode, SocketEventsMode& mode)
+{
+    for (const SocketEventsMode supported : GetSupportedSocketEventsModeList()) {
+        if (strMode == SocketEventsModeToString(supported)) {
+            mode = supported;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string SocketEventsModeToString(SocketEventsMode mode)
+{
+    switch (mode) {
+    case SOCKETEVENTS_SELECT: return "select";
+    case SOCKETEVENTS_POLL: return "poll";
+    case SOCKETEVENTS_EPOLL: return "epoll";
+    } // no default case, so the compiler can warn about missing cases
+    assert(false);
+}
+
+std::string GetSupportedSocketEventsModes()
+{
+    std::string strModes;
+    for (const SocketEventsMode supported : GetSupportedSocketEventsModeList()) {
+        if (!strModes.empty()) strModes += ", ";
+        strModes += SocketEventsModeToString(supported);
+    }
+    return strModes;
+}
+
 bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     for (const ListenSocket& hListenSocket : vhListenSocket) {
@@ -1219,7 +1326,7 @@ bool CConnman::GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &s
 }
 
 #ifdef USE_POLL
-void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+void CConnman::SocketEventsPoll(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
     if (!GenerateSelectSet(recv_select_set, send_select_set, error_select_set)) {
@@ -1261,7 +1368,7 @@ void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_s
     }
 }
 #else
-void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+void CConnman::SocketEventsSelect(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
 {
     std::set<SOCKET> recv_select_set, send_select_set, error_select_set;
     if (!GenerateSelectSet(recv_select_set, send_select_set, error_select_set)) {
@@ -1336,6 +1443,112 @@ void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_s
 }
 #endif
 
+// SYSCOIN
+#ifdef USE_EPOLL
+bool CConnman::StartEpoll()
+{
+    epollfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollfd == -1) {
+        LogPrintf("epoll_create1 failed: %s\n", NetworkErrorString(WSAGetLastError()));
+        return false;
+    }
+    // listen sockets are level-triggered, one connection is accepted per call
+    for (const ListenSocket& hListenSocket : vhListenSocket) {
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.fd = hListenSocket.socket;
+        if (epoll_ctl(epollfd, EPOLL_CTL_ADD, hListenSocket.socket, &event) != 0) {
+            LogPrintf("epoll_ctl failed for listen socket: %s\n", NetworkErrorString(WSAGetLastError()));
+            StopEpoll();
+            return false;
+        }
+    }
+    return true;
+}
+
+void CConnman::StopEpoll()
+{
+    if (epollfd != -1) {
+        close(epollfd);
+        epollfd = -1;
+    }
+}
+
+void CConnman::SocketEventsEpoll(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+{
+    // Node sockets stay registered (edge-triggered) for as long as they are open, so only new ones and
+    // ones whose send queue turned empty or non-empty since the last call need a system call here.
+    // Like GenerateSelectSet, nodes with data to send wait for it to be drained before receiving more.
+    bool fPendingRecv = false;
+    {
+        LOCK(cs_vNodes);
+        for (CNode* pnode : vNodes) {
+            bool fWantSend;
+            {
+                LOCK(pnode->cs_vSend);
+                fWantSend = !pnode->vSendMsg.empty();
+            }
+
+            LOCK(pnode->cs_hSocket);
+            if (pnode->hSocket == INVALID_SOCKET)
+                continue;
+
+            if (!pnode->fEpollRegistered || fWantSend != pnode->fEpollSend) {
+                struct epoll_event event;
+                event.events = EPOLLIN | EPOLLRDHUP | EPOLLET | (fWantSend ? (uint32_t)EPOLLOUT : 0U);
+                event.data.fd = pnode->hSocket;
+                if (epoll_ctl(epollfd, pnode->fEpollRegistered ? EPOLL_CTL_MOD : EPOLL_CTL_ADD, pnode->hSocket, &event) != 0) {
+                    LogPrint(BCLog::NET, "epoll_ctl failed for peer=%d: %s\n", pnode->GetId(), NetworkErrorString(WSAGetLastError()));
+                    pnode->fDisconnect = true;
+                    continue;
+                }
+                pnode->fEpollRegistered = true;
+                pnode->fEpollSend = fWantSend;
+            }
+            fPendingRecv |= pnode->fSocketReadable && !pnode->fPauseRecv && !fWantSend;
+        }
+    }
+
+    // don't wait while some sockets still have data that was reported before
+    struct epoll_event events[EPOLL_MAX_EVENTS];
+    const int nEvents = epoll_wait(epollfd, events, EPOLL_MAX_EVENTS, fPendingRecv ? 0 : SELECT_TIMEOUT_MILLISECONDS);
+
+    if (interruptNet) return;
+
+    if (nEvents < 0) {
+        const int nErr = WSAGetLastError();
+        if (nErr != WSAEINTR) {
+            LogPrintf("socket epoll_wait error %s\n", NetworkErrorString(nErr));
+            interruptNet.sleep_for(std::chrono::milliseconds(SELECT_TIMEOUT_MILLISECONDS));
+        }
+        return;
+    }
+
+    for (int i = 0; i < nEvents; i++) {
+        const SOCKET hSocket = events[i].data.fd;
+        if (events[i].events & EPOLLIN)                         recv_set.insert(hSocket);
+        if (events[i].events & EPOLLOUT)                        send_set.insert(hSocket);
+        if (events[i].events & (EPOLLERR|EPOLLHUP|EPOLLRDHUP))  error_set.insert(hSocket);
+    }
+}
+#endif
+
+void CConnman::SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set)
+{
+    // SYSCOIN
+#ifdef USE_EPOLL
+    if (socketEventsMode == SOCKETEVENTS_EPOLL) {
+        SocketEventsEpoll(recv_set, send_set, error_set);
+        return;
+    }
+#endif
+#ifdef USE_POLL
+    SocketEventsPoll(recv_set, send_set, error_set);
+#else
+    SocketEventsSelect(recv_set, send_set, error_set);
+#endif
+}
+
 void CConnman::SocketHandler()
 {
     std::set<SOCKET> recv_set, send_set, error_set;
@@ -1383,22 +1596,45 @@ void CConnman::SocketHandler()
             sendSet = send_set.count(pnode->hSocket) > 0;
             errorSet = error_set.count(pnode->hSocket) > 0;
         }
+        // SYSCOIN edge-triggered epoll reports a socket as readable once, it is read from until it runs dry
+        if (socketEventsMode == SOCKETEVENTS_EPOLL) {
+            pnode->fSocketReadable |= recvSet;
+            recvSet = pnode->fSocketReadable && !pnode->fPauseRecv && !pnode->fEpollSend;
+        }
         if (recvSet || errorSet)
         {
             // typical socket buffer is 8K-64K
             char pchBuf[0x10000];
             int nBytes = 0;
+            // SYSCOIN the rest of a large payload is read straight into its message buffer
+            char* pchDirect = nullptr;
+            unsigned int nRequested = sizeof(pchBuf);
             {
                 LOCK(pnode->cs_hSocket);
                 if (pnode->hSocket == INVALID_SOCKET)
                     continue;
-                nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+                LOCK(pnode->cs_vRecv);
+                unsigned int nDirect = 0;
+                pchDirect = pnode->m_deserializer->GetDirectBuffer(nDirect);
+                if (nDirect >= MIN_DIRECT_RECV_SIZE) {
+                    nRequested = nDirect;
+                } else {
+                    pchDirect = nullptr;
+                }
+                nBytes = recv(pnode->hSocket, pchDirect ? pchDirect : pchBuf, nRequested, MSG_DONTWAIT);
+            }
+            // SYSCOIN a short read (or none) left nothing behind, epoll tells when more arrives
+            if (nBytes < (int)nRequested) {
+                pnode->fSocketReadable = false;
             }
             if (nBytes > 0)
             {
                 bool notify = false;
-                if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify))
+                if (pchDirect) {
+                    pnode->ReceiveMsgDirect(nBytes, notify);
+                } else if (!pnode->ReceiveMsgBytes(pchBuf, nBytes, notify)) {
                     pnode->CloseSocketDisconnect();
+                }
                 RecordBytesRecv(nBytes);
                 if (notify) {
                     size_t nSizeAdded = 0;
@@ -2076,12 +2312,20 @@ void CConnman::OpenNetworkConnection(const CAddress& addrConnect, bool fCountFai
     }
     // SYSCOIN
     if(fZMQNetworkStatus){
-        UniValue oNetworkStatus(UniValue::VOBJ);
-        oNetworkStatus.pushKV("connections", (int)GetNodeCount(CConnman::CONNECTIONS_ALL));
-        GetMainSignals().NotifySyscoinUpdate(oNetworkStatus.write().c_str(), "networkstatus");
+        NotifyNetworkStatus();
     } 
 }
 // SYSCOIN
+void CConnman::NotifyNetworkStatus()
+{
+    // only the latest connection count of a burst of connects is published
+    const int nConnections = (int)GetNodeCount(CConnman::CONNECTIONS_ALL);
+    GetMainSignals().NotifySyscoinUpdate("networkstatus", [nConnections]() -> std::string {
+        UniValue oNetworkStatus(UniValue::VOBJ);
+        oNetworkStatus.pushKV("connections", nConnections);
+        return oNetworkStatus.write();
+    }, true);
+}
 void CConnman::OpenMasternodeConnection(const CAddress &addrConnect) {
     // open as block relay + mn (no tx)
     OpenNetworkConnection(addrConnect, false, NULL, NULL, false, false, false, true, true);
@@ -2343,6 +2587,14 @@ bool CConnman::Start(CScheduler& scheduler, const Options& connOptions)
         return false;
     }
 
+    // SYSCOIN
+#ifdef USE_EPOLL
+    if (socketEventsMode == SOCKETEVENTS_EPOLL && !StartEpoll()) {
+        socketEventsMode = SOCKETEVENTS_POLL;
+    }
+#endif
+    LogPrintf("Using %s for socket events\n", SocketEventsModeToString(socketEventsMode));
+
     for (const auto& strDest : connOptions.vSeedNodes) {
         AddOneShot(strDest);
     }
@@ -2498,6 +2750,10 @@ void CConnman::Stop()
         if (hListenSocket.socket != INVALID_SOCKET)
             if (!CloseSocket(hListenSocket.socket))
                 LogPrintf("CloseSocket(hListenSocket) failed with error %s\n", NetworkErrorString(WSAGetLastError()));
+    // SYSCOIN
+#ifdef USE_EPOLL
+    StopEpoll();
+#endif
 
     // clean up some globals (to help leak detection)
     for (CNode *pnode : vNodes) {
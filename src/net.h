@@ -15,6 +15,7 @@
 #include <hash.h>
 #include <limitedmap.h>
 #include <netaddress.h>
+#include <netrecvpool.h>
 #include <net_permissions.h>
 #include <policy/feerate.h>
 #include <protocol.h>
@@ -98,6 +99,31 @@ static const bool DEFAULT_FORCEDNSSEED = false;
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
 
+// SYSCOIN
+/** How the socket handler waits for sockets to become ready */
+enum SocketEventsMode {
+    SOCKETEVENTS_SELECT,
+    SOCKETEVENTS_POLL,
+    SOCKETEVENTS_EPOLL,
+};
+
+/** Default for -socketevents, the most scalable mode this system has */
+#if defined(USE_EPOLL)
+static const SocketEventsMode DEFAULT_SOCKETEVENTS = SOCKETEVENTS_EPOLL;
+#elif defined(USE_POLL)
+static const SocketEventsMode DEFAULT_SOCKETEVENTS = SOCKETEVENTS_POLL;
+#else
+static const SocketEventsMode DEFAULT_SOCKETEVENTS = SOCKETEVENTS_SELECT;
+#endif
+
+/** The modes built into this binary: select or poll, and epoll where available */
+std::vector<SocketEventsMode> GetSupportedSocketEventsModeList();
+/** Parse a -socketevents mode, false if it is not in GetSupportedSocketEventsModeList() */
+bool SocketEventsModeFromString(const std::string& strMode, SocketEventsMode& mode);
+std::string SocketEventsModeToString(SocketEventsMode mode);
+/** Comma separated GetSupportedSocketEventsModeList(), as shown in the -socketevents help */
+std::string GetSupportedSocketEventsModes();
+
 typedef int64_t NodeId;
 
 struct AddedNodeInfo
@@ -165,6 +191,8 @@ public:
         std::vector<std::string> m_specified_outgoing;
         std::vector<std::string> m_added_nodes;
         std::vector<bool> m_asmap;
+        // SYSCOIN
+        SocketEventsMode socketEventsMode = DEFAULT_SOCKETEVENTS;
     };
 
     void Init(const Options& connOptions) {
@@ -183,6 +211,8 @@ public:
         nSendBufferMaxSize = connOptions.nSendBufferMaxSize;
         nReceiveFloodSize = connOptions.nReceiveFloodSize;
         m_peer_connect_timeout = connOptions.m_peer_connect_timeout;
+        // SYSCOIN
+        socketEventsMode = connOptions.socketEventsMode;
         {
             LOCK(cs_totalBytesSent);
             nMaxOutboundTimeframe = connOptions.nMaxOutboundTimeframe;
@@ -432,9 +462,22 @@ private:
     void AcceptConnection(const ListenSocket& hListenSocket);
     void DisconnectNodes();
     void NotifyNumConnectionsChanged();
+    // SYSCOIN
+    void NotifyNetworkStatus();
     void InactivityCheck(CNode *pnode);
     bool GenerateSelectSet(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
     void SocketEvents(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
+#ifdef USE_POLL
+    void SocketEventsPoll(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
+#else
+    void SocketEventsSelect(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
+#endif
+    // SYSCOIN
+#ifdef USE_EPOLL
+    bool StartEpoll();
+    void StopEpoll();
+    void SocketEventsEpoll(std::set<SOCKET> &recv_set, std::set<SOCKET> &send_set, std::set<SOCKET> &error_set);
+#endif
     void SocketHandler();
     void ThreadSocketHandler();
     void ThreadDNSAddressSeed();
@@ -485,6 +528,10 @@ private:
     std::vector<NetWhitelistPermissions> vWhitelistedRange;
 
     unsigned int nSendBufferMaxSize{0};
+    // SYSCOIN
+    SocketEventsMode socketEventsMode{DEFAULT_SOCKETEVENTS};
+    /** epoll instance the node and listen sockets stay registered with in SOCKETEVENTS_EPOLL mode */
+    int epollfd{-1};
     unsigned int nReceiveFloodSize{0};
 
     std::vector<ListenSocket> vhListenSocket;
@@ -711,6 +758,10 @@ public:
     std::string m_command;
 
     CNetMessage(CDataStream&& recv_in) : m_recv(std::move(recv_in)) {}
+    // SYSCOIN the payload buffer goes back to the receive buffer pool once the message is done with
+    CNetMessage(CNetMessage&&) = default;
+    CNetMessage& operator=(CNetMessage&&) = default;
+    ~CNetMessage() { recvbufferpool.Release(std::move(m_recv)); }
 
     void SetVersion(int nVersionIn)
     {
@@ -730,6 +781,10 @@ public:
     virtual void SetVersion(int version) = 0;
     // read and deserialize data
     virtual int Read(const char *data, unsigned int bytes) = 0;
+    // SYSCOIN room in the buffer for the rest of the payload being received, so it can be read into it directly
+    virtual char* GetDirectBuffer(unsigned int& nSize) = 0;
+    // SYSCOIN account for bytes read into the direct buffer
+    virtual void ReadDirect(unsigned int nBytes) = 0;
     // decomposes a message from the context
     virtual CNetMessage GetMessage(const CMessageHeader::MessageStartChars& message_start, int64_t time) = 0;
     virtual ~TransportDeserializer() {}
@@ -750,6 +805,8 @@ private:
     const uint256& GetMessageHash() const;
     int readHeader(const char *pch, unsigned int nBytes);
     int readData(const char *pch, unsigned int nBytes);
+    // SYSCOIN
+    void GrowBuffer(unsigned int nNeeded);
 
     void Reset() {
         vRecv.clear();
@@ -784,6 +841,9 @@ public:
         if (ret < 0) Reset();
         return ret;
     }
+    // SYSCOIN
+    char* GetDirectBuffer(unsigned int& nSize) override;
+    void ReadDirect(unsigned int nBytes) override;
     CNetMessage GetMessage(const CMessageHeader::MessageStartChars& message_start, int64_t time) override;
 };
 
@@ -868,6 +928,12 @@ public:
     const uint64_t nKeyedNetGroup;
     std::atomic_bool fPauseRecv{false};
     std::atomic_bool fPauseSend{false};
+    // SYSCOIN Edge-triggered epoll state, only used by the SocketHandler thread: whether the socket
+    // is registered, whether it is registered for sending, and whether it may still have data to
+    // read since epoll reported it as readable, which epoll won't do again until more data arrives.
+    bool fEpollRegistered{false};
+    bool fEpollSend{false};
+    bool fSocketReadable{false};
     // SYSCOIN If 'true' this node will be disconnected on CMasternodeMan::ProcessMasternodeConnections()
     bool fMasternode;
     CSemaphoreGrant grantMasternodeOutbound;
@@ -893,7 +959,7 @@ public:
     // There is no final sorting before sending, as they are always sent immediately
     // and in the order requested.
        // SYSCOIN List of non-tx/non-block inventory items
-    std::vector<CInv> vInventoryOtherToSend;
+    std::vector<CInv> vInventoryOtherToSend GUARDED_BY(cs_inventory);
     std::vector<uint256> vInventoryBlockToSend GUARDED_BY(cs_inventory);
     RecursiveMutex cs_inventory;
 
@@ -978,6 +1044,8 @@ private:
     int nSendVersion{0};
     NetPermissionFlags m_permissionFlags{ PF_NONE };
     std::list<CNetMessage> vRecvMsg;  // Used only by SocketHandler thread
+    // SYSCOIN move the message the deserializer completed to vRecvMsg
+    void QueueReceivedMessage(int64_t nTimeMicros) EXCLUSIVE_LOCKS_REQUIRED(cs_vRecv);
 
     mutable RecursiveMutex cs_addrName;
     std::string addrName GUARDED_BY(cs_addrName);
@@ -1006,6 +1074,8 @@ public:
     }
 
     bool ReceiveMsgBytes(const char *pch, unsigned int nBytes, bool& complete);
+    // SYSCOIN account for nBytes the socket handler read into the deserializer's direct buffer
+    void ReceiveMsgDirect(unsigned int nBytes, bool& complete);
 
     void SetRecvVersion(int nVersionIn)
     {
@@ -1076,8 +1146,13 @@ public:
             LOCK(cs_inventory);
             vInventoryBlockToSend.push_back(inv.hash);
         } else {
-            // SYSCOIN
+            // SYSCOIN skip what the peer announced or we sent it already
+            if (m_tx_relay != nullptr) {
+                LOCK(m_tx_relay->cs_tx_inventory);
+                if (m_tx_relay->filterInventoryKnown.contains(inv.hash)) return;
+            }
             LogPrint(BCLog::NET, "PushOtherInventory --  inv: %s peer=%d\n", inv.ToString(), id);
+            LOCK(cs_inventory);
             vInventoryOtherToSend.push_back(inv);
         } 
     }
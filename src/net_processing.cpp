@@ -34,6 +34,7 @@
 #include <masternodepayments.h>
 #include <masternodesync.h>
 #include <masternodeman.h>
+#include <services/txload.h>
 #include <typeinfo>
 
 #if defined(NDEBUG)
@@ -804,6 +805,8 @@ void PeerLogicValidation::InitializeNode(CNode *pnode) {
 
 void PeerLogicValidation::FinalizeNode(NodeId nodeid, bool& fUpdateConnectionTime) {
     fUpdateConnectionTime = false;
+    // SYSCOIN
+    governance.RemoveReconRequests(nodeid);
     LOCK(cs_main);
     CNodeState *state = State(nodeid);
     assert(state != nullptr);
@@ -4114,6 +4117,8 @@ bool PeerLogicValidation::SendMessages(CNode* pto)
                         if (pto->m_tx_relay->pfilter && !pto->m_tx_relay->pfilter->IsRelevantAndUpdate(*txinfo.tx)) continue;
                         // Send
                         vInv.push_back(CInv(MSG_TX, hash));
+                        // SYSCOIN
+                        g_txload_relay.InvPushed(hash);
                         nRelayedTransactions++;
                         {
                             // Expire old relay messages
@@ -4138,14 +4143,18 @@ bool PeerLogicValidation::SendMessages(CNode* pto)
             }
         }
         // SYSCOIN Send non-tx/non-block inventory items
-		for (const auto& inv : pto->vInventoryOtherToSend) {
-			vInv.emplace_back(inv);
-			if (vInv.size() == MAX_INV_SZ) {
-				connman->PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
-				vInv.clear();
-			}
-		}
-		pto->vInventoryOtherToSend.clear();
+        {
+            LOCK(pto->cs_inventory);
+            for (const auto& inv : pto->vInventoryOtherToSend) {
+                vInv.emplace_back(inv);
+                if (vInv.size() == MAX_INV_SZ) {
+                    connman->PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
+                    vInv.clear();
+                }
+                pto->AddInventoryKnown(inv);
+            }
+            pto->vInventoryOtherToSend.clear();
+        }
         if (!vInv.empty())
             connman->PushMessage(pto, msgMaker.Make(NetMsgType::INV, vInv));
 
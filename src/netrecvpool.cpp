@@ -0,0 +1,62 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <netrecvpool.h>
+
+#include <iterator>
+
+CNetRecvBufferPool recvbufferpool;
+
+CDataStream CNetRecvBufferPool::Get(size_t nSize, int nType, int nVersion)
+{
+    if (nSize > 0) {
+        LOCK(cs_pool);
+        if (!mapFree.empty()) {
+            auto it = mapFree.lower_bound(nSize);
+            if (it == mapFree.end()) {
+                it = std::prev(it);
+            }
+            CDataStream stream(std::move(it->second));
+            nFreeMemory -= it->first;
+            mapFree.erase(it);
+            nReused++;
+            stream.SetType(nType);
+            stream.SetVersion(nVersion);
+            return stream;
+        }
+        nAllocated++;
+    }
+    return CDataStream(nType, nVersion);
+}
+
+void CNetRecvBufferPool::Release(CDataStream&& stream)
+{
+    const size_t nCapacity = stream.capacity();
+    if (nCapacity == 0) {
+        return;
+    }
+    LOCK(cs_pool);
+    if (nFreeMemory + nCapacity > MAX_RECV_POOL_MEMORY) {
+        return;
+    }
+    stream.clear();
+    mapFree.emplace(nCapacity, std::move(stream));
+    nFreeMemory += nCapacity;
+}
+
+UniValue CNetRecvBufferPool::ToJSON() const
+{
+    UniValue obj(UniValue::VOBJ);
+    {
+        LOCK(cs_pool);
+        obj.pushKV("pooled", (uint64_t)mapFree.size());
+        obj.pushKV("usage", (uint64_t)nFreeMemory);
+        obj.pushKV("allocated", nAllocated);
+        obj.pushKV("reused", nReused);
+    }
+    obj.pushKV("received", nBytesReceived.load());
+    obj.pushKV("direct", nBytesDirect.load());
+    obj.pushKV("copied", nBytesCopied.load());
+    return obj;
+}
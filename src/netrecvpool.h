@@ -0,0 +1,62 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_NETRECVPOOL_H
+#define SYSCOIN_NETRECVPOOL_H
+
+#include <streams.h>
+#include <sync.h>
+#include <univalue.h>
+
+#include <atomic>
+#include <map>
+
+/** Memory (bytes) the receive buffers may hold on to while no message uses them */
+static const size_t MAX_RECV_POOL_MEMORY = 16 << 20;
+
+/**
+ * Pool of message receive buffers. A message payload is read into a buffer taken from here as soon
+ * as its header says how large it is, the buffer moves along with the message to processing and is
+ * given back once the message was handled. Blocks and bursts of governance objects then land in a
+ * buffer that already has the room instead of growing a new one piece by piece. The pool also counts
+ * the payload bytes received and how many of them had to be copied on the way.
+ */
+class CNetRecvBufferPool
+{
+private:
+    mutable Mutex cs_pool;
+    /** Free buffers by capacity */
+    std::multimap<size_t, CDataStream> mapFree GUARDED_BY(cs_pool);
+    size_t nFreeMemory GUARDED_BY(cs_pool){0};
+    uint64_t nAllocated GUARDED_BY(cs_pool){0};
+    uint64_t nReused GUARDED_BY(cs_pool){0};
+
+    std::atomic<uint64_t> nBytesReceived{0};
+    std::atomic<uint64_t> nBytesDirect{0};
+    std::atomic<uint64_t> nBytesCopied{0};
+
+public:
+    /** A buffer for a payload of nSize bytes: the smallest pooled one it fits in, else the largest, else a new one */
+    CDataStream Get(size_t nSize, int nType, int nVersion);
+
+    /** Give a buffer back, it is kept while the pool stays within MAX_RECV_POOL_MEMORY */
+    void Release(CDataStream&& stream);
+
+    /** Payload bytes received, fDirect if they were read straight into the message buffer */
+    void AddReceived(size_t nBytes, bool fDirect)
+    {
+        nBytesReceived += nBytes;
+        if (fDirect) nBytesDirect += nBytes;
+    }
+
+    /** Payload bytes copied from the socket read buffer or into a grown buffer */
+    void AddCopied(size_t nBytes) { nBytesCopied += nBytes; }
+
+    /** Pooled buffers and memory, buffers allocated and reused, and the bytes received and copied */
+    UniValue ToJSON() const;
+};
+
+extern CNetRecvBufferPool recvbufferpool;
+
+#endif // SYSCOIN_NETRECVPOOL_H
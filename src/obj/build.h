@@ -0,0 +1 @@
+#define BUILD_SUFFIX c26d07f-dirty
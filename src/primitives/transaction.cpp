@@ -92,6 +92,7 @@ CTransaction& CTransaction::operator=(const CTransaction &tx) {
     *const_cast<unsigned int*>(&nLockTime) = tx.nLockTime;
     *const_cast<uint256*>(&hash) = tx.hash;
     *const_cast<uint256*>(&m_witness_hash) = tx.m_witness_hash;
+    std::atomic_store(&m_syscoin_payload, std::atomic_load(&tx.m_syscoin_payload));
     return *this;
 }
 CAmount CTransaction::GetValueOut() const
@@ -12,6 +12,11 @@
 #include <serialize.h>
 #include <uint256.h>
 
+#include <memory>
+
+// SYSCOIN
+class CSyscoinPayload;
+
 static const int SERIALIZE_TRANSACTION_NO_WITNESS = 0x40000000;
 
 /** An outpoint - a combination of a transaction hash and an index n into its vout */
@@ -297,6 +302,8 @@ private:
     /** Memory only. */
     const uint256 hash;
     const uint256 m_witness_hash;
+    // SYSCOIN parsed Syscoin payload, filled in on first use by GetSyscoinPayload()
+    mutable std::shared_ptr<const CSyscoinPayload> m_syscoin_payload;
 
     uint256 ComputeHash() const;
     uint256 ComputeWitnessHash() const;
@@ -366,6 +373,7 @@ public:
     }
     // SYSCOIN
     CTransaction& operator=(const CTransaction& tx);
+    friend std::shared_ptr<const CSyscoinPayload> GetSyscoinPayload(const CTransaction& tx);
 };
 
 /** A mutable version of CTransaction. */
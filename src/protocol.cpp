@@ -52,6 +52,8 @@ const char *SYNCSTATUSCOUNT="ssc";
 const char *MNGOVERNANCESYNC="govsync";
 const char *MNGOVERNANCEOBJECT="govobj";
 const char *MNGOVERNANCEOBJECTVOTE="govobjvote";
+const char *MNGOVERNANCERECON="govrecon";
+const char *MNGOVERNANCERECONFAIL="govreconfail";
 const char *MNVERIFY="mnv";
 } // namespace NetMsgType
 
@@ -97,6 +99,8 @@ const static std::string allNetMessageTypes[] = {
     NetMsgType::MNGOVERNANCEOBJECT,
     NetMsgType::MNGOVERNANCESYNC,
     NetMsgType::MNGOVERNANCEOBJECTVOTE,
+    NetMsgType::MNGOVERNANCERECON,
+    NetMsgType::MNGOVERNANCERECONFAIL,
     NetMsgType::MNVERIFY,   
 };
 const static std::vector<std::string> allNetMessageTypesVec(allNetMessageTypes, allNetMessageTypes+ARRAYLEN(allNetMessageTypes));
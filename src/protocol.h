@@ -244,6 +244,13 @@ extern const char *SYNCSTATUSCOUNT;
 extern const char *MNGOVERNANCESYNC;
 extern const char *MNGOVERNANCEOBJECT;
 extern const char *MNGOVERNANCEOBJECTVOTE;
+/**
+ * SYSCOIN The govrecon message carries a sketch of the votes we have for a governance object, the
+ * peer answers with inv messages for the votes we are missing or with govreconfail if the sketch
+ * was too small to find them.
+ */
+extern const char *MNGOVERNANCERECON;
+extern const char *MNGOVERNANCERECONFAIL;
 extern const char *MNVERIFY;
 };
 
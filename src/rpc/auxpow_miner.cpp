@@ -7,16 +7,21 @@
 #include <arith_uint256.h>
 #include <auxpow.h>
 #include <chainparams.h>
+#include <consensus/consensus.h>
+#include <core_memusage.h>
 #include <net.h>
 #include <node/context.h>
 #include <rpc/blockchain.h>
 #include <rpc/protocol.h>
 #include <rpc/request.h>
 #include <util/strencodings.h>
+#include <util/system.h>
 #include <util/time.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <cassert>
+#include <functional>
 #include <util/check.h>
 namespace
 {
@@ -50,16 +55,92 @@ void auxMiningCheck()
 
 }  // anonymous namespace
 
+const CBlock*
+AuxpowMiner::addBlock (std::unique_ptr<CBlockTemplate> newBlock,
+                       const CScriptID& scriptID,
+                       const CBlockIndex* pindexTip, const int64_t buildMicros)
+{
+  AssertLockHeld (cs);
+  AssertLockHeld (cs_main);
+
+  if (pindexPrev != pindexTip)
+    {
+      /* Clear old blocks since they're obsolete now.  */
+      blocks.clear ();
+      templates.clear ();
+      curBlocks.clear ();
+      templateMemory = 0;
+    }
+  pindexPrev = pindexTip;
+
+  /* Finalise it by setting the version and building the merkle root.  */
+  IncrementExtraNonce (&newBlock->block, pindexPrev, extraNonce);
+  newBlock->block.SetAuxpowVersion (true);
+
+  /* Save in our map of constructed blocks.  */
+  const CBlock* pblock = &newBlock->block;
+  curBlocks[scriptID] = pblock;
+  blocks[pblock->GetHash ()] = pblock;
+
+  SavedTemplate saved;
+  saved.memory = sizeof (CBlockTemplate) + RecursiveDynamicUsage (*pblock)
+                  + memusage::DynamicUsage (newBlock->vTxFees)
+                  + memusage::DynamicUsage (newBlock->vTxSigOpsCost)
+                  + memusage::DynamicUsage (newBlock->vchCoinbaseCommitment);
+  saved.created = GetTime ();
+  saved.tmpl = std::move (newBlock);
+  templateMemory += saved.memory;
+  templates.push_back (std::move (saved));
+
+  /* Enforce the memory cap by dropping the oldest blocks, but always keep the
+     one just constructed.  Miners still working on a dropped block can no
+     longer submit it.  */
+  while (templateMemory > maxTemplateMemory && templates.size () > 1)
+    {
+      const CBlock* pblockOld = &templates.front ().tmpl->block;
+      for (auto it = curBlocks.begin (); it != curBlocks.end (); ++it)
+        if (it->second == pblockOld)
+          {
+            curBlocks.erase (it);
+            break;
+          }
+      blocks.erase (pblockOld->GetHash ());
+      templateMemory -= templates.front ().memory;
+      templates.pop_front ();
+    }
+
+  lastBuildMicros = buildMicros;
+  maxBuildMicros = std::max (maxBuildMicros, buildMicros);
+  totalBuildMicros += buildMicros;
+
+  return pblock;
+}
+
 const CBlock*
 AuxpowMiner::getCurrentBlock (const CTxMemPool& mempool,
                               const CScript& scriptPubKey, uint256& target)
 {
   AssertLockHeld (cs);
   const CBlock* pblockCur = nullptr;
+  const CScriptID scriptID (scriptPubKey);
+
+  /* Remember the payout script so that its blocks are built in the
+     background from now on, forgetting the least recently used one if
+     there are too many.  */
+  auto& registered = registeredScripts[scriptID];
+  registered.first = scriptPubKey;
+  registered.second = GetTime ();
+  if (registeredScripts.size () > MAX_REGISTERED_SCRIPTS)
+    registeredScripts.erase (std::min_element (
+        registeredScripts.begin (), registeredScripts.end (),
+        [] (const std::pair<const CScriptID, std::pair<CScript, int64_t>>& a,
+            const std::pair<const CScriptID, std::pair<CScript, int64_t>>& b)
+          {
+            return a.second.second < b.second.second;
+          }));
 
   {
     LOCK (cs_main);
-    CScriptID scriptID (scriptPubKey);
     auto iter = curBlocks.find(scriptID);
     if (iter != curBlocks.end())
       pblockCur = iter->second;
@@ -67,17 +148,10 @@ AuxpowMiner::getCurrentBlock (const CTxMemPool& mempool,
     if (pblockCur == nullptr
         || pindexPrev != ::ChainActive ().Tip ()
         || (mempool.GetTransactionsUpdated () != txUpdatedLast
-            && GetTime () - startTime > 60))
+            && GetTime () - startTime > BLOCK_REFRESH_SECONDS))
       {
-        if (pindexPrev != ::ChainActive ().Tip ())
-          {
-            /* Clear old blocks since they're obsolete now.  */
-            blocks.clear ();
-            templates.clear ();
-            curBlocks.clear ();
-          }
-
         /* Create new block with nonce = 0 and extraNonce = 1.  */
+        const int64_t buildStart = GetTimeMicros ();
         std::unique_ptr<CBlockTemplate> newBlock
             = BlockAssembler (mempool, Params ()).CreateNewBlock (scriptPubKey);
         if (newBlock == nullptr)
@@ -85,20 +159,17 @@ AuxpowMiner::getCurrentBlock (const CTxMemPool& mempool,
 
         /* Update state only when CreateNewBlock succeeded.  */
         txUpdatedLast = mempool.GetTransactionsUpdated ();
-        pindexPrev = ::ChainActive ().Tip ();
         startTime = GetTime ();
 
-        /* Finalise it by setting the version and building the merkle root.  */
-        IncrementExtraNonce (&newBlock->block, pindexPrev, extraNonce);
-        newBlock->block.SetAuxpowVersion (true);
-
-        /* Save in our map of constructed blocks.  */
-        pblockCur = &newBlock->block;
-        curBlocks.emplace(scriptID, pblockCur);
-        blocks[pblockCur->GetHash ()] = pblockCur;
-        templates.push_back (std::move (newBlock));
+        pblockCur = addBlock (std::move (newBlock), scriptID,
+                              ::ChainActive ().Tip (),
+                              GetTimeMicros () - buildStart);
+        ++numBuiltOnDemand;
       }
+    else
+      ++numServedPrebuilt;
   }
+  ++numServed;
 
   /* At this point, pblockCur is always initialised:  If we make it here
      without creating a new block above, it means that, in particular,
@@ -132,6 +203,202 @@ AuxpowMiner::lookupSavedBlock (const std::string& hashHex) const
   return iter->second;
 }
 
+void
+AuxpowMiner::buildBackgroundBlocks (const bool emptyFirst)
+{
+  std::vector<std::pair<CScriptID, CScript>> scripts;
+  const CTxMemPool* mempool;
+  {
+    LOCK (cs);
+    mempool = backgroundMempool;
+    const int64_t now = GetTime ();
+    for (auto it = registeredScripts.begin (); it != registeredScripts.end (); )
+      if (now - it->second.second > REGISTERED_SCRIPT_EXPIRY)
+        it = registeredScripts.erase (it);
+      else
+        {
+          scripts.emplace_back (it->first, it->second.first);
+          ++it;
+        }
+  }
+  if (mempool == nullptr || scripts.empty ())
+    return;
+
+  /* Empty blocks only need the coinbase, so they are ready for the miners
+     right after a new tip without waiting for the mempool to be sorted
+     through.  No package fits into the minimum weight, and the fee rate
+     makes the assembler stop at the first one.  */
+  BlockAssembler::Options emptyOptions;
+  emptyOptions.nBlockMaxWeight = 0;
+  emptyOptions.blockMinFeeRate = CFeeRate (MAX_MONEY / MAX_BLOCK_WEIGHT);
+
+  for (int pass = emptyFirst ? 0 : 1; pass < 2; ++pass)
+    for (const auto& script : scripts)
+      {
+        const bool empty = (pass == 0);
+        const unsigned txUpdated = mempool->GetTransactionsUpdated ();
+        const int64_t buildStart = GetTimeMicros ();
+        std::unique_ptr<CBlockTemplate> newBlock;
+        try
+          {
+            newBlock = (empty ? BlockAssembler (*mempool, Params (), emptyOptions)
+                              : BlockAssembler (*mempool, Params ()))
+                          .CreateNewBlock (script.second);
+          }
+        catch (const std::exception& e)
+          {
+            /* The same is thrown to createauxblock, which builds the block
+               on demand once it can be built again.  */
+            LogPrintf ("%s: failed to build block: %s\n", __func__, e.what ());
+            LOCK (cs);
+            lastFailedBuild = GetTime ();
+            continue;
+          }
+        if (newBlock == nullptr)
+          return;
+
+        LOCK2 (cs, cs_main);
+        /* If the tip moved on while the block was assembled, the signal for
+           the new tip builds on it.  */
+        const CBlockIndex* pindexTip = ::ChainActive ().Tip ();
+        if (newBlock->block.hashPrevBlock != pindexTip->GetBlockHash ())
+          return;
+
+        addBlock (std::move (newBlock), script.first, pindexTip,
+                  GetTimeMicros () - buildStart);
+        ++numBuiltBackground;
+        startTime = GetTime ();
+        if (!empty)
+          txUpdatedLast = txUpdated;
+      }
+}
+
+void
+AuxpowMiner::UpdatedBlockTip (const CBlockIndex* pindexNew,
+                              const CBlockIndex* pindexFork,
+                              const bool fInitialDownload)
+{
+  if (fInitialDownload)
+    return;
+  signalBackgroundBuild (true);
+}
+
+void
+AuxpowMiner::TransactionAddedToMempool (const CTransactionRef& ptx,
+                                        const bool fBlock)
+{
+  {
+    LOCK (cs);
+    if (backgroundMempool == nullptr || registeredScripts.empty ()
+          || pindexPrev == nullptr
+          || backgroundMempool->GetTransactionsUpdated () == txUpdatedLast
+          || GetTime () - startTime <= BLOCK_REFRESH_SECONDS
+          || GetTime () - lastFailedBuild <= BLOCK_REFRESH_SECONDS)
+      return;
+  }
+  signalBackgroundBuild (false);
+}
+
+void
+AuxpowMiner::signalBackgroundBuild (const bool emptyFirst)
+{
+  {
+    LOCK (csWorker);
+    buildPending = true;
+    buildEmptyFirst |= emptyFirst;
+  }
+  condWorker.notify_one ();
+}
+
+void
+AuxpowMiner::threadBackgroundBlocks ()
+{
+  while (true)
+    {
+      bool emptyFirst;
+      {
+        WAIT_LOCK (csWorker, lock);
+        while (!buildPending && !stopWorker)
+          condWorker.wait (lock);
+        if (stopWorker)
+          return;
+        emptyFirst = buildEmptyFirst;
+        buildPending = false;
+        buildEmptyFirst = false;
+      }
+      buildBackgroundBlocks (emptyFirst);
+    }
+}
+
+void
+AuxpowMiner::startBackgroundBlocks (const CTxMemPool& mempool,
+                                    const size_t maxMemory)
+{
+  {
+    LOCK (cs);
+    backgroundMempool = &mempool;
+    maxTemplateMemory = maxMemory;
+  }
+  {
+    LOCK (csWorker);
+    stopWorker = false;
+  }
+  workerThread = std::thread (&TraceThread<std::function<void ()>>,
+                              "auxpowbuild",
+                              std::function<void ()> (std::bind (
+                                  &AuxpowMiner::threadBackgroundBlocks, this)));
+  RegisterValidationInterface (this);
+}
+
+void
+AuxpowMiner::stopBackgroundBlocks ()
+{
+  {
+    LOCK (cs);
+    if (backgroundMempool == nullptr)
+      return;
+    backgroundMempool = nullptr;
+  }
+  UnregisterValidationInterface (this);
+  SyncWithValidationInterfaceQueue ();
+  {
+    LOCK (csWorker);
+    stopWorker = true;
+  }
+  condWorker.notify_all ();
+  workerThread.join ();
+}
+
+UniValue
+AuxpowMiner::getTemplateInfo () const
+{
+  LOCK (cs);
+  const int64_t now = GetTime ();
+  const uint64_t numBuilt = numBuiltBackground + numBuiltOnDemand;
+
+  UniValue result(UniValue::VOBJ);
+  result.pushKV ("background", backgroundMempool != nullptr);
+  result.pushKV ("scripts", static_cast<uint64_t> (registeredScripts.size ()));
+  result.pushKV ("templates", static_cast<uint64_t> (templates.size ()));
+  result.pushKV ("memory", static_cast<uint64_t> (templateMemory));
+  result.pushKV ("maxmemory", static_cast<uint64_t> (maxTemplateMemory));
+  result.pushKV ("served", numServed);
+  result.pushKV ("servedprebuilt", numServedPrebuilt);
+  result.pushKV ("builtbackground", numBuiltBackground);
+  result.pushKV ("builtondemand", numBuiltOnDemand);
+  result.pushKV ("lastbuildms", lastBuildMicros / 1000.0);
+  result.pushKV ("maxbuildms", maxBuildMicros / 1000.0);
+  result.pushKV ("avgbuildms",
+                 numBuilt == 0 ? 0.0 : totalBuildMicros / 1000.0 / numBuilt);
+
+  UniValue ages(UniValue::VARR);
+  for (const auto& saved : templates)
+    ages.push_back (now - saved.created);
+  result.pushKV ("ages", ages);
+
+  return result;
+}
+
 UniValue
 AuxpowMiner::createAuxBlock (const CScript& scriptPubKey)
 {
@@ -12,12 +12,19 @@
 #include <txmempool.h>
 #include <uint256.h>
 #include <univalue.h>
+#include <validationinterface.h>
 
+#include <condition_variable>
+#include <list>
 #include <map>
 #include <memory>
 #include <string>
+#include <thread>
 #include <vector>
 
+/** Default for -auxpowtemplatemem, the memory (MiB) kept for auxpow block templates.  */
+static const unsigned DEFAULT_AUXPOW_TEMPLATE_MEMORY = 64;
+
 namespace auxpow_tests
 {
 class AuxpowMinerForTest;
@@ -30,21 +37,72 @@ class AuxpowMinerForTest;
  *
  * It is used as a singleton that is initialised during startup, taking the
  * place of the previously real global and static variables.
+ *
+ * Once registered for validation events, the blocks for the payout scripts
+ * miners asked for recently are rebuilt in the background:  An empty block
+ * right after the tip changed, followed by one with the mempool transactions,
+ * and again when the mempool changed and the current block is old enough.
+ * The validation callbacks only signal a worker thread, which builds them.
  */
-class AuxpowMiner
+class AuxpowMiner : public CValidationInterface
 {
 
 private:
 
+  /** How many payout scripts blocks are built in the background for.  */
+  static constexpr size_t MAX_REGISTERED_SCRIPTS = 16;
+  /** Seconds after the last request a payout script stops being built for.  */
+  static constexpr int64_t REGISTERED_SCRIPT_EXPIRY = 10 * 60;
+  /** Seconds before mempool changes lead to a new block.  */
+  static constexpr int64_t BLOCK_REFRESH_SECONDS = 60;
+
+  /** A constructed block template and what it costs to keep it.  */
+  struct SavedTemplate
+  {
+    std::unique_ptr<CBlockTemplate> tmpl;
+    size_t memory;
+    int64_t created;
+  };
+
   /** The lock used for state in this object.  */
   mutable RecursiveMutex cs;
-  /** All currently "active" block templates.  */
-  std::vector<std::unique_ptr<CBlockTemplate>> templates;
+  /** All currently "active" block templates, oldest first.  */
+  std::list<SavedTemplate> templates;
   /** Maps block hashes to pointers in vTemplates.  Does not own the memory.  */
   std::map<uint256, const CBlock*> blocks;
   /** Maps coinbase script hashes to pointers in vTemplates.  Does not own the memory.  */
   std::map<CScriptID, const CBlock*> curBlocks;
 
+  /** Payout scripts asked for, with the time of the last request.  */
+  std::map<CScriptID, std::pair<CScript, int64_t>> registeredScripts;
+  /** Mempool background blocks are built from, null if not registered.  */
+  const CTxMemPool* backgroundMempool = nullptr;
+  /** Time the last background build failed, mempool changes wait for it.  */
+  int64_t lastFailedBuild = 0;
+
+  /** Signals the background worker thread, separate from cs since it is
+      waited on while blocks are assembled.  */
+  Mutex csWorker;
+  std::condition_variable condWorker;
+  /** Whether a background build was requested and starts with empty blocks.  */
+  bool buildPending GUARDED_BY (csWorker) = false;
+  bool buildEmptyFirst GUARDED_BY (csWorker) = false;
+  bool stopWorker GUARDED_BY (csWorker) = false;
+  std::thread workerThread;
+
+  /** Memory used by and allowed for the saved templates.  */
+  size_t templateMemory = 0;
+  size_t maxTemplateMemory = DEFAULT_AUXPOW_TEMPLATE_MEMORY << 20;
+
+  /* Counters and timings for getauxtemplateinfo.  */
+  uint64_t numServed = 0;
+  uint64_t numServedPrebuilt = 0;
+  uint64_t numBuiltBackground = 0;
+  uint64_t numBuiltOnDemand = 0;
+  int64_t lastBuildMicros = 0;
+  int64_t maxBuildMicros = 0;
+  int64_t totalBuildMicros = 0;
+
   /** The current extra nonce for block creation.  */
   unsigned extraNonce = 0;
 
@@ -62,6 +120,40 @@ private:
   const CBlock* getCurrentBlock (const CTxMemPool& mempool,
                                  const CScript& scriptPubKey, uint256& target);
 
+  /**
+   * Finalises a newly built block for scriptID on top of pindexTip and saves
+   * it as the current block for it.  Blocks of an older tip are dropped, as
+   * are the oldest blocks once the memory cap is exceeded.
+   */
+  const CBlock* addBlock (std::unique_ptr<CBlockTemplate> newBlock,
+                          const CScriptID& scriptID,
+                          const CBlockIndex* pindexTip, int64_t buildMicros);
+
+  /**
+   * Builds blocks for all registered payout scripts, first empty ones if
+   * emptyFirst is set.  Called on the worker thread without holding cs while
+   * the blocks are assembled.  Scripts for which no block can be built right
+   * now (e.g. while the masternode list is syncing) are skipped.
+   */
+  void buildBackgroundBlocks (bool emptyFirst);
+
+  /**
+   * Asks the worker thread for a background build.  Requests that come in
+   * while one is pending are merged into it.
+   */
+  void signalBackgroundBuild (bool emptyFirst);
+
+  /** Worker thread waiting for and running the background builds.  */
+  void threadBackgroundBlocks ();
+
+protected:
+
+  void UpdatedBlockTip (const CBlockIndex* pindexNew,
+                        const CBlockIndex* pindexFork,
+                        bool fInitialDownload) override;
+  void TransactionAddedToMempool (const CTransactionRef& ptx,
+                                  bool fBlock) override;
+
   /**
    * Looks up a previously constructed block by its (hex-encoded) hash.  If the
    * block is found, it is returned.  Otherwise, a JSONRPCError is thrown.
@@ -74,6 +166,18 @@ public:
 
   AuxpowMiner () = default;
 
+  /**
+   * Starts building blocks from the given mempool in the background, with at
+   * most maxMemory bytes kept for block templates.
+   */
+  void startBackgroundBlocks (const CTxMemPool& mempool, size_t maxMemory);
+
+  /** Stops background building, waiting for a running build to finish.  */
+  void stopBackgroundBlocks ();
+
+  /** Counts, memory and build latencies of the templates and their ages.  */
+  UniValue getTemplateInfo () const;
+
   /**
    * Performs the main work for the "createauxblock" RPC:  Construct a new block
    * to work on with the given address for the block reward and return the
@@ -21,10 +21,13 @@
 #include <policy/policy.h>
 #include <policy/rbf.h>
 #include <primitives/transaction.h>
+#include <rpc/jsonstream.h>
 #include <rpc/rawtransaction_util.h>
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <script/descriptor.h>
+// SYSCOIN
+#include <services/assetconsensus.h>
 #include <streams.h>
 #include <sync.h>
 #include <txdb.h>
@@ -201,6 +204,31 @@ UniValue blockToJSON(const CBlock& block, const CBlockIndex* tip, const CBlockIn
     return result;
 }
 
+// SYSCOIN
+/** blockToJSON() with transaction details, written to a stream one transaction at a time */
+static void blockToJSONStream(JSONStreamWriter& writer, const CBlock& block, const CBlockIndex* tip, const CBlockIndex* blockindex)
+{
+    // all but the transactions is small, it is taken from blockToJSON() in the same order
+    const UniValue header = blockToJSON(block, tip, blockindex, false);
+    writer.BeginObject();
+    for (size_t i = 0; i < header.size(); i++) {
+        const std::string& strKey = header.getKeys()[i];
+        if (strKey != "tx") {
+            writer.KeyValue(strKey, header.getValues()[i]);
+            continue;
+        }
+        writer.Key(strKey);
+        writer.BeginArray();
+        for (const auto& tx : block.vtx) {
+            UniValue objTx(UniValue::VOBJ);
+            TxToUniv(*tx, uint256(), objTx, true, RPCSerializationFlags());
+            writer.Value(objTx);
+        }
+        writer.EndArray();
+    }
+    writer.EndObject();
+}
+
 static UniValue getblockcount(const JSONRPCRequest& request)
 {
             RPCHelpMan{"getblockcount",
@@ -809,7 +837,7 @@ static CBlock GetBlockChecked(const CBlockIndex* pblockindex)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
     }
 
-    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
+    if (!ReadBlockFromCacheOrDisk(block, pblockindex, Params().GetConsensus())) {
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
         // non-whitelisted node sends us an unrequested long chain of valid
@@ -939,6 +967,12 @@ static UniValue getblock(const JSONRPCRequest& request)
         return strHex;
     }
 
+    // SYSCOIN HTTP clients get the transactions of the block streamed one at a time
+    if (verbosity >= 2 && request.replyStream) {
+        blockToJSONStream(request.replyStream->Start(), block, tip, pblockindex);
+        return NullUniValue;
+    }
+
     return blockToJSON(block, tip, pblockindex, verbosity >= 2);
 }
 
@@ -2291,14 +2325,16 @@ static UniValue getblockfilter(const JSONRPCRequest& request)
 
 /**
  * Serialize the UTXO set to a file for loading elsewhere.
+ * SYSCOIN: the coins are followed by the asset databases and the hash of everything before it.
  *
  * @see SnapshotMetadata
+ * @see GetSnapshotAssetDBs
  */
 UniValue dumptxoutset(const JSONRPCRequest& request)
 {
     RPCHelpMan{
         "dumptxoutset",
-        "\nWrite the serialized UTXO set to disk.\n"
+        "\nWrite the serialized UTXO set and asset state to disk.\n"
         "Incidentally flushes the latest coinsdb (leveldb) to disk.\n",
         {
             {"path",
@@ -2311,8 +2347,10 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
             RPCResult::Type::OBJ, "", "",
                 {
                     {RPCResult::Type::NUM, "coins_written", "the number of coins written in the snapshot"},
+                    {RPCResult::Type::NUM, "asset_entries_written", "the number of asset database entries written in the snapshot"},
                     {RPCResult::Type::STR_HEX, "base_hash", "the hash of the base of the snapshot"},
                     {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
+                    {RPCResult::Type::STR_HEX, "content_hash", "the hash of the snapshot contents, appended to the file"},
                     {RPCResult::Type::STR, "path", "the absolute path that the snapshot was written to"},
                 }
         },
@@ -2336,6 +2374,8 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
     FILE* file{fsbridge::fopen(temppath, "wb")};
     CAutoFile afile{file, SER_DISK, CLIENT_VERSION};
     std::unique_ptr<CCoinsViewCursor> pcursor;
+    // SYSCOIN
+    std::vector<std::unique_ptr<CDBIterator> > vecAssetCursors;
     CCoinsStats stats;
     CBlockIndex* tip;
 
@@ -2361,13 +2401,19 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
         }
 
         pcursor = std::unique_ptr<CCoinsViewCursor>(::ChainstateActive().CoinsDB().Cursor());
+        // SYSCOIN asset databases are written as blocks connect, so they are at the same tip
+        for (CDBWrapper* pdb : GetSnapshotAssetDBs()) {
+            vecAssetCursors.emplace_back(pdb->NewIterator());
+        }
         tip = LookupBlockIndex(stats.hashBlock);
         CHECK_NONFATAL(tip);
     }
 
     SnapshotMetadata metadata{tip->GetBlockHash(), stats.coins_count, tip->nChainTx};
 
-    afile << metadata;
+    // SYSCOIN
+    CHashedSourceWriter<CAutoFile> hashwriter{&afile};
+    hashwriter << metadata;
 
     COutPoint key;
     Coin coin;
@@ -2379,24 +2425,140 @@ UniValue dumptxoutset(const JSONRPCRequest& request)
         }
         ++iter;
         if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
-            afile << key;
-            afile << coin;
+            hashwriter << key;
+            hashwriter << coin;
         }
 
         pcursor->Next();
     }
 
+    // SYSCOIN
+    const uint64_t nAssetEntries = WriteAssetSnapshot(hashwriter, vecAssetCursors);
+    const uint256 hashContent = hashwriter.GetHash();
+    afile << hashContent;
+
     afile.fclose();
     fs::rename(temppath, path);
 
     UniValue result(UniValue::VOBJ);
     result.pushKV("coins_written", stats.coins_count);
+    result.pushKV("asset_entries_written", nAssetEntries);
     result.pushKV("base_hash", tip->GetBlockHash().ToString());
     result.pushKV("base_height", tip->nHeight);
+    result.pushKV("content_hash", hashContent.GetHex());
     result.pushKV("path", path.string());
     return result;
 }
 
+// SYSCOIN
+/**
+ * Read a snapshot written by dumptxoutset and verify its content hash, returns the number of asset entries.
+ * With fLoad its asset entries are loaded into the asset databases once the coins were read, which happens
+ * under cs_main and only if the snapshot is based on the chain tip
+ */
+static uint64_t ReadTxOutSetSnapshot(const fs::path& path, bool fLoad, SnapshotMetadata& metadata, uint256& hashContent)
+{
+    FILE* file{fsbridge::fopen(path, "rb")};
+    CAutoFile afile{file, SER_DISK, CLIENT_VERSION};
+    if (afile.IsNull()) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Unable to open " + path.string());
+    }
+    CHashVerifier<CAutoFile> verifier{&afile};
+    uint256 hashExpected;
+    uint64_t nAssetEntries{0};
+    bool fLoading{false};
+    try {
+        verifier >> metadata;
+        COutPoint key;
+        Coin coin;
+        for (uint64_t i = 0; i < metadata.m_coins_count; ++i) {
+            if (i % 5000 == 0 && !IsRPCRunning()) {
+                throw JSONRPCError(RPC_CLIENT_NOT_CONNECTED, "Shutting down");
+            }
+            verifier >> key;
+            verifier >> coin;
+        }
+        if (fLoad) {
+            LOCK(::cs_main);
+            const CBlockIndex* tip = ::ChainActive().Tip();
+            if (!tip || tip->GetBlockHash() != metadata.m_base_blockhash) {
+                throw JSONRPCError(RPC_INVALID_PARAMETER, "Snapshot is based on block " + metadata.m_base_blockhash.GetHex() + " which is not the chain tip");
+            }
+            fLoading = true;
+            nAssetEntries = ReadAssetSnapshot(verifier, true);
+            hashContent = verifier.GetHash();
+            afile >> hashExpected;
+            if (hashContent == hashExpected) {
+                FinishAssetSnapshotLoad();
+                fLoading = false;
+                LogPrintf("%s: loaded %d asset entries at block %s from %s\n", __func__, nAssetEntries, tip->GetBlockHash().ToString(), path.string());
+            }
+        } else {
+            nAssetEntries = ReadAssetSnapshot(verifier, false);
+            hashContent = verifier.GetHash();
+            afile >> hashExpected;
+        }
+    } catch (const std::ios_base::failure& e) {
+        if (!fLoading) {
+            throw JSONRPCError(RPC_DESERIALIZATION_ERROR, strprintf("Snapshot is truncated or corrupt: %s", e.what()));
+        }
+    }
+    if (fLoading) {
+        // the file changed since it was verified, the databases stay flagged as incomplete
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Snapshot changed while it was loaded, the asset databases are incomplete, restart with -reindex-chainstate");
+    }
+    if (hashContent != hashExpected) {
+        throw JSONRPCError(RPC_VERIFY_ERROR, "Snapshot content hash mismatch, expected " + hashExpected.GetHex() + " got " + hashContent.GetHex());
+    }
+    return nAssetEntries;
+}
+
+static UniValue loadassetsnapshot(const JSONRPCRequest& request)
+{
+    RPCHelpMan{
+        "loadassetsnapshot",
+        "\nReplace the asset, asset allocation, locked outpoint and ethereum mint databases with the asset state of a snapshot\n"
+        "written by dumptxoutset. The snapshot must be based on the current chain tip, the chainstate is not touched. The file\n"
+        "is read twice: its content hash is verified first and its asset entries are only written while reading it again.\n"
+        "If that second read is interrupted the asset databases have to be rebuilt with -reindex-chainstate.\n",
+        {
+            {"path",
+                RPCArg::Type::STR,
+                RPCArg::Optional::NO,
+                /* default_val */ "",
+                "path to the snapshot file. If relative, will be prefixed by datadir."},
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+                {
+                    {RPCResult::Type::NUM, "asset_entries_loaded", "the number of asset database entries loaded"},
+                    {RPCResult::Type::STR_HEX, "base_hash", "the hash of the base of the snapshot"},
+                    {RPCResult::Type::NUM, "base_height", "the height of the base of the snapshot"},
+                    {RPCResult::Type::STR_HEX, "content_hash", "the verified hash of the snapshot contents"},
+                }
+        },
+        RPCExamples{
+            HelpExampleCli("loadassetsnapshot", "utxo.dat")
+        }
+    }.Check(request);
+
+    const fs::path path = fs::absolute(request.params[0].get_str(), GetDataDir());
+    SnapshotMetadata metadata;
+    uint256 hashContent;
+    // nothing is kept in memory, the asset entries are streamed into the databases on the second read
+    ReadTxOutSetSnapshot(path, false, metadata, hashContent);
+    const uint64_t nAssetEntries = ReadTxOutSetSnapshot(path, true, metadata, hashContent);
+
+    const CBlockIndex* pindexBase = WITH_LOCK(::cs_main, return LookupBlockIndex(metadata.m_base_blockhash));
+    CHECK_NONFATAL(pindexBase);
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("asset_entries_loaded", nAssetEntries);
+    result.pushKV("base_hash", pindexBase->GetBlockHash().ToString());
+    result.pushKV("base_height", pindexBase->nHeight);
+    result.pushKV("content_hash", hashContent.GetHex());
+    return result;
+}
+
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                      actor (function)         argNames
@@ -2434,6 +2596,7 @@ static const CRPCCommand commands[] =
     { "hidden",             "waitforblockheight",     &waitforblockheight,     {"height","timeout"} },
     { "hidden",             "syncwithvalidationinterfacequeue", &syncwithvalidationinterfacequeue, {} },
     { "hidden",             "dumptxoutset",           &dumptxoutset,           {"path"} },
+    { "hidden",             "loadassetsnapshot",      &loadassetsnapshot,      {"path"} },
 };
 // clang-format on
 
@@ -193,6 +193,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "assetallocationmint", 3, "blocknumber" },
     { "assetallocationinfo", 0, "asset_guid" },
     { "assetallocationbalance", 0, "asset_guid" },
+    { "getassetbalances", 0, "asset_guid" },
     { "assetallocationbalances", 0, "asset_guid" },
     { "assetallocationbalances", 1, "addresses" },
     { "syscoingettxroots", 0, "height" },
@@ -223,6 +224,7 @@ static const CRPCConvertParam vRPCConvertParams[] =
     { "listassets", 2, "options" },
     { "tpstestadd", 0, "starttime" },
     { "tpstestadd", 1, "rawtxs" },
+    { "tpstestadd", 2, "threads" },
     { "tpstestsetenabled", 0, "enabled" },
     { "syscoinsetethstatus", 1, "highestBlock" },
     { "syscoinsetethheaders", 0, "headers" },
@@ -0,0 +1,138 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <rpc/jsonstream.h>
+
+#include <util/memory.h>
+
+#include <assert.h>
+
+JSONStreamWriter::JSONStreamWriter(Sink sinkIn, size_t nChunkSizeIn) : sink(std::move(sinkIn)), nChunkSize(nChunkSizeIn)
+{
+}
+
+void JSONStreamWriter::Write(const std::string& str)
+{
+    strChunk += str;
+    nWritten += str.size();
+    if (strChunk.size() >= nChunkSize) {
+        Flush();
+    }
+}
+
+void JSONStreamWriter::BeginValue()
+{
+    if (fKey) {
+        fKey = false;
+        return;
+    }
+    if (!vecFilled.empty()) {
+        if (vecFilled.back()) {
+            Write(",");
+        }
+        vecFilled.back() = true;
+    }
+}
+
+void JSONStreamWriter::BeginObject()
+{
+    BeginValue();
+    Write("{");
+    vecFilled.push_back(false);
+}
+
+void JSONStreamWriter::EndObject()
+{
+    assert(!vecFilled.empty() && !fKey);
+    vecFilled.pop_back();
+    Write("}");
+}
+
+void JSONStreamWriter::BeginArray()
+{
+    BeginValue();
+    Write("[");
+    vecFilled.push_back(false);
+}
+
+void JSONStreamWriter::EndArray()
+{
+    assert(!vecFilled.empty() && !fKey);
+    vecFilled.pop_back();
+    Write("]");
+}
+
+void JSONStreamWriter::Key(const std::string& strKey)
+{
+    assert(!fKey);
+    BeginValue();
+    Write(UniValue(strKey).write() + ":");
+    fKey = true;
+}
+
+void JSONStreamWriter::Value(const UniValue& value)
+{
+    BeginValue();
+    Write(value.write());
+}
+
+void JSONStreamWriter::Flush()
+{
+    if (!strChunk.empty()) {
+        sink(strChunk);
+        strChunk.clear();
+    }
+}
+
+JSONRPCReplyStream::JSONRPCReplyStream(const UniValue& idIn, std::function<void()> startReplyIn, JSONStreamWriter::Sink sinkIn) :
+    id(idIn), startReply(std::move(startReplyIn)), sink(std::move(sinkIn))
+{
+}
+
+JSONStreamWriter& JSONRPCReplyStream::Start()
+{
+    assert(!writer);
+    startReply();
+    writer = MakeUnique<JSONStreamWriter>(sink);
+    // the members of the reply in the order JSONRPCReplyObj() has them
+    writer->BeginObject();
+    writer->Key("result");
+    return *writer;
+}
+
+void JSONRPCReplyStream::Finish()
+{
+    assert(writer);
+    writer->KeyValue("error", NullUniValue);
+    writer->KeyValue("id", id);
+    writer->EndObject();
+    writer->Flush();
+    sink("\n");
+}
+
+JSONRPCArrayResult::JSONRPCArrayResult(const JSONRPCRequest& request) : stream(request.replyStream), result(UniValue::VARR)
+{
+}
+
+void JSONRPCArrayResult::push_back(const UniValue& value)
+{
+    if (!writer && stream) {
+        writer = &stream->Start();
+        writer->BeginArray();
+    }
+    if (writer) {
+        writer->Value(value);
+    } else {
+        result.push_back(value);
+    }
+}
+
+UniValue JSONRPCArrayResult::Finish()
+{
+    if (writer) {
+        writer->EndArray();
+        return NullUniValue;
+    }
+    return result;
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_RPC_JSONSTREAM_H
+#define SYSCOIN_RPC_JSONSTREAM_H
+
+#include <rpc/request.h>
+
+#include <univalue.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** Bytes a JSON stream collects before handing them on as one chunk */
+static const size_t JSON_STREAM_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * Writes a JSON document a piece at a time and hands it to a sink in chunks, so a large result doesn't
+ * need to be built as one UniValue tree and written into one string first. Containers are opened and
+ * closed explicitly, the values in them are UniValues that are written as soon as they are complete.
+ */
+class JSONStreamWriter
+{
+public:
+    typedef std::function<void(const std::string&)> Sink;
+
+private:
+    Sink sink;
+    const size_t nChunkSize;
+    std::string strChunk;
+    //! whether anything was written to each of the open containers yet
+    std::vector<bool> vecFilled;
+    //! a key was written and its value is next
+    bool fKey{false};
+    size_t nWritten{0};
+
+    void BeginValue();
+    void Write(const std::string& str);
+
+public:
+    explicit JSONStreamWriter(Sink sinkIn, size_t nChunkSizeIn = JSON_STREAM_CHUNK_SIZE);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+    /** Key of the next value in an object */
+    void Key(const std::string& strKey);
+    void Value(const UniValue& value);
+    void KeyValue(const std::string& strKey, const UniValue& value)
+    {
+        Key(strKey);
+        Value(value);
+    }
+
+    /** Hand what was written so far to the sink */
+    void Flush();
+    /** Bytes written, including those not handed to the sink yet */
+    size_t GetBytesWritten() const { return nWritten; }
+};
+
+/**
+ * The reply to a JSON-RPC request made over HTTP, which an RPC can stream its result into. Start()
+ * sends the reply up to the result, which is then written to the returned writer. The RPC returns
+ * once it wrote all of it, the HTTP handler completes the reply with Finish(). An RPC that doesn't
+ * call Start() replies as usual with the UniValue it returns.
+ */
+class JSONRPCReplyStream
+{
+private:
+    const UniValue id;
+    std::function<void()> startReply;
+    JSONStreamWriter::Sink sink;
+    std::unique_ptr<JSONStreamWriter> writer;
+
+public:
+    JSONRPCReplyStream(const UniValue& idIn, std::function<void()> startReplyIn, JSONStreamWriter::Sink sinkIn);
+
+    JSONStreamWriter& Start();
+    bool IsStarted() const { return writer != nullptr; }
+    void Finish();
+};
+
+/**
+ * The array result of an RPC, written to the reply stream of the request entry by entry if it has
+ * one, else collected into a UniValue as usual. The reply is only started by the first entry, so an
+ * RPC failing before it found one (e.g. on bad options) still replies with a normal error.
+ */
+class JSONRPCArrayResult
+{
+private:
+    const std::shared_ptr<JSONRPCReplyStream> stream;
+    JSONStreamWriter* writer{nullptr};
+    UniValue result;
+
+public:
+    explicit JSONRPCArrayResult(const JSONRPCRequest& request);
+
+    void push_back(const UniValue& value);
+    /** The value the RPC returns, null if the entries were streamed */
+    UniValue Finish();
+};
+
+#endif // SYSCOIN_RPC_JSONSTREAM_H
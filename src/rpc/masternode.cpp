@@ -7,6 +7,7 @@
 #include <base58.h>
 #include <clientversion.h>
 #include <init.h>
+#include <maintenance.h>
 #include <netbase.h>
 #include <validation.h>
 #include <masternodepayments.h>
@@ -886,6 +887,52 @@ UniValue sentinelping(const JSONRPCRequest& request)
     activeMasternode.UpdateSentinelPing(request.params[0].get_int());
     return true;
 }
+UniValue getmaintenanceinfo(const JSONRPCRequest& request)
+{
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            RPCHelpMan{"getmaintenanceinfo",
+                "\nReturns timing statistics of the periodic masternode, payment and governance maintenance jobs.\n",
+                {},
+                RPCResult{
+                    RPCResult::Type::OBJ_DYN, "", "json object keyed by job name",
+                    {
+                        {RPCResult::Type::OBJ, "job", "",
+                        {
+                            {RPCResult::Type::NUM, "runs", "number of completed runs"},
+                            {RPCResult::Type::NUM, "slices", "number of lock slices processed"},
+                            {RPCResult::Type::NUM, "items", "number of list entries processed"},
+                            {RPCResult::Type::NUM_TIME, "lastrun", "time of the last completed run in " + UNIX_EPOCH_TIME},
+                            {RPCResult::Type::NUM, "lastrunms", "duration of the last run in milliseconds"},
+                            {RPCResult::Type::NUM, "maxrunms", "longest run in milliseconds"},
+                            {RPCResult::Type::NUM, "avgrunms", "average run in milliseconds"},
+                            {RPCResult::Type::NUM, "maxslicems", "longest single slice (lock hold) in milliseconds"},
+                        }},
+                    }
+                },
+                RPCExamples{
+                    HelpExampleCli("getmaintenanceinfo", "")
+                    + HelpExampleRpc("getmaintenanceinfo", "")
+                }
+            }.ToString());
+    }
+
+    UniValue obj(UniValue::VOBJ);
+    for (const auto& pair : maintenanceman.GetJobStats()) {
+        const MaintenanceJobStats& stats = pair.second;
+        UniValue objJob(UniValue::VOBJ);
+        objJob.pushKV("runs", stats.nRuns);
+        objJob.pushKV("slices", stats.nSlices);
+        objJob.pushKV("items", stats.nItems);
+        objJob.pushKV("lastrun", stats.nLastRunTime);
+        objJob.pushKV("lastrunms", stats.nLastRunMicros * 0.001);
+        objJob.pushKV("maxrunms", stats.nMaxRunMicros * 0.001);
+        objJob.pushKV("avgrunms", stats.nRuns > 0 ? stats.nTotalRunMicros * 0.001 / stats.nRuns : 0.0);
+        objJob.pushKV("maxslicems", stats.nMaxSliceMicros * 0.001);
+        obj.pushKV(pair.first, objJob);
+    }
+    return obj;
+}
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                                actor (function)                argNames
@@ -897,6 +944,7 @@ static const CRPCCommand commands[] =
     { "governance",            "voteraw",                          &voteraw,                       {"masternode-tx-hash","tx_index","governancehash","vote-signal","vote","time","vote-sig"} },  
     { "governance",            "masternodelist",                   &masternodelist,                {"mode","filter"} },
     { "governance",            "sentinelping",                     &sentinelping,                  {"version"} }, 
+    { "governance",            "getmaintenanceinfo",               &getmaintenanceinfo,            {} },
     { "governance",            "masternodebroadcast",              &masternodebroadcast,           {"command","data"} },
     { "governance",            "masternode",                       &masternode,                    {"command","data"} },
     { "governance",            "gobject",                          &gobject,                       {} },
@@ -1109,6 +1109,41 @@ static UniValue estimaterawfee(const JSONRPCRequest& request)
                                           request.params[1].get_str());
 }
 
+UniValue getauxtemplateinfo(const JSONRPCRequest& request)
+{
+    RPCHelpMan{"getauxtemplateinfo",
+        "\nReturns information about the blocks built for 'createauxblock',"
+        " in the background for recently used payout addresses or on demand.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::BOOL, "background", "whether blocks are built in the background"},
+                {RPCResult::Type::NUM, "scripts", "number of payout scripts blocks are built for"},
+                {RPCResult::Type::NUM, "templates", "number of saved blocks that can be submitted"},
+                {RPCResult::Type::NUM, "memory", "memory used by the saved blocks in bytes"},
+                {RPCResult::Type::NUM, "maxmemory", "memory allowed for the saved blocks in bytes"},
+                {RPCResult::Type::NUM, "served", "number of blocks returned by 'createauxblock'"},
+                {RPCResult::Type::NUM, "servedprebuilt", "how many of them were built before they were asked for"},
+                {RPCResult::Type::NUM, "builtbackground", "number of blocks built in the background"},
+                {RPCResult::Type::NUM, "builtondemand", "number of blocks built while 'createauxblock' waited"},
+                {RPCResult::Type::NUM, "lastbuildms", "time taken to build the last block in milliseconds"},
+                {RPCResult::Type::NUM, "maxbuildms", "longest time taken to build a block in milliseconds"},
+                {RPCResult::Type::NUM, "avgbuildms", "average time taken to build a block in milliseconds"},
+                {RPCResult::Type::ARR, "ages", "age of the saved blocks in seconds, oldest first",
+                    {
+                        {RPCResult::Type::NUM, "", "age in seconds"},
+                    }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getauxtemplateinfo", "")
+            + HelpExampleRpc("getauxtemplateinfo", "")
+        },
+    }.Check(request);
+
+    return g_auxpow_miner->getTemplateInfo();
+}
+
  /* ************************************************************************** */
 
 // clang-format off
@@ -1124,6 +1159,7 @@ static const CRPCCommand commands[] =
 
     { "mining",             "createauxblock",         &createauxblock,         {"address"} },
     { "mining",             "submitauxblock",         &submitauxblock,         {"hash", "auxpow"} },
+    { "mining",             "getauxtemplateinfo",     &getauxtemplateinfo,     {} },
 
     { "generating",         "generatetoaddress",      &generatetoaddress,      {"nblocks","address","maxtries"} },
     { "generating",         "generatetodescriptor",   &generatetodescriptor,   {"num_blocks","descriptor","maxtries"} },
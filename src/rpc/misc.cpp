@@ -25,7 +25,9 @@
 
 #include <univalue.h>
 // SYSCOIN
+#include <blockcache.h>
 #include <masternodesync.h>
+#include <netrecvpool.h>
 #include <spork.h>
 UniValue mnsync(const JSONRPCRequest& request);
 UniValue spork(const JSONRPCRequest& request);
@@ -59,6 +61,7 @@ UniValue mnsync(const JSONRPCRequest& request)
         objStatus.pushKV("IsWinnersListSynced", masternodeSync.IsWinnersListSynced());
         objStatus.pushKV("IsSynced", masternodeSync.IsSynced());
         objStatus.pushKV("IsFailed", masternodeSync.IsFailed());
+        objStatus.pushKV("Progress", masternodeSync.GetProgressJSON());
         return objStatus;
     }
 
@@ -585,6 +588,24 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
                                 {RPCResult::Type::NUM, "chunks_used", "Number allocated chunks"},
                                 {RPCResult::Type::NUM, "chunks_free", "Number unused chunks"},
                             }},
+                            {RPCResult::Type::OBJ, "recentblocks", "Information about the cache of recently connected blocks",
+                            {
+                                {RPCResult::Type::NUM, "blocks", "Number of cached blocks"},
+                                {RPCResult::Type::NUM, "usage", "Number of bytes used by the cached blocks"},
+                                {RPCResult::Type::NUM, "max", "Number of bytes the cached blocks may use (-blockcachesize)"},
+                                {RPCResult::Type::NUM, "hits", "Number of block reads served from the cache"},
+                                {RPCResult::Type::NUM, "misses", "Number of block reads that went to disk"},
+                            }},
+                            {RPCResult::Type::OBJ, "recvbuffers", "Information about the pool of network message receive buffers",
+                            {
+                                {RPCResult::Type::NUM, "pooled", "Number of buffers waiting to be reused"},
+                                {RPCResult::Type::NUM, "usage", "Number of bytes held by the pooled buffers"},
+                                {RPCResult::Type::NUM, "allocated", "Number of buffers newly allocated for a message payload"},
+                                {RPCResult::Type::NUM, "reused", "Number of message payloads received into a pooled buffer"},
+                                {RPCResult::Type::NUM, "received", "Number of payload bytes received"},
+                                {RPCResult::Type::NUM, "direct", "Number of payload bytes read from the socket straight into their message buffer"},
+                                {RPCResult::Type::NUM, "copied", "Number of payload bytes copied from the socket read buffer or into a grown message buffer"},
+                            }},
                         }
                     },
                     RPCResult{"mode \"mallocinfo\"",
@@ -601,6 +622,9 @@ static UniValue getmemoryinfo(const JSONRPCRequest& request)
     if (mode == "stats") {
         UniValue obj(UniValue::VOBJ);
         obj.pushKV("locked", RPCLockedMemoryInfo());
+        // SYSCOIN
+        obj.pushKV("recentblocks", recentblockcache.ToJSON());
+        obj.pushKV("recvbuffers", recvbufferpool.ToJSON());
         return obj;
     } else if (mode == "mallocinfo") {
 #ifdef HAVE_MALLOC_INFO
@@ -6,10 +6,14 @@
 #ifndef SYSCOIN_RPC_REQUEST_H
 #define SYSCOIN_RPC_REQUEST_H
 
+#include <memory>
 #include <string>
 
 #include <univalue.h>
 
+// SYSCOIN
+class JSONRPCReplyStream;
+
 UniValue JSONRPCRequestObj(const std::string& strMethod, const UniValue& params, const UniValue& id);
 UniValue JSONRPCReplyObj(const UniValue& result, const UniValue& error, const UniValue& id);
 std::string JSONRPCReply(const UniValue& result, const UniValue& error, const UniValue& id);
@@ -34,6 +38,8 @@ public:
     std::string URI;
     std::string authUser;
     std::string peerAddr;
+    // SYSCOIN set for a single request made over HTTP, large results can be streamed to it
+    std::shared_ptr<JSONRPCReplyStream> replyStream;
 
     JSONRPCRequest() : id(NullUniValue), params(NullUniValue), fHelp(false) {}
     void parse(const UniValue& valRequest);
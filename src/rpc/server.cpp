@@ -10,12 +10,16 @@
 #include <sync.h>
 #include <util/strencodings.h>
 #include <util/system.h>
+#include <util/threadnames.h>
 
 #include <boost/signals2/signal.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
 
+#include <condition_variable>
+#include <deque>
 #include <memory> // for unique_ptr
+#include <thread>
 #include <unordered_map>
 
 static RecursiveMutex cs_rpcWarmup;
@@ -57,6 +61,65 @@ struct RPCCommandExecution
     }
 };
 
+// SYSCOIN
+/** The calls of one JSON-RPC batch, claimed one at a time by the threads running them */
+struct RPCBatch
+{
+    const JSONRPCRequest jreq;
+    //! only read for claimed calls, the batch isn't done before they are
+    const UniValue& vReq;
+    const size_t nSize;
+    std::vector<UniValue> vResults;
+    std::atomic<size_t> nNext{0};
+    Mutex cs;
+    std::condition_variable cond;
+    size_t nDone GUARDED_BY(cs){0};
+
+    RPCBatch(const JSONRPCRequest& jreqIn, const UniValue& vReqIn) : jreq(jreqIn), vReq(vReqIn), nSize(vReqIn.size()), vResults(nSize) {}
+
+    /** Run calls until none are left to claim, returns how many were run */
+    size_t Run();
+};
+
+/**
+ * Threads the calls of JSON-RPC batches fan out to with -rpcbatchthreads, as JSON-RPC 2.0 allows for
+ * the calls of a batch. The worker that received a batch runs calls of it as well, so a batch still
+ * completes while the threads are busy with other batches, their queue is full or they were stopped.
+ */
+class RPCBatchExecutor
+{
+private:
+    Mutex cs;
+    std::condition_variable cond;
+    std::deque<std::shared_ptr<RPCBatch>> queue GUARDED_BY(cs);
+    bool fRunning GUARDED_BY(cs){false};
+    std::vector<std::thread> threads;
+    size_t nMaxQueue{0};
+    int nConcurrency{DEFAULT_RPC_BATCH_CONCURRENCY};
+
+    std::atomic<uint64_t> nBatches{0};
+    std::atomic<uint64_t> nParallelBatches{0};
+    std::atomic<uint64_t> nCalls{0};
+    std::atomic<uint64_t> nOffloaded{0};
+    std::atomic<uint64_t> nQueueFull{0};
+
+    void ThreadRun(int nWorker);
+
+public:
+    void Start(int nThreads, int nConcurrencyIn);
+    void Stop();
+    bool IsRunning()
+    {
+        LOCK(cs);
+        return fRunning;
+    }
+    /** Results of the calls of a batch, in the order of the calls */
+    std::vector<UniValue> Execute(const JSONRPCRequest& jreq, const UniValue& vReq);
+    UniValue ToJSON() const;
+};
+
+static RPCBatchExecutor g_rpc_batch_executor;
+
 static struct CRPCSignals
 {
     boost::signals2::signal<void ()> Started;
@@ -209,6 +272,16 @@ static UniValue getrpcinfo(const JSONRPCRequest& request)
                             }},
                         }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
+                        {RPCResult::Type::OBJ, "batches", "Information about the execution of JSON-RPC batches",
+                        {
+                            {RPCResult::Type::NUM, "threads", "The threads calls of a batch fan out to (-rpcbatchthreads)"},
+                            {RPCResult::Type::NUM, "concurrency", "The most calls of one batch running at once (-rpcbatchconcurrency)"},
+                            {RPCResult::Type::NUM, "batches", "Number of batches executed"},
+                            {RPCResult::Type::NUM, "parallel", "Number of batches that fanned out to the batch threads"},
+                            {RPCResult::Type::NUM, "calls", "Number of calls in the batches"},
+                            {RPCResult::Type::NUM, "offloaded", "Number of calls run by the batch threads"},
+                            {RPCResult::Type::NUM, "queue_full", "Number of times a batch found the queue of the batch threads full"},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -231,6 +304,8 @@ static UniValue getrpcinfo(const JSONRPCRequest& request)
     const std::string path = LogInstance().m_file_path.string();
     UniValue log_path(UniValue::VSTR, path);
     result.pushKV("logpath", log_path);
+    // SYSCOIN
+    result.pushKV("batches", g_rpc_batch_executor.ToJSON());
 
     return result;
 }
@@ -285,6 +360,8 @@ void StartRPC()
 {
     LogPrint(BCLog::RPC, "Starting RPC\n");
     g_rpc_running = true;
+    // SYSCOIN
+    g_rpc_batch_executor.Start(gArgs.GetArg("-rpcbatchthreads", DEFAULT_RPC_BATCH_THREADS), gArgs.GetArg("-rpcbatchconcurrency", DEFAULT_RPC_BATCH_CONCURRENCY));
     g_rpcSignals.Started();
 }
 
@@ -298,6 +375,8 @@ void InterruptRPC()
 void StopRPC()
 {
     LogPrint(BCLog::RPC, "Stopping RPC\n");
+    // SYSCOIN
+    g_rpc_batch_executor.Stop();
     deadlineTimers.clear();
     DeleteAuthCookie();
     g_rpcSignals.Stopped();
@@ -359,9 +438,129 @@ static UniValue JSONRPCExecOne(JSONRPCRequest jreq, const UniValue& req)
     return rpc_result;
 }
 
+// SYSCOIN
+size_t RPCBatch::Run()
+{
+    size_t nRun = 0;
+    for (size_t i = nNext++; i < nSize; i = nNext++) {
+        vResults[i] = JSONRPCExecOne(jreq, vReq[i]);
+        nRun++;
+    }
+    if (nRun > 0) {
+        LOCK(cs);
+        nDone += nRun;
+        if (nDone == nSize) {
+            cond.notify_all();
+        }
+    }
+    return nRun;
+}
+
+void RPCBatchExecutor::Start(int nThreads, int nConcurrencyIn)
+{
+    if (nThreads <= 0) {
+        return;
+    }
+    nConcurrency = std::max(nConcurrencyIn, 1);
+    nMaxQueue = 16 * nThreads;
+    {
+        LOCK(cs);
+        fRunning = true;
+    }
+    LogPrint(BCLog::RPC, "Starting %d RPC batch threads, running up to %d calls of a batch at once\n", nThreads, nConcurrency);
+    for (int i = 0; i < nThreads; i++) {
+        threads.emplace_back(&RPCBatchExecutor::ThreadRun, this, i);
+    }
+}
+
+void RPCBatchExecutor::Stop()
+{
+    {
+        LOCK(cs);
+        fRunning = false;
+        // batches waiting for a thread run their remaining calls themselves
+        queue.clear();
+        cond.notify_all();
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    threads.clear();
+}
+
+void RPCBatchExecutor::ThreadRun(int nWorker)
+{
+    util::ThreadRename(strprintf("rpcbatch.%i", nWorker));
+    while (true) {
+        std::shared_ptr<RPCBatch> batch;
+        {
+            WAIT_LOCK(cs, lock);
+            while (fRunning && queue.empty())
+                cond.wait(lock);
+            if (!fRunning)
+                break;
+            batch = std::move(queue.front());
+            queue.pop_front();
+        }
+        nOffloaded += batch->Run();
+    }
+}
+
+std::vector<UniValue> RPCBatchExecutor::Execute(const JSONRPCRequest& jreq, const UniValue& vReq)
+{
+    std::shared_ptr<RPCBatch> batch = std::make_shared<RPCBatch>(jreq, vReq);
+    nBatches++;
+    nCalls += vReq.size();
+    // this thread is one of the nConcurrency running calls of the batch
+    const size_t nHelpers = std::min<size_t>(nConcurrency - 1, vReq.size() - 1);
+    size_t nQueued = 0;
+    {
+        LOCK(cs);
+        for (; fRunning && nQueued < nHelpers; nQueued++) {
+            if (queue.size() >= nMaxQueue) {
+                nQueueFull++;
+                break;
+            }
+            queue.push_back(batch);
+        }
+        cond.notify_all();
+    }
+    if (nQueued > 0) {
+        nParallelBatches++;
+    }
+
+    batch->Run();
+    {
+        WAIT_LOCK(batch->cs, lock);
+        while (batch->nDone < batch->nSize)
+            batch->cond.wait(lock);
+    }
+    return std::move(batch->vResults);
+}
+
+UniValue RPCBatchExecutor::ToJSON() const
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("threads", (uint64_t)threads.size());
+    obj.pushKV("concurrency", nConcurrency);
+    obj.pushKV("batches", nBatches.load());
+    obj.pushKV("parallel", nParallelBatches.load());
+    obj.pushKV("calls", nCalls.load());
+    obj.pushKV("offloaded", nOffloaded.load());
+    obj.pushKV("queue_full", nQueueFull.load());
+    return obj;
+}
+
 std::string JSONRPCExecBatch(const JSONRPCRequest& jreq, const UniValue& vReq)
 {
     UniValue ret(UniValue::VARR);
+    // SYSCOIN
+    if (vReq.size() > 1 && g_rpc_batch_executor.IsRunning()) {
+        for (const UniValue& result : g_rpc_batch_executor.Execute(jreq, vReq)) {
+            ret.push_back(result);
+        }
+        return ret.write() + "\n";
+    }
     for (unsigned int reqIdx = 0; reqIdx < vReq.size(); reqIdx++)
         ret.push_back(JSONRPCExecOne(jreq, vReq[reqIdx]));
 
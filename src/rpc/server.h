@@ -17,6 +17,11 @@
 #include <univalue.h>
 
 static const unsigned int DEFAULT_RPC_SERIALIZE_VERSION = 1;
+// SYSCOIN
+/** Default for -rpcbatchthreads, threads the calls of a JSON-RPC batch fan out to, 0 runs them one after another */
+static const int DEFAULT_RPC_BATCH_THREADS = 0;
+/** Default for -rpcbatchconcurrency, the most calls of one batch running at once */
+static const int DEFAULT_RPC_BATCH_CONCURRENCY = 4;
 
 class CRPCCommand;
 
@@ -11,6 +11,7 @@
 #include <wallet/wallet.h>
 #endif
 #include <services/rpc/assetrpc.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <chainparams.h>
 extern std::string EncodeDestination(const CTxDestination& dest);
@@ -288,6 +289,21 @@ bool CAsset::UnserializeFromTx(const CTransaction &tx) {
 	}
     return true;
 }
+CSyscoinPayload::CSyscoinPayload(const CTransaction &tx) {
+    if(IsAssetAllocationTx(tx.nVersion) || tx.nVersion == SYSCOIN_TX_VERSION_ASSET_SEND)
+        assetAllocation.UnserializeFromTx(tx);
+    else if(IsSyscoinMintTx(tx.nVersion))
+        mintSyscoin.UnserializeFromTx(tx);
+}
+std::shared_ptr<const CSyscoinPayload> GetSyscoinPayload(const CTransaction& tx) {
+    std::shared_ptr<const CSyscoinPayload> payload = std::atomic_load(&tx.m_syscoin_payload);
+    if(!payload){
+        payload = std::make_shared<const CSyscoinPayload>(tx);
+        // threads racing here parse the same bytes, keeping either result is fine
+        std::atomic_store(&tx.m_syscoin_payload, payload);
+    }
+    return payload;
+}
 bool CMintSyscoin::UnserializeFromTx(const CTransaction &tx) {
     vector<unsigned char> vchData;
     int nOut;
@@ -739,7 +755,7 @@ bool CAssetDB::Flush(const AssetMap &mapAssets){
     LogPrint(BCLog::SYS, "Flushing %d assets (erased %d, written %d)\n", mapAssets.size(), erase, write);
     return WriteBatch(batch);
 }
-bool CAssetDB::ScanAssets(const uint32_t count, const uint32_t from, const UniValue& oOptions, UniValue& oRes) {
+bool CAssetDB::ScanAssets(const uint32_t count, const uint32_t from, const UniValue& oOptions, JSONRPCArrayResult& oRes) {
 	string strTxid = "";
 	vector<CWitnessAddress > vecWitnessAddresses;
     uint32_t nAsset = 0;
@@ -813,7 +829,7 @@ bool CAssetDB::ScanAssets(const uint32_t count, const uint32_t from, const UniVa
 	}
 	return true;
 }
-bool CAssetIndexDB::ScanAssetIndex(uint32_t page, const UniValue& oOptions, UniValue& oRes) {	
+bool CAssetIndexDB::ScanAssetIndex(uint32_t page, const UniValue& oOptions, JSONRPCArrayResult& oRes) {	
     CAssetAllocationTuple assetTuple;	
     uint32_t nAsset = 0;	
     if (!oOptions.isNull()) {	
@@ -7,12 +7,15 @@
 
 
 #include <dbwrapper.h>
+#include <services/dbbudget.h>
 #include <script/standard.h>
 #include <serialize.h>
 #include <primitives/transaction.h>
 #include <services/assetallocation.h>
 #include <sys/types.h>
 #include <univalue.h>
+// SYSCOIN
+class JSONRPCArrayResult;
 #ifdef ENABLE_WALLET
 #include <wallet/ismine.h>
 #endif
@@ -188,10 +191,25 @@ public:
     bool UnserializeFromTx(const CTransaction &tx);
     void Serialize(std::vector<unsigned char>& vchData);
 };
+/**
+ * The Syscoin payload of a transaction in parsed form. It is built once per transaction by
+ * GetSyscoinPayload() and shared read only by everyone looking at that transaction afterwards.
+ */
+class CSyscoinPayload {
+public:
+    // set for asset allocation and asset send transactions
+    CAssetAllocation assetAllocation;
+    // set for mint transactions
+    CMintSyscoin mintSyscoin;
+    explicit CSyscoinPayload(const CTransaction &tx);
+    CSyscoinPayload(const CSyscoinPayload&) = delete;
+    CSyscoinPayload& operator=(const CSyscoinPayload&) = delete;
+};
+std::shared_ptr<const CSyscoinPayload> GetSyscoinPayload(const CTransaction& tx);
 typedef std::unordered_map<uint32_t, CAsset > AssetMap;
 class CAssetDB : public CDBWrapper {
 public:
-    CAssetDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assets", nCacheSize, fMemory, fWipe) {}
+    CAssetDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assets", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("assets")) {}
     bool EraseAsset(const uint32_t& nAsset) {
         return Erase(nAsset);
     }   
@@ -205,12 +223,12 @@ public:
         return Exists(address);	
     }   	
 	bool WriteAssetIndex(const CTransaction& tx, const uint256& txid, const CAsset& dbAsset, const int& nHeight, const uint256& blockhash);
-	bool ScanAssets(const uint32_t count, const uint32_t from, const UniValue& oOptions, UniValue& oRes);
+	bool ScanAssets(const uint32_t count, const uint32_t from, const UniValue& oOptions, JSONRPCArrayResult& oRes);
     bool Flush(const AssetMap &mapAssets);
 };
 class CAssetIndexDB : public CDBWrapper {	
 public:	
-    CAssetIndexDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assetindex", nCacheSize, fMemory, fWipe) {	
+    CAssetIndexDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assetindex", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("assetindex")) {	
     }	
     bool ReadIndexTXIDs(const CAssetAllocationTuple& allocationTuple, const uint32_t &page, std::vector<uint256> &TXIDS) {	
         return Read(std::make_pair(allocationTuple.ToString(), page), TXIDS);	
@@ -332,7 +350,7 @@ public:
         bool res = Read(txid, strPayload);	
         return res && payload.read(strPayload);	
     }        	
-    bool ScanAssetIndex(uint32_t page, const UniValue& oOptions, UniValue& oRes);	
+    bool ScanAssetIndex(uint32_t page, const UniValue& oOptions, JSONRPCArrayResult& oRes);	
     bool FlushErase(const std::vector<uint256> &vecTXIDs);	
 };
 static CAsset emptyAsset;
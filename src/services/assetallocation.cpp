@@ -12,6 +12,7 @@
 #include <wallet/wallet.h>
 #endif
 #include <services/rpc/assetrpc.h>
+#include <rpc/jsonstream.h>
 #include <rpc/server.h>
 #include <chainparams.h>
 extern std::string EncodeDestination(const CTxDestination& dest);
@@ -486,7 +487,8 @@ bool AssetAllocationTxToJSON(const CTransaction &tx, const CAsset& dbAsset, cons
 }
 
 bool AssetMintTxToJson(const CTransaction& tx, const uint256& txHash, UniValue &entry){
-    CMintSyscoin mintsyscoin(tx);
+    const auto payload = GetSyscoinPayload(tx);
+    const CMintSyscoin &mintsyscoin = payload->mintSyscoin;
     if (!mintsyscoin.IsNull() && !mintsyscoin.assetAllocationTuple.IsNull()) {
         int nHeight = 0;
         CBlockIndex* blockindex = nullptr;
@@ -672,7 +674,7 @@ bool CAssetAllocationDB::Flush(const AssetAllocationMap &mapAssetAllocations){
 	LogPrint(BCLog::SYS, "Flushing %d assets allocations (erased %d, written %d)\n", mapAssetAllocations.size(), erase, write);
     return WriteBatch(batch);
 }
-bool CAssetAllocationDB::ScanAssetAllocations(const uint32_t count, const uint32_t from, const UniValue& oOptions, UniValue& oRes) {
+bool CAssetAllocationDB::ScanAssetAllocations(const uint32_t count, const uint32_t from, const UniValue& oOptions, JSONRPCArrayResult& oRes) {
 	string strTxid = "";
 	vector<CWitnessAddress> vecWitnessAddresses;
 	uint32_t nAsset = 0;
@@ -747,27 +749,30 @@ bool CAssetAllocationDB::ScanAssetAllocations(const uint32_t count, const uint32
 }
 void GetActorsFromSyscoinTx(const CTransactionRef& txRef, bool bJustSender, bool bGetAddress, ActorSet& actorSet){
     if(IsSyscoinMintTx(txRef->nVersion)){
-        CMintSyscoin theMintSyscoin(*txRef);
+        const auto payload = GetSyscoinPayload(*txRef);
+        const CMintSyscoin &theMintSyscoin = payload->mintSyscoin;
         if(!theMintSyscoin.IsNull())
             GetActorsFromMintTx(theMintSyscoin, bJustSender, bGetAddress, actorSet);
     }
     else if(IsAssetTx(txRef->nVersion)){
         CAsset theAsset;
-        CAssetAllocation theAssetAllocation;
         if(txRef->nVersion == SYSCOIN_TX_VERSION_ASSET_SEND){
-            theAssetAllocation = CAssetAllocation(*txRef);
+            const auto payload = GetSyscoinPayload(*txRef);
+            const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
             if(!theAssetAllocation.assetAllocationTuple.IsNull())
                 GetActorsFromAssetTx(theAsset, theAssetAllocation, txRef->nVersion, bJustSender, bGetAddress, actorSet);
                 
         }
         else{
+            CAssetAllocation theAssetAllocation;
             theAsset = CAsset(*txRef);
             if(!theAsset.IsNull())
                 GetActorsFromAssetTx(theAsset, theAssetAllocation, txRef->nVersion, bJustSender, bGetAddress, actorSet);
         }
     }
     else if(IsAssetAllocationTx(txRef->nVersion)){
-        CAssetAllocation theAssetAllocation(*txRef);
+        const auto payload = GetSyscoinPayload(*txRef);
+        const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
         if(!theAssetAllocation.assetAllocationTuple.IsNull())
             GetActorsFromAssetAllocationTx(theAssetAllocation, txRef->nVersion, bJustSender, bGetAddress, actorSet);
     }
@@ -880,8 +885,79 @@ void CAssetAllocationDBEntry::SerializationOp(Stream& s, Operation ser_action) {
             READWRITE(lockedOutpoint);
     }
 }
+bool GetAssetAllocationDeltas(const CTransaction &tx, uint32_t &nAsset, std::vector<std::pair<CWitnessAddress, CAmount> > &vecDeltas){
+    const auto payload = GetSyscoinPayload(tx);
+    if(IsSyscoinMintTx(tx.nVersion)){
+        const CMintSyscoin &mintSyscoin = payload->mintSyscoin;
+        if(mintSyscoin.IsNull() || mintSyscoin.assetAllocationTuple.IsNull())
+            return false;
+        nAsset = mintSyscoin.assetAllocationTuple.nAsset;
+        vecDeltas.emplace_back(mintSyscoin.assetAllocationTuple.witnessAddress, mintSyscoin.nValueAsset);
+    }
+    else if(IsAssetAllocationTx(tx.nVersion) || tx.nVersion == SYSCOIN_TX_VERSION_ASSET_SEND){
+        const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
+        if(theAssetAllocation.assetAllocationTuple.IsNull() || theAssetAllocation.listSendingAllocationAmounts.empty())
+            return false;
+        nAsset = theAssetAllocation.assetAllocationTuple.nAsset;
+        CAmount nTotal = 0;
+        for(const auto& amountTuple: theAssetAllocation.listSendingAllocationAmounts){
+            nTotal += amountTuple.second;
+            vecDeltas.emplace_back(amountTuple.first, amountTuple.second);
+        }
+        // asset sends are paid out of the asset supply, not an allocation
+        if(tx.nVersion != SYSCOIN_TX_VERSION_ASSET_SEND)
+            vecDeltas.emplace_back(theAssetAllocation.assetAllocationTuple.witnessAddress, -nTotal);
+    }
+    else
+        return false;
+    return true;
+}
+bool BuildAssetAllocationDeltaEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent){
+    uint32_t nAsset = 0;
+    std::vector<std::pair<CWitnessAddress, CAmount> > vecDeltas;
+    if(!GetAssetAllocationDeltas(tx, nAsset, vecDeltas))
+        return false;
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << tx.GetHash() << nStatus << nAsset << vecDeltas;
+    strEvent = ss.str();
+    return true;
+}
+bool BuildAssetMintEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent){
+    if(!IsSyscoinMintTx(tx.nVersion))
+        return false;
+    const auto payload = GetSyscoinPayload(tx);
+    const CMintSyscoin &mintSyscoin = payload->mintSyscoin;
+    if(mintSyscoin.IsNull() || mintSyscoin.assetAllocationTuple.IsNull())
+        return false;
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << tx.GetHash() << nStatus << mintSyscoin.assetAllocationTuple.nAsset << mintSyscoin.assetAllocationTuple.witnessAddress << mintSyscoin.nValueAsset << mintSyscoin.nBlockNumber;
+    strEvent = ss.str();
+    return true;
+}
+bool BuildAssetBurnEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent){
+    if(tx.nVersion != SYSCOIN_TX_VERSION_ALLOCATION_BURN_TO_ETHEREUM)
+        return false;
+    uint32_t nAsset;
+    CWitnessAddress burnWitnessAddress;
+    CAmount nAmount;
+    std::vector<unsigned char> vchEthAddress;
+    std::vector<unsigned char> vchEthContract;
+    uint8_t nPrecision;
+    if(!GetSyscoinBurnData(tx, nAsset, burnWitnessAddress, nAmount, vchEthAddress, nPrecision, vchEthContract))
+        return false;
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << tx.GetHash() << nStatus << nAsset << burnWitnessAddress << nAmount << vchEthAddress << vchEthContract;
+    strEvent = ss.str();
+    return true;
+}
+std::string BuildAssetZdagConflictEvent(const uint256 &txHash, const std::string &strSender){
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << txHash << strSender;
+    return ss.str();
+}
 std::string GetSenderOfZdagTx(const CTransaction &tx){
-    CAssetAllocation theAssetAllocation(tx);
+    const auto payload = GetSyscoinPayload(tx);
+    const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
     if(theAssetAllocation.assetAllocationTuple.IsNull()){
         return "";
     }
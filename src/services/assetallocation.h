@@ -6,11 +6,13 @@
 #define SYSCOIN_SERVICES_ASSETALLOCATION_H
 
 #include <dbwrapper.h>
+#include <services/dbbudget.h>
 #include <primitives/transaction.h>
 #include <unordered_map>
 #include <unordered_set>
 #include <txmempool.h>
 #include <services/witnessaddress.h>
+class JSONRPCArrayResult;
 #ifdef ENABLE_WALLET
 #include <wallet/ismine.h>
 #endif
@@ -162,7 +164,7 @@ typedef std::unordered_map<std::string, CAssetAllocationDBEntry > AssetAllocatio
 typedef std::unordered_map<std::string, COutPoint > AssetPrevTxMap;
 class CAssetAllocationDB : public CDBWrapper {
 public:
-	CAssetAllocationDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assetallocations", nCacheSize, fMemory, fWipe) {}
+	CAssetAllocationDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "assetallocations", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("assetallocations")) {}
     
     bool ReadAssetAllocation(const CAssetAllocationTuple& assetAllocationTuple, CAssetAllocationDBEntry& assetallocation) {
         return Read(assetAllocationTuple, assetallocation);
@@ -176,7 +178,7 @@ public:
 	bool WriteAssetAllocationIndex(const CTransaction &tx, const uint256& txHash, const CAsset& dbAsset, const int &nHeight, const uint256& blockhash);	
     bool WriteMintIndex(const CTransaction& tx, const uint256& txHash, const CMintSyscoin& mintSyscoin, const int &nHeight, const uint256& blockhash);
     bool Flush(const AssetAllocationMap &mapAssetAllocations);
-	bool ScanAssetAllocations(const uint32_t count, const uint32_t from, const UniValue& oOptions, UniValue& oRes);
+	bool ScanAssetAllocations(const uint32_t count, const uint32_t from, const UniValue& oOptions, JSONRPCArrayResult& oRes);
 };
 
 class CAssetAllocationMempoolDB : public CDBWrapper {
@@ -220,4 +222,25 @@ bool WriteAssetIndexForAllocation(const CAssetAllocation& assetallocation, const
 bool WriteAssetIndexForAllocation(const CMintSyscoin& mintSyscoin, const uint256& txid, const UniValue& oName);	
 bool WriteAssetAllocationIndexTXID(const CAssetAllocationTuple& allocationTuple, const uint256& txid);
 std::string GetSenderOfZdagTx(const CTransaction &tx);
+/**
+ * Allocation balance changes made by a mint, asset send or asset allocation transaction: receivers gain their
+ * amount and the sending allocation (if any) loses the total. Returns false for other transactions
+ */
+bool GetAssetAllocationDeltas(const CTransaction &tx, uint32_t &nAsset, std::vector<std::pair<CWitnessAddress, CAmount> > &vecDeltas);
+/** Where the transaction of a binary asset event stands */
+static const uint8_t SYSCOIN_EVENT_MEMPOOL = 0;
+static const uint8_t SYSCOIN_EVENT_CONNECTED = 1;
+static const uint8_t SYSCOIN_EVENT_DISCONNECTED = 2;
+/**
+ * Binary asset events published over zmq, all of them start with the txid and the event status:
+ * assetallocationdelta: asset guid followed by the allocations of the asset and their balance change
+ * assetmint: asset guid, receiving address, amount and Ethereum block number of the mint
+ * assetburn: asset guid, burning address, amount, Ethereum destination address and contract
+ * Each returns false if the transaction has nothing to report on that topic.
+ */
+bool BuildAssetAllocationDeltaEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent);
+bool BuildAssetMintEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent);
+bool BuildAssetBurnEvent(const CTransaction &tx, const uint8_t &nStatus, std::string &strEvent);
+/** assetzdagconflict: txid and allocation of a zdag double spend */
+std::string BuildAssetZdagConflictEvent(const uint256 &txHash, const std::string &strSender);
 #endif // SYSCOIN_SERVICES_ASSETALLOCATION_H
@@ -15,6 +15,8 @@
 #include <services/rpc/assetrpc.h>
 #include <validationinterface.h>
 #include <utility> // std::unique
+#include <thread>
+#include <txdb.h>
 extern AssetBalanceMap mempoolMapAssetBalances;
 extern ArrivalTimesSetImpl arrivalTimesSet;
 extern std::unordered_set<std::string> assetAllocationConflicts;
@@ -47,7 +49,8 @@ bool CheckSyscoinMint(const bool &ibd, const CTransaction& tx, const uint256& tx
             ::ChainActive().Tip()->nHeight, txHash.ToString().c_str(),
             fJustCheck ? "JUSTCHECK" : "BLOCK", bSanityCheck? 1: 0);
     // unserialize mint object from txn, check for valid
-    CMintSyscoin mintSyscoin(tx);
+    const auto payload = GetSyscoinPayload(tx);
+    const CMintSyscoin &mintSyscoin = payload->mintSyscoin;
     CAsset dbAsset;
     if(mintSyscoin.IsNull())
     {
@@ -349,7 +352,8 @@ bool CheckSyscoinInputs(const bool &ibd, const CTransaction& tx, const uint256&
     try{
         if (IsAssetAllocationTx(tx.nVersion))
         {
-            CAssetAllocation theAssetAllocation(tx);
+            const auto payload = GetSyscoinPayload(tx);
+            const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
             if(theAssetAllocation.assetAllocationTuple.IsNull()){
                 return FormatSyscoinErrorMessage(state, "assetallocation-unserialize", bSanityCheck);
             }
@@ -386,6 +390,11 @@ void SetZDAGConflict(const uint256 &txHash, const std::string &fSyscoinSender){
         LogPrint(BCLog::SYS, "Double spend detected on tx %s!\n", txHash.GetHex());
         setToRemoveFromMempool.insert(txHash);
     }
+    if(fZMQAssetZdagConflict){
+        GetMainSignals().NotifySyscoinUpdate("assetzdagconflict", [txHash, fSyscoinSender]() -> std::string {
+            return BuildAssetZdagConflictEvent(txHash, fSyscoinSender);
+        });
+    }
 }
 void AddZDAGTx(const CTransactionRef &zdagTx, const AssetBalanceMap &mapAssetAllocationBalances) {
     const uint256 &txHash = zdagTx->GetHash();
@@ -442,7 +451,8 @@ void RemoveZDAGTx(const CTransactionRef &zdagTx) {
     
 }
 bool DisconnectMintAsset(const CTransaction &tx, const uint256& txHash, AssetAllocationMap &mapAssetAllocations, EthereumMintTxVec &vecMintKeys){
-    CMintSyscoin mintSyscoin(tx);
+    const auto payload = GetSyscoinPayload(tx);
+    const CMintSyscoin &mintSyscoin = payload->mintSyscoin;
     if(mintSyscoin.IsNull())
     {
         LogPrint(BCLog::SYS,"DisconnectMintAsset: Cannot unserialize data inside of this transaction relating to an assetallocationmint\n");
@@ -626,7 +636,8 @@ bool DisconnectSyscoinTransaction(const CTransaction& tx, const uint256& txHash,
     else{
         if (IsAssetAllocationTx(tx.nVersion))
         {
-            CAssetAllocation theAssetAllocation(tx);
+            const auto payload = GetSyscoinPayload(tx);
+            const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
             if(theAssetAllocation.assetAllocationTuple.IsNull()){
                 LogPrint(BCLog::SYS,"DisconnectAssetAllocation: Could not decode asset allocation\n");
                 return false;
@@ -662,6 +673,75 @@ CAmount FindBurnAmountFromTx(const CTransaction& tx){
     }
     return 0;
 }
+size_t PrefetchAssetAllocations(const CBlock& block, AssetAllocationMap &mapAssetAllocations){
+    if(passetallocationdb == nullptr)
+        return 0;
+    // collect every sender and receiver the allocation transactions of this block will look up
+    std::vector<CAssetAllocationTuple> vecTuples;
+    std::vector<std::string> vecTupleStrs;
+    std::unordered_set<std::string> setSeen;
+    for (const auto& txRef : block.vtx) {
+        if (!IsAssetAllocationTx(txRef->nVersion))
+            continue;
+        const auto payload = GetSyscoinPayload(*txRef);
+        const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
+        if(theAssetAllocation.assetAllocationTuple.IsNull())
+            continue;
+        const uint32_t &nAsset = theAssetAllocation.assetAllocationTuple.nAsset;
+        std::string senderTupleStr = theAssetAllocation.assetAllocationTuple.ToString();
+        if(!mapAssetAllocations.count(senderTupleStr) && setSeen.insert(senderTupleStr).second){
+            vecTupleStrs.emplace_back(std::move(senderTupleStr));
+            vecTuples.emplace_back(nAsset, theAssetAllocation.assetAllocationTuple.witnessAddress);
+        }
+        for (const auto& amountTuple : theAssetAllocation.listSendingAllocationAmounts) {
+            CAssetAllocationTuple receiverAllocationTuple(nAsset, amountTuple.first);
+            std::string receiverTupleStr = receiverAllocationTuple.ToString();
+            if(!mapAssetAllocations.count(receiverTupleStr) && setSeen.insert(receiverTupleStr).second){
+                vecTupleStrs.emplace_back(std::move(receiverTupleStr));
+                vecTuples.emplace_back(std::move(receiverAllocationTuple));
+            }
+        }
+    }
+    const size_t nKeys = vecTuples.size();
+    if(nKeys == 0)
+        return 0;
+
+    // leveldb reads are thread safe, split large batches over a few threads
+    std::vector<CAssetAllocationDBEntry> vecEntries(nKeys);
+    std::vector<char> vecFound(nKeys, 0);
+    auto readRange = [&](size_t nBegin, size_t nEnd) {
+        for (size_t i = nBegin; i < nEnd; i++) {
+            try {
+                vecFound[i] = passetallocationdb->ReadAssetAllocation(vecTuples[i], vecEntries[i]);
+            } catch (...) {
+                // leave it to the lookup in CheckAssetAllocationInputs which reports db errors
+                vecFound[i] = 0;
+            }
+        }
+    };
+    const size_t nThreads = std::min<size_t>({(size_t)std::max(GetNumCores(), 1), MAX_ALLOCATION_PREFETCH_THREADS, (nKeys + MIN_ALLOCATION_PREFETCH_PER_THREAD - 1) / MIN_ALLOCATION_PREFETCH_PER_THREAD});
+    if(nThreads <= 1){
+        readRange(0, nKeys);
+    }
+    else{
+        const size_t nPerThread = (nKeys + nThreads - 1) / nThreads;
+        std::vector<std::thread> vecThreads;
+        vecThreads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; t++) {
+            vecThreads.emplace_back(readRange, std::min(nKeys, t * nPerThread), std::min(nKeys, (t + 1) * nPerThread));
+        }
+        readRange(0, std::min(nKeys, nPerThread));
+        for (auto& thread : vecThreads) {
+            thread.join();
+        }
+    }
+    // only existing allocations are cached, missing ones keep their per transaction handling
+    for (size_t i = 0; i < nKeys; i++) {
+        if(vecFound[i])
+            mapAssetAllocations.emplace(std::move(vecTupleStrs[i]), std::move(vecEntries[i]));
+    }
+    return nKeys;
+}
 bool CheckAssetAllocationInputs(const CTransaction &tx, const uint256& txHash, const CAssetAllocation &theAssetAllocation, TxValidationState &state, const CCoinsViewCache &inputs,
         const bool &fJustCheck, const int &nHeight, const uint256& blockhash, AssetAllocationMap &mapAssetAllocations, AssetBalanceMap &mapAssetAllocationBalances, std::vector<COutPoint> &vecLockedOutpoints, const bool &bSanityCheck) {
     if (passetallocationdb == nullptr)
@@ -1040,7 +1120,8 @@ bool CheckAssetAllocationInputs(const CTransaction &tx, const uint256& txHash, c
 
 bool DisconnectAssetSend(const CTransaction &tx, const uint256& txid, AssetMap &mapAssets, AssetAllocationMap &mapAssetAllocations){
     CAsset dbAsset;
-    CAssetAllocation theAssetAllocation(tx);
+    const auto payload = GetSyscoinPayload(tx);
+    const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
     if(theAssetAllocation.assetAllocationTuple.IsNull()){
         LogPrint(BCLog::SYS,"DisconnectAssetSend: Could not decode asset allocation in asset send\n");
         return false;
@@ -1547,6 +1628,22 @@ bool CBlockIndexDB::FlushWrite(const std::vector<std::pair<uint256, uint256> > &
     LogPrint(BCLog::SYS, "Flush writing %d block indexes\n", blockIndex.size());
     return WriteBatch(batch);
 }
+bool CLockedOutpointsDB::Init() {
+	std::vector<COutPoint> vecOutpoints;
+	std::unique_ptr<CDBIterator> pcursor(NewIterator());
+	COutPoint outpoint;
+	bool locked;
+	for (pcursor->SeekToFirst(); pcursor->Valid(); pcursor->Next()) {
+		// skips the obfuscation key, which doesn't deserialize as an outpoint
+		if (pcursor->GetKey(outpoint) && pcursor->GetValue(locked) && locked)
+			vecOutpoints.emplace_back(outpoint);
+	}
+	LOCK(cs_lockedoutpoints);
+	setLockedOutpoints.clear();
+	setLockedOutpoints.insert(vecOutpoints.begin(), vecOutpoints.end());
+	LogPrint(BCLog::SYS, "Loaded %d locked outpoints\n", setLockedOutpoints.size());
+	return true;
+}
 bool CLockedOutpointsDB::FlushErase(const std::vector<COutPoint> &lockedOutpoints) {
 	if (lockedOutpoints.empty())
 		return true;
@@ -1556,7 +1653,13 @@ bool CLockedOutpointsDB::FlushErase(const std::vector<COutPoint> &lockedOutpoint
 		batch.Erase(outpoint);
 	}
 	LogPrint(BCLog::SYS, "Flushing %d locked outpoints removals\n", lockedOutpoints.size());
-	return WriteBatch(batch);
+	if (!WriteBatch(batch))
+		return false;
+	LOCK(cs_lockedoutpoints);
+	for (const auto &outpoint : lockedOutpoints) {
+		setLockedOutpoints.erase(outpoint);
+	}
+	return true;
 }
 bool CLockedOutpointsDB::FlushWrite(const std::vector<COutPoint> &lockedOutpoints) {
 	if (lockedOutpoints.empty())
@@ -1575,13 +1678,23 @@ bool CLockedOutpointsDB::FlushWrite(const std::vector<COutPoint> &lockedOutpoint
 		}
 	}
 	LogPrint(BCLog::SYS, "Flushing %d locked outpoints (erased %d, written %d)\n", lockedOutpoints.size(), erase, write);
-	return WriteBatch(batch);
+	if (!WriteBatch(batch))
+		return false;
+	LOCK(cs_lockedoutpoints);
+	for (const auto &outpoint : lockedOutpoints) {
+		if (outpoint.IsNull())
+			setLockedOutpoints.erase(outpoint);
+		else
+			setLockedOutpoints.insert(outpoint);
+	}
+	return true;
 }
 bool CheckSyscoinLockedOutpoints(const CTransactionRef &tx, TxValidationState &state) {
 	// SYSCOIN
 	const CTransaction &myTx = (*tx);
     bool assetAllocationVersion = IsAssetAllocationTx(myTx.nVersion);
-    CAssetAllocation theAssetAllocation(myTx);
+    const auto payload = GetSyscoinPayload(myTx);
+    const CAssetAllocation &theAssetAllocation = payload->assetAllocation;
 	// if not an allocation send ensure the outpoint locked isn't being spent
 	if (!assetAllocationVersion && theAssetAllocation.assetAllocationTuple.IsNull()) {
 		for (unsigned int i = 0; i < myTx.vin.size(); i++)
@@ -1809,3 +1922,88 @@ bool CEthereumMintedTxDB::FlushErase(const EthereumMintTxVec &vecMintKeys){
     LogPrint(BCLog::SYS, "Flushing, erasing %d ethereum tx mints\n", vecMintKeys.size());
     return WriteBatch(batch);
 }
+std::vector<CDBWrapper*> GetSnapshotAssetDBs() {
+    return {passetdb.get(), passetallocationdb.get(), plockedoutpointsdb.get(), pethereumtxmintdb.get()};
+}
+uint64_t WriteAssetSnapshot(CHashedSourceWriter<CAutoFile>& writer, std::vector<std::unique_ptr<CDBIterator> >& vecCursors) {
+    const std::vector<CDBWrapper*> vecDBs = GetSnapshotAssetDBs();
+    assert(vecCursors.size() == vecDBs.size());
+    uint64_t nEntries = 0;
+    std::vector<unsigned char> vchKey, vchValue;
+    for (size_t i = 0; i < vecDBs.size(); i++) {
+        CDBIterator* pcursor = vecCursors[i].get();
+        for (pcursor->SeekToFirst(); pcursor->Valid(); pcursor->Next()) {
+            pcursor->GetRaw(vchKey, vchValue);
+            // the obfuscation key belongs to this database, the loading node keeps its own
+            if (vecDBs[i]->IsObfuscateKeyEntry(vchKey))
+                continue;
+            writer << vchKey << vchValue;
+            nEntries++;
+        }
+        writer << std::vector<unsigned char>();
+    }
+    return nEntries;
+}
+// set in the asset database while a snapshot is loaded into the asset databases
+static const char DB_ASSET_SNAPSHOT_LOADING = 'L';
+static bool IsAssetSnapshotLoadingKey(const CDBWrapper& db, const std::vector<unsigned char>& vchKey) {
+    return &db == passetdb.get() && vchKey.size() == 1 && vchKey[0] == DB_ASSET_SNAPSHOT_LOADING;
+}
+bool IsAssetSnapshotLoading() {
+    return passetdb && passetdb->Exists(DB_ASSET_SNAPSHOT_LOADING);
+}
+// erase everything but the obfuscation key and the loading flag
+static void ClearAssetDB(CDBWrapper& db, const size_t nBatchSize) {
+    std::unique_ptr<CDBIterator> pcursor(db.NewIterator());
+    CDBBatch batch(db);
+    std::vector<unsigned char> vchKey, vchValue;
+    for (pcursor->SeekToFirst(); pcursor->Valid(); pcursor->Next()) {
+        pcursor->GetRaw(vchKey, vchValue);
+        if (db.IsObfuscateKeyEntry(vchKey) || IsAssetSnapshotLoadingKey(db, vchKey))
+            continue;
+        batch.Erase(MakeSpan(vchKey));
+        if (batch.SizeEstimate() > nBatchSize) {
+            db.WriteBatch(batch);
+            batch.Clear();
+        }
+    }
+    db.WriteBatch(batch);
+}
+uint64_t ReadAssetSnapshot(CHashVerifier<CAutoFile>& verifier, bool fLoad) {
+    const size_t nBatchSize = (size_t)gArgs.GetArg("-dbbatchsize", nDefaultDbBatchSize);
+    if (fLoad) {
+        // flag the databases first, from here on they only hold the whole snapshot once the flag is erased again
+        passetdb->Write(DB_ASSET_SNAPSHOT_LOADING, '1', true);
+    }
+    uint64_t nEntries = 0;
+    std::vector<unsigned char> vchKey, vchValue;
+    for (CDBWrapper* pdb : GetSnapshotAssetDBs()) {
+        std::unique_ptr<CDBBatch> batch;
+        if (fLoad) {
+            ClearAssetDB(*pdb, nBatchSize);
+            batch = MakeUnique<CDBBatch>(*pdb);
+        }
+        while (true) {
+            verifier >> vchKey;
+            if (vchKey.empty())
+                break;
+            verifier >> vchValue;
+            nEntries++;
+            if (!batch)
+                continue;
+            batch->Write(MakeSpan(vchKey), MakeSpan(vchValue));
+            if (batch->SizeEstimate() > nBatchSize) {
+                pdb->WriteBatch(*batch);
+                batch->Clear();
+            }
+        }
+        if (batch)
+            pdb->WriteBatch(*batch, true);
+    }
+    return nEntries;
+}
+void FinishAssetSnapshotLoad() {
+    if (plockedoutpointsdb)
+        plockedoutpointsdb->Init();
+    passetdb->Erase(DB_ASSET_SNAPSHOT_LOADING, true);
+}
@@ -8,10 +8,16 @@
 
 #include <primitives/transaction.h>
 #include <services/asset.h>
+#include <hash.h>
+#include <streams.h>
+#include <coins.h>
+#include <sync.h>
+#include <unordered_set>
 class TxValidationState;
+class CBlock;
 class CBlockIndexDB : public CDBWrapper {
 public:
-    CBlockIndexDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blockindex", nCacheSize, fMemory, fWipe) {}
+    CBlockIndexDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "blockindex", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("blockindex")) {}
     
     bool ReadBlockHash(const uint256& txid, uint256& block_hash){
         return Read(txid, block_hash);
@@ -19,13 +25,29 @@ public:
     bool FlushWrite(const std::vector<std::pair<uint256, uint256> > &blockIndex);
     bool FlushErase(const std::vector<uint256> &vecTXIDs);
 };
+// Locked outpoints are rare, so the full set is kept in memory and lookups never reach the database
 class CLockedOutpointsDB : public CDBWrapper {
+private:
+	mutable Mutex cs_lockedoutpoints;
+	std::unordered_set<COutPoint, SaltedOutpointHasher> setLockedOutpoints GUARDED_BY(cs_lockedoutpoints);
 public:
-	CLockedOutpointsDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "lockedoutpoints", nCacheSize, fMemory, fWipe) {}
+	CLockedOutpointsDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "lockedoutpoints", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("lockedoutpoints")) {
+		Init();
+	}
 
-	bool ReadOutpoint(const COutPoint& outpoint, bool& locked) {
-		return Read(outpoint, locked);
+	bool ReadOutpoint(const COutPoint& outpoint, bool& locked) const {
+		LOCK(cs_lockedoutpoints);
+		if (setLockedOutpoints.count(outpoint) == 0)
+			return false;
+		locked = true;
+		return true;
+	}
+	size_t GetLockedOutpointCount() const {
+		LOCK(cs_lockedoutpoints);
+		return setLockedOutpoints.size();
 	}
+	// (re)build the in-memory set from the database, needed after it was written to directly
+	bool Init();
 	bool FlushWrite(const std::vector<COutPoint> &lockedOutpoints);
 	bool FlushErase(const std::vector<COutPoint> &lockedOutpoints);
 };
@@ -50,7 +72,7 @@ class EthereumTxRoot {
 typedef std::unordered_map<uint32_t, EthereumTxRoot> EthereumTxRootMap;
 class CEthereumTxRootsDB : public CDBWrapper {
 public:
-    CEthereumTxRootsDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "ethereumtxroots", nCacheSize, fMemory, fWipe) {
+    CEthereumTxRootsDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "ethereumtxroots", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("ethereumtxroots")) {
        Init();
     } 
     bool ReadTxRoots(const uint32_t& nHeight, EthereumTxRoot& txRoot) {
@@ -66,7 +88,7 @@ public:
 typedef std::vector<std::pair<std::pair<std::vector<unsigned char>, uint32_t>, uint256> > EthereumMintTxVec;
 class CEthereumMintedTxDB : public CDBWrapper {
 public:
-    CEthereumMintedTxDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "ethereumminttx", nCacheSize, fMemory, fWipe) {
+    CEthereumMintedTxDB(size_t nCacheSize, bool fMemory, bool fWipe) : CDBWrapper(GetDataDir() / "ethereumminttx", nCacheSize, fMemory, fWipe, false, syscoindbbudget.GetTuning("ethereumminttx")) {
     } 
     bool ExistsKey(const std::vector<unsigned char> &ethTxid) {
         return Exists(ethTxid);
@@ -97,9 +119,34 @@ bool CheckSyscoinInputs(const CTransaction& tx, const uint256& txHash, TxValidat
 bool CheckSyscoinInputs(const bool &ibd, const CTransaction& tx, const uint256& txHash, TxValidationState &tstate, const CCoinsViewCache &inputs, const bool &fJustCheck, const int &nHeight, const int64_t& nTime, const uint256 & blockHash, const bool &bSanityCheck, AssetAllocationMap &mapAssetAllocations, AssetBalanceMap &mapAssetAllocationBalances, AssetMap &mapAssets, EthereumMintTxVec &vecMintKeys, std::vector<COutPoint> &vecLockedOutpoints);
 static CAssetAllocationDBEntry emptyAllocation;
 bool CheckSyscoinLockedOutpoints(const CTransactionRef &tx, TxValidationState &tstate);
+/** Don't split allocation prefetches over more threads than this */
+static const size_t MAX_ALLOCATION_PREFETCH_THREADS = 4;
+/** Minimum number of allocations read by each prefetch thread */
+static const size_t MIN_ALLOCATION_PREFETCH_PER_THREAD = 64;
+/**
+ * Read the sender and receiver allocations of all asset allocation transactions in block from disk
+ * into mapAssetAllocations ahead of CheckAssetAllocationInputs, returns the number of allocations looked up
+ */
+size_t PrefetchAssetAllocations(const CBlock& block, AssetAllocationMap &mapAssetAllocations);
 bool CheckAssetAllocationInputs(const CTransaction &tx, const uint256& txHash, const CAssetAllocation &theAssetAllocation, TxValidationState &tstate, const CCoinsViewCache &inputs, const bool &fJustCheck, const int &nHeight, const uint256& blockhash, AssetAllocationMap &mapAssetAllocations, AssetBalanceMap &mapAssetAllocationBalances, std::vector<COutPoint> &vecLockedOutpoints,  const bool &bSanityCheck = false);
 bool FormatSyscoinErrorMessage(TxValidationState &state, const std::string errorMessage, bool bErrorNotInvalid = true, bool bConsensus = true);
 void RemoveZDAGTx(const CTransactionRef &zdagTx);
 void AddZDAGTx(const CTransactionRef &zdagTx, const AssetBalanceMap &mapAssetAllocationBalances);
 void SetZDAGConflict(const uint256 &txHash, const std::string &fSyscoinSender);
+/**
+ * Syscoin databases carried in a UTXO snapshot after the coins, in snapshot order. Each database is
+ * written as its raw key/value entries in key order followed by an empty key
+ */
+std::vector<CDBWrapper*> GetSnapshotAssetDBs();
+/** Write the asset section of a snapshot from one cursor per GetSnapshotAssetDBs() database, returns the number of entries written */
+uint64_t WriteAssetSnapshot(CHashedSourceWriter<CAutoFile>& writer, std::vector<std::unique_ptr<CDBIterator> >& vecCursors);
+/**
+ * Read the asset section of a snapshot, returns the number of entries read. With fLoad the asset databases are
+ * flagged as loading, cleared and the entries are written to them in -dbbatchsize batches as they are read, the
+ * caller must hold cs_main and call FinishAssetSnapshotLoad() once the snapshot content hash checked out
+ */
+uint64_t ReadAssetSnapshot(CHashVerifier<CAutoFile>& verifier, bool fLoad);
+void FinishAssetSnapshotLoad();
+/** A snapshot load into the asset databases was started but not finished, they hold a partial asset state */
+bool IsAssetSnapshotLoading();
 #endif // SYSCOIN_SERVICES_ASSETCONSENSUS_H
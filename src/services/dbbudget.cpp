@@ -0,0 +1,128 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <services/dbbudget.h>
+
+#include <logging.h>
+#include <util/strencodings.h>
+#include <util/system.h>
+
+#include <leveldb/cache.h>
+
+CSyscoinDBBudget syscoindbbudget;
+
+// number of LevelDB levels reported per database
+static const int DB_LEVELS = 7;
+
+void CSyscoinDBBudget::Init(int64_t nBudgetIn, bool fAssetIndex)
+{
+    // weights follow the load each database sees: allocations change with every asset transfer,
+    // the locked outpoints are kept in memory and the mint and root tables are mostly appended to
+    std::map<std::string, DBShare> mapNewShares = {
+        {"assetallocations", {8, 0, 0}},
+        {"assets", {4, 0, 0}},
+        {"blockindex", {4, 0, 0}},
+        {"ethereumtxroots", {2, 0, 0}},
+        {"ethereumminttx", {1, 0, 0}},
+        {"lockedoutpoints", {1, 0, 0}},
+    };
+    if (fAssetIndex) {
+        // history queries scan ranges of the index, larger blocks mean fewer reads per scan
+        mapNewShares.emplace("assetindex", DBShare{4, 16 * 1024, 0});
+    }
+    for (const std::string& strShare : gArgs.GetArgs("-syscoindbshare")) {
+        const size_t nPos = strShare.find(':');
+        int32_t nWeight;
+        if (nPos == std::string::npos || !ParseInt32(strShare.substr(nPos + 1), &nWeight) || nWeight < 0) {
+            LogPrintf("Ignoring invalid -syscoindbshare=%s\n", strShare);
+            continue;
+        }
+        auto it = mapNewShares.find(strShare.substr(0, nPos));
+        if (it == mapNewShares.end()) {
+            LogPrintf("Ignoring -syscoindbshare for unknown database %s\n", strShare.substr(0, nPos));
+            continue;
+        }
+        it->second.nWeight = nWeight;
+    }
+    int64_t nTotalWeight = 0;
+    for (const auto& share : mapNewShares) {
+        nTotalWeight += share.second.nWeight;
+    }
+    const int64_t nWriteBudget = nBudgetIn / 2;
+    for (auto& share : mapNewShares) {
+        share.second.nCacheSize = nTotalWeight > 0 ? nWriteBudget * share.second.nWeight / nTotalWeight : 0;
+    }
+
+    LOCK(cs_budget);
+    nBudget = nBudgetIn;
+    // databases still open on the previous cache keep it alive until they are closed
+    block_cache = std::shared_ptr<leveldb::Cache>(leveldb::NewLRUCache(nBudgetIn - nWriteBudget));
+    mapShares.swap(mapNewShares);
+    for (const auto& share : mapShares) {
+        LogPrint(BCLog::SYS, "%s: %s gets %.1f MiB of write buffers (weight %d)\n", __func__, share.first, share.second.nCacheSize * (1.0 / 1024 / 1024), share.second.nWeight);
+    }
+}
+
+size_t CSyscoinDBBudget::GetCacheSize(const std::string& strName) const
+{
+    LOCK(cs_budget);
+    auto it = mapShares.find(strName);
+    if (it == mapShares.end())
+        return 0;
+    return it->second.nCacheSize;
+}
+
+CDBTuning CSyscoinDBBudget::GetTuning(const std::string& strName) const
+{
+    CDBTuning tuning;
+    LOCK(cs_budget);
+    auto it = mapShares.find(strName);
+    if (it == mapShares.end())
+        return tuning;
+    tuning.block_cache = block_cache;
+    tuning.nBlockSize = it->second.nBlockSize;
+    return tuning;
+}
+
+UniValue CSyscoinDBBudget::ToJSON(const std::vector<const CDBWrapper*>& vecDBs) const
+{
+    LOCK(cs_budget);
+    const size_t nBlockCacheUsage = block_cache ? block_cache->TotalCharge() : 0;
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("budget", nBudget);
+    UniValue blockCache(UniValue::VOBJ);
+    blockCache.pushKV("capacity", nBudget - nBudget / 2);
+    blockCache.pushKV("usage", (uint64_t)nBlockCacheUsage);
+    obj.pushKV("block_cache", blockCache);
+    UniValue databases(UniValue::VARR);
+    for (const CDBWrapper* pdb : vecDBs) {
+        if (!pdb)
+            continue;
+        UniValue db(UniValue::VOBJ);
+        db.pushKV("name", pdb->GetName());
+        auto it = mapShares.find(pdb->GetName());
+        const bool fShared = it != mapShares.end();
+        if (fShared) {
+            db.pushKV("weight", it->second.nWeight);
+            db.pushKV("write_buffers", (uint64_t)it->second.nCacheSize);
+        }
+        // the approximate usage of a database includes its block cache, the shared one is reported once above
+        const size_t nUsage = pdb->DynamicMemoryUsage();
+        db.pushKV("memory_usage", (uint64_t)(fShared && nUsage > nBlockCacheUsage ? nUsage - nBlockCacheUsage : nUsage));
+        UniValue files(UniValue::VARR);
+        std::string strValue;
+        for (int i = 0; i < DB_LEVELS; i++) {
+            int32_t nFiles;
+            if (!pdb->GetProperty(strprintf("leveldb.num-files-at-level%d", i), strValue) || !ParseInt32(strValue, &nFiles))
+                nFiles = 0;
+            files.push_back(nFiles);
+        }
+        db.pushKV("files_per_level", files);
+        if (pdb->GetProperty("leveldb.stats", strValue))
+            db.pushKV("stats", strValue);
+        databases.push_back(db);
+    }
+    obj.pushKV("databases", databases);
+    return obj;
+}
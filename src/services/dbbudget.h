@@ -0,0 +1,53 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_SERVICES_DBBUDGET_H
+#define SYSCOIN_SERVICES_DBBUDGET_H
+
+#include <dbwrapper.h>
+#include <sync.h>
+#include <univalue.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+//! max. -dbcache (MiB) given to the Syscoin databases
+static const int64_t nMaxSyscoinDBCache = 1024;
+
+/**
+ * Splits the part of -dbcache reserved for the Syscoin databases between them. Half of the budget
+ * is a block cache all of them share, so it follows whichever database is being read the most.
+ * The other half is divided into write buffers by the weight of each database, which can be
+ * changed with -syscoindbshare=<name>:<weight>.
+ */
+class CSyscoinDBBudget
+{
+private:
+    struct DBShare {
+        int nWeight;
+        size_t nBlockSize;
+        size_t nCacheSize;
+    };
+
+    mutable Mutex cs_budget;
+    int64_t nBudget GUARDED_BY(cs_budget){0};
+    std::shared_ptr<leveldb::Cache> block_cache GUARDED_BY(cs_budget);
+    std::map<std::string, DBShare> mapShares GUARDED_BY(cs_budget);
+
+public:
+    /** Split nBudgetIn bytes between the databases, the asset index only gets a share if it is enabled */
+    void Init(int64_t nBudgetIn, bool fAssetIndex);
+    /** Write buffer budget of a database, passed to its constructor as the cache size */
+    size_t GetCacheSize(const std::string& strName) const;
+    /** Shared block cache and block size of a database, the defaults if Init() wasn't called */
+    CDBTuning GetTuning(const std::string& strName) const;
+    /** Budget, shared block cache usage and per database shares and LevelDB statistics */
+    UniValue ToJSON(const std::vector<const CDBWrapper*>& vecDBs) const;
+};
+
+extern CSyscoinDBBudget syscoindbbudget;
+
+#endif // SYSCOIN_SERVICES_DBBUDGET_H
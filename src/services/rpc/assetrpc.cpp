@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 #include <validation.h>
 #include <boost/algorithm/string.hpp>
+#include <rpc/jsonstream.h>
 #include <rpc/util.h>
 #include <services/assetconsensus.h>
 #include <services/rpc/assetrpc.h>
@@ -13,6 +14,8 @@
 #include <policy/rbf.h>
 #include <chrono>
 #include <consensus/validation.h>
+#include <rpc/blockchain.h>
+#include <services/txload.h>
 using namespace std;
 extern std::string exePath;
 extern std::string EncodeDestination(const CTxDestination& dest);
@@ -28,7 +31,6 @@ extern ArrivalTimesSetImpl arrivalTimesSet;
 extern RecursiveMutex cs_assetallocationmempoolremovetx;
 extern ArrivalTimesSet setToRemoveFromMempool;
 // SYSCOIN service rpc functions
-extern UniValue sendrawtransaction(const JSONRPCRequest& request);
 extern std::vector<std::pair<uint256, int64_t> > vecTPSTestReceivedTimesMempool;
 using namespace std;
 UniValue convertaddress(const JSONRPCRequest& request)	
@@ -201,6 +203,10 @@ bool AssetRange(const CAmount& amount, int precision)
         return false;
     return true;
 }
+static Mutex cs_tpstest;
+// decoded by tpstestadd until the test starts
+static std::vector<CTransactionRef> vecTPSTestTransactions GUARDED_BY(cs_tpstest);
+static std::shared_ptr<const CTxLoadGenerator> pTPSTestLoad GUARDED_BY(cs_tpstest);
 UniValue tpstestinfo(const JSONRPCRequest& request) {
 	const UniValue &params = request.params;
 	if (request.fHelp || 0 != params.size())
@@ -222,6 +228,11 @@ UniValue tpstestinfo(const JSONRPCRequest& request) {
 		oTPSTestReceiversMempool.push_back(oTPSTestStatusObj);
 	}
 	oTPSTestResults.__pushKV("receivers", oTPSTestReceiversMempool);
+	{
+		LOCK(cs_tpstest);
+		if (pTPSTestLoad)
+			oTPSTestResults.__pushKV("load", pTPSTestLoad->ToJSON());
+	}
 	return oTPSTestResults;
 }
 UniValue tpstestsetenabled(const JSONRPCRequest& request) {
@@ -239,25 +250,29 @@ UniValue tpstestsetenabled(const JSONRPCRequest& request) {
 	if (!fTPSTestEnabled) {
 		vecTPSTestReceivedTimesMempool.clear();
 		nTPSTestingStartTime = 0;
+		LOCK(cs_tpstest);
+		vecTPSTestTransactions.clear();
+		pTPSTestLoad.reset();
 	}
 	UniValue result(UniValue::VOBJ);
 	result.__pushKV("status", "success");
 	return result;
 }
-void RunTest(){
-    std::chrono::microseconds duration(nTPSTestingStartTime);
-    std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds> dt(duration);
-    std::this_thread::sleep_until(dt);
-    for (auto &txReq : vecTPSRawTransactions) {
-        sendrawtransaction(txReq);
-    }
+void RunTest(std::vector<CTransactionRef> vecTx, const int64_t nStartTime, const int nThreads){
+    auto pload = std::make_shared<CTxLoadGenerator>(*g_rpc_node, vecTx, nThreads, true /* fRelay */);
+    pload->Run(nStartTime);
     nTPSTestingStartTime = GetTimeMicros();
+    LOCK(cs_tpstest);
+    pTPSTestLoad = pload;
 }
 UniValue tpstestadd(const JSONRPCRequest& request) {
 	const UniValue &params = request.params;
-	if (request.fHelp || 1 > params.size() || params.size() > 2)
-		throw runtime_error("tpstestadd [starttime] [{\"tx\":\"hex\"},...]\n"
+	if (request.fHelp || 1 > params.size() || params.size() > 3)
+		throw runtime_error("tpstestadd [starttime] [{\"tx\":\"hex\"},...] ( threads )\n"
 			"\nAdds raw transactions to the test raw tx queue to be sent to the network at starttime.\n"
+			"The queue is submitted straight to the mempool from several threads and relayed, tpstestinfo reports the latencies.\n"
+			"The relay latency runs from acceptance until the first inv announcing the transaction is pushed to a peer.\n"
+			"Mempool acceptance holds cs_main, so the submitting threads are serialized while a transaction is accepted.\n"
 			"\nArguments:\n"
 			"1. starttime                  (numeric, required) Unix epoch time in micro seconds for when to send the raw transaction queue to the network. If set to 0, will not send transactions until you call this function again with a defined starttime.\n"
 			"2. \"raw transactions\"                (array, not-required) A json array of signed raw transaction strings\n"
@@ -267,6 +282,7 @@ UniValue tpstestadd(const JSONRPCRequest& request) {
 			"       } \n"
 			"       ,...\n"
 			"     ]\n"
+			"3. threads                    (numeric, optional, default=" + itostr(DEFAULT_TXLOAD_THREADS) + ") Number of threads submitting the queue\n"
 			"\nExample:\n"
 			+ HelpExampleCli("tpstestadd", "\"223233433839384\" \"[{\\\"tx\\\":\\\"first raw hex tx\\\"},{\\\"tx\\\":\\\"second raw hex tx\\\"}]\""));
 	if (!fTPSTest)
@@ -274,21 +290,28 @@ UniValue tpstestadd(const JSONRPCRequest& request) {
 
 	nTPSTestingStartTime = params[0].get_int64();
 	UniValue txs;
-	if(params.size() > 1)
+	if(params.size() > 1 && !params[1].isNull())
 		txs = params[1].get_array();
+	const int nThreads = params.size() > 2 ? params[2].get_int() : DEFAULT_TXLOAD_THREADS;
+	if (nThreads < 1)
+		throw JSONRPCError(RPC_INVALID_PARAMETER, "threads must be at least 1");
 	if (fTPSTestEnabled) {
+		// decode up front so the test measures submission only
+		std::vector<CTransactionRef> vecTx;
+		vecTx.reserve(txs.size());
 		for (unsigned int idx = 0; idx < txs.size(); idx++) {
-			const UniValue& tx = txs[idx];
-			UniValue paramsRawTx(UniValue::VARR);
-			paramsRawTx.push_back(find_value(tx.get_obj(), "tx").get_str());
-
-			JSONRPCRequest request;
-			request.params = paramsRawTx;
-			vecTPSRawTransactions.push_back(request);
+			CMutableTransaction mtx;
+			if (!DecodeHexTx(mtx, find_value(txs[idx].get_obj(), "tx").get_str()))
+				throw JSONRPCError(RPC_DESERIALIZATION_ERROR, strprintf("TX decode failed for transaction %d", idx));
+			vecTx.push_back(MakeTransactionRef(std::move(mtx)));
 		}
+		LOCK(cs_tpstest);
+		vecTPSTestTransactions.insert(vecTPSTestTransactions.end(), vecTx.begin(), vecTx.end());
 		if (nTPSTestingStartTime > 0) {
-            std::thread t(RunTest);
-            t.detach();
+			std::vector<CTransactionRef> vecQueued;
+			vecQueued.swap(vecTPSTestTransactions);
+			std::thread t(RunTest, std::move(vecQueued), (int64_t)nTPSTestingStartTime, nThreads);
+			t.detach();
 		}
 	}
 	UniValue result(UniValue::VOBJ);
@@ -655,10 +678,11 @@ UniValue listassetallocations(const JSONRPCRequest& request) {
 	if (params.size() > 2) {
 		options = params[2];
 	}
-	UniValue oRes(UniValue::VARR);
+	// SYSCOIN HTTP clients get the allocations streamed as the scan finds them
+	JSONRPCArrayResult oRes(request);
 	if (!passetallocationdb->ScanAssetAllocations(count, from, options, oRes))
 		throw JSONRPCError(RPC_MISC_ERROR, "Scan failed");
-	return oRes;
+	return oRes.Finish();
 }
 UniValue listassetallocationmempoolbalances(const JSONRPCRequest& request) {
     const UniValue &params = request.params;
@@ -891,10 +915,11 @@ UniValue listassets(const JSONRPCRequest& request) {
     if (params.size() > 2) {
         options = params[2];
     }
-    UniValue oRes(UniValue::VARR);
+    // SYSCOIN HTTP clients get the assets streamed as the scan finds them
+    JSONRPCArrayResult oRes(request);
     if (!passetdb->ScanAssets(count, from, options, oRes))
         throw JSONRPCError(RPC_MISC_ERROR, "Scan failed");
-    return oRes;
+    return oRes.Finish();
 }
 UniValue getblockhashbytxid(const JSONRPCRequest& request)
 {
@@ -964,7 +989,7 @@ UniValue syscoingetspvproof(const JSONRPCRequest& request)
         throw JSONRPCError(RPC_MISC_ERROR, "Block not available (pruned data)");
     }
 
-    if (!ReadBlockFromDisk(block, pblockindex, Params().GetConsensus())) {
+    if (!ReadBlockFromCacheOrDisk(block, pblockindex, Params().GetConsensus())) {
         // Block not found on disk. This could be because we have the block
         // header in our index but don't have the block (for example if a
         // non-whitelisted node sends us an unrequested long chain of valid
@@ -1041,10 +1066,11 @@ UniValue listassetindex(const JSONRPCRequest& request) {
 
     options = params[1];	
 
-    UniValue oRes(UniValue::VARR);	
+    // SYSCOIN HTTP clients get the index entries streamed as they are read
+    JSONRPCArrayResult oRes(request);
     if (!passetindexdb->ScanAssetIndex(page, options, oRes))	
         throw JSONRPCError(RPC_MISC_ERROR, "Scan failed");	
-    return oRes;	
+    return oRes.Finish();	
 }	
 UniValue listassetindexassets(const JSONRPCRequest& request) {	
     const UniValue &params = request.params;	
@@ -1213,7 +1239,10 @@ UniValue syscoinsetethstatus(const JSONRPCRequest& request) {
         oEthStatus.__pushKV("geth_total_blocks",  fGethSyncHeight);
         oEthStatus.__pushKV("geth_current_block",  fGethCurrentHeight);
         oEthStatus.push_back(ret);
-        GetMainSignals().NotifySyscoinUpdate(oEthStatus.write().c_str(), "ethstatus");
+        // only the latest status of a burst of updates is published
+        GetMainSignals().NotifySyscoinUpdate("ethstatus", [oEthStatus]() -> std::string {
+            return oEthStatus.write();
+        }, true);
     }
     nLastExecTime = GetSystemTimeInSeconds();
     return ret;
@@ -1461,6 +1490,44 @@ CAmount getAuxFee(const std::string &public_data, const CAmount& nAmount, const
     }
     return (nAmount - nBoundAmount) * nRate + nAccumulatedFee;    
 }
+UniValue getsyscoindbinfo(const JSONRPCRequest& request) {
+    RPCHelpMan{"getsyscoindbinfo",
+        "\nReturns the memory budget of the Syscoin databases and LevelDB statistics for each of them.\n",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "budget", "Bytes of -dbcache given to the Syscoin databases"},
+                {RPCResult::Type::OBJ, "block_cache", "The block cache shared by the databases",
+                    {
+                        {RPCResult::Type::NUM, "capacity", "Capacity in bytes"},
+                        {RPCResult::Type::NUM, "usage", "Bytes in use"},
+                    }},
+                {RPCResult::Type::ARR, "databases", "",
+                    {
+                        {RPCResult::Type::OBJ, "", "",
+                        {
+                            {RPCResult::Type::STR, "name", "The database name"},
+                            {RPCResult::Type::NUM, "weight", "Weight in the split of the write buffer budget"},
+                            {RPCResult::Type::NUM, "write_buffers", "Write buffer budget in bytes"},
+                            {RPCResult::Type::NUM, "memory_usage", "Approximate bytes used besides the shared block cache"},
+                            {RPCResult::Type::ARR, "files_per_level", "Number of table files at each level",
+                                {{RPCResult::Type::NUM, "", ""}}},
+                            {RPCResult::Type::STR, "stats", "LevelDB compaction statistics"},
+                        }},
+                    }},
+            }},
+        RPCExamples{
+            HelpExampleCli("getsyscoindbinfo", "")
+            + HelpExampleRpc("getsyscoindbinfo", "")
+        }
+    }.Check(request);
+    // the databases are reopened under cs_main on reindex
+    LOCK(cs_main);
+    std::vector<const CDBWrapper*> vecDBs = {passetallocationdb.get(), passetdb.get(), pblockindexdb.get(), passetindexdb.get(),
+        pethereumtxrootsdb.get(), pethereumtxmintdb.get(), plockedoutpointsdb.get(), passetallocationmempooldb.get()};
+    return syscoindbbudget.ToJSON(vecDBs);
+}
 // clang-format off
 static const CRPCCommand commands[] =
 { //  category              name                                actor (function)                argNames
@@ -1483,7 +1550,7 @@ static const CRPCCommand commands[] =
     { "syscoin",            "listassetindexassets",             &listassetindexassets,          {"address"} },	
     { "syscoin",            "listassetindexallocations",        &listassetindexallocations,     {"address"} },
     { "syscoin",            "tpstestinfo",                      &tpstestinfo,                   {} },
-    { "syscoin",            "tpstestadd",                       &tpstestadd,                    {"starttime","rawtxs"} },
+    { "syscoin",            "tpstestadd",                       &tpstestadd,                    {"starttime","rawtxs","threads"} },
     { "syscoin",            "tpstestsetenabled",                &tpstestsetenabled,             {"enabled"} },
     { "syscoin",            "syscoinsetethstatus",              &syscoinsetethstatus,           {"syncing_status","highestBlock"} },
     { "syscoin",            "syscoinsetethheaders",             &syscoinsetethheaders,          {"headers"} },
@@ -1491,6 +1558,7 @@ static const CRPCCommand commands[] =
     { "syscoin",            "syscoinstopgeth",                  &syscoinstopgeth,               {} },
     { "syscoin",            "syscoinstartgeth",                 &syscoinstartgeth,              {} },
     { "syscoin",            "syscoincheckmint",                 &syscoincheckmint,              {"ethtxid"} },
+    { "syscoin",            "getsyscoindbinfo",                 &getsyscoindbinfo,              {} },
 };
 // clang-format on
 void RegisterAssetRPCCommands(CRPCTable &t)
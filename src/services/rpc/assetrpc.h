@@ -6,6 +6,7 @@
 #define SYSCOIN_SERVICES_RPC_ASSETRPC_H
 #include <string>
 class COutPoint;
+class uint256;
 class CWitnessAddress;
 unsigned int addressunspent(const std::string& strAddressFrom, COutPoint& outpoint);
 UniValue ValueFromAssetAmount(const CAmount& amount, int precision);
@@ -23,5 +24,7 @@ static const CAmount MAX_ASSET = 1000000000000000000LL - 1LL;
 inline bool AssetRange(const CAmount& nValue) { return (nValue > 0 && nValue <= MAX_ASSET); }
 bool AssetRange(const CAmount& amountIn, int precision);
 CWitnessAddress DescribeWitnessAddress(const std::string& strAddress);
+/** ZDAG status of a mempool transaction, one of the ZDAG_ values */
+int VerifyTransactionGraph(const uint256& lookForTxHash);
 CAmount getAuxFee(const std::string &public_data, const CAmount& nAmount, const uint8_t &nPrecision, CWitnessAddress & address);
 #endif // SYSCOIN_SERVICES_RPC_ASSETRPC_H
@@ -248,50 +248,70 @@ UniValue syscointxfund(CWallet* const pwallet, const JSONRPCRequest& request) {
         nFees += GetMinimumFee(*pwallet, nBytes, coin_control, &fee_calc);
     } 
     if (nCurrentAmount < (nDesiredAmount + nFees)) {
-
-        UniValue paramsBalance(UniValue::VARR);
-        paramsBalance.push_back("start");
-        paramsBalance.push_back(addressArray);
-        JSONRPCRequest request1;
-        request1.params = paramsBalance;
-
-        UniValue resUTXOs = scantxoutset(request1);
-        UniValue utxoArray(UniValue::VARR);
-        if (resUTXOs.isObject()) {
-            const UniValue& resUtxoUnspents = find_value(resUTXOs.get_obj(), "unspents");
-            if (!resUtxoUnspents.isArray())
-                throw JSONRPCError(RPC_WALLET_INSUFFICIENT_FUNDS, "No unspent outputs found in addresses provided");
-            utxoArray = resUtxoUnspents.get_array();
+        // funding candidates come from the wallet's own coins of this address, addresses unknown
+        // to the wallet or without coins in it (e.g. imported without a rescan) fall back to
+        // scanning the whole UTXO set
+        std::vector<std::pair<COutPoint, CTxOut> > vecCandidates;
+        bool fWalletCoins = false;
+        if (pwallet->IsMine(scriptPubKeyFromOrig) != ISMINE_NO) {
+            auto locked_chain = pwallet->chain().lock();
+            LOCK2(pwallet->cs_wallet, mempool.cs);
+            std::vector<COutput> vecCoins;
+            pwallet->AvailableCoinsForScript(scriptPubKeyFromOrig, vecCoins);
+            fWalletCoins = !vecCoins.empty();
+            vecCandidates.reserve(vecCoins.size());
+            for (const COutput& out : vecCoins) {
+                const COutPoint outPoint(out.tx->GetHash(), out.i);
+                // may still be spent by a mempool transaction the wallet does not know about
+                if (mempool.mapNextTx.find(outPoint) != mempool.mapNextTx.end())
+                    continue;
+                vecCandidates.emplace_back(outPoint, out.tx->tx->vout[out.i]);
+            }
         }
-        else
-            throw JSONRPCError(RPC_WALLET_INSUFFICIENT_FUNDS, "No funds found in addresses provided");
-
+        if (!fWalletCoins) {
+            UniValue paramsBalance(UniValue::VARR);
+            paramsBalance.push_back("start");
+            paramsBalance.push_back(addressArray);
+            JSONRPCRequest request1;
+            request1.params = paramsBalance;
+
+            UniValue resUTXOs = scantxoutset(request1);
+            UniValue utxoArray(UniValue::VARR);
+            if (resUTXOs.isObject()) {
+                const UniValue& resUtxoUnspents = find_value(resUTXOs.get_obj(), "unspents");
+                if (!resUtxoUnspents.isArray())
+                    throw JSONRPCError(RPC_WALLET_INSUFFICIENT_FUNDS, "No unspent outputs found in addresses provided");
+                utxoArray = resUtxoUnspents.get_array();
+            }
+            else
+                throw JSONRPCError(RPC_WALLET_INSUFFICIENT_FUNDS, "No funds found in addresses provided");
 
-        for (unsigned int i = 0; i < utxoArray.size(); i++)
-        {
-            const UniValue& utxoObj = utxoArray[i].get_obj();
-            const string &strTxid = find_value(utxoObj, "txid").get_str();
-            const uint256& txid = uint256S(strTxid);
-            const uint32_t& nOut = find_value(utxoObj, "vout").get_uint();
-            const std::vector<unsigned char> &data(ParseHex(find_value(utxoObj, "scriptPubKey").get_str()));
-            const CScript& scriptPubKey = CScript(data.begin(), data.end());
-            const CAmount &nValue = AmountFromValue(find_value(utxoObj, "amount"));
-            CTxIn txIn(txid, nOut, scriptPubKey);
-            const COutPoint outPoint(txid, nOut);
-            if (std::find(tx.vin.begin(), tx.vin.end(), txIn) != tx.vin.end())
-                continue;
+            auto locked_chain = pwallet->chain().lock();
+            LOCK2(pwallet->cs_wallet, mempool.cs);
+            for (unsigned int i = 0; i < utxoArray.size(); i++)
             {
-                LOCK(cs_main);
-                LOCK(mempool.cs);
+                const UniValue& utxoObj = utxoArray[i].get_obj();
+                const uint256& txid = uint256S(find_value(utxoObj, "txid").get_str());
+                const uint32_t& nOut = find_value(utxoObj, "vout").get_uint();
+                const std::vector<unsigned char> &data(ParseHex(find_value(utxoObj, "scriptPubKey").get_str()));
+                const COutPoint outPoint(txid, nOut);
                 if (mempool.mapNextTx.find(outPoint) != mempool.mapNextTx.end())
                     continue;
-            }
-            {
-                LOCK(pwallet->cs_wallet);
                 if (pwallet->IsLockedCoin(txid, nOut))
                     continue;
+                if (!IsOutpointMature(outPoint))
+                    continue;
+                vecCandidates.emplace_back(outPoint, CTxOut(AmountFromValue(find_value(utxoObj, "amount")), CScript(data.begin(), data.end())));
             }
-            if (!IsOutpointMature(outPoint))
+        }
+
+        for (const auto& candidate : vecCandidates)
+        {
+            const COutPoint& outPoint = candidate.first;
+            const CScript& scriptPubKey = candidate.second.scriptPubKey;
+            const CAmount &nValue = candidate.second.nValue;
+            CTxIn txIn(outPoint, scriptPubKey);
+            if (std::find(tx.vin.begin(), tx.vin.end(), txIn) != tx.vin.end())
                 continue;
             bool locked = false;
             // spending while using a locked outpoint should be invalid
@@ -1436,6 +1456,68 @@ UniValue convertaddresswallet(const JSONRPCRequest& request)
     ret.pushKV("v4address", currentV4Address); 	
     return ret;	
 }
+UniValue getassetbalances(const JSONRPCRequest& request)
+{
+    std::shared_ptr<CWallet> const wallet = GetWalletForJSONRPCRequest(request);
+    CWallet* const pwallet = wallet.get();
+    if (!EnsureWalletIsAvailable(pwallet, request.fHelp)) {
+        return NullUniValue;
+    }
+    RPCHelpMan{"getassetbalances",
+    "\nList the asset allocation balances of wallet addresses, served from the wallet asset ledger.\n",
+    {
+        {"asset_guid", RPCArg::Type::NUM, RPCArg::Optional::OMITTED_NAMED_ARG, "Only list balances of this asset"},
+        {"address", RPCArg::Type::STR, RPCArg::Optional::OMITTED_NAMED_ARG, "Only list balances of this address"},
+    },
+    RPCResult{
+        RPCResult::Type::ARR, "", "",
+        {
+            {RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "asset_guid", "The guid of the asset"},
+                {RPCResult::Type::STR, "address", "The address of the allocation"},
+                {RPCResult::Type::STR_AMOUNT, "balance", "The confirmed balance"},
+                {RPCResult::Type::STR_AMOUNT, "balance_zdag", "The balance change of ZDAG transactions in the mempool, negative while sending"},
+            }},
+        },
+    },
+    RPCExamples{
+        HelpExampleCli("getassetbalances", "")
+        + HelpExampleCli("getassetbalances", "\"asset_guid\" \"address\"")
+        + HelpExampleRpc("getassetbalances", "\"asset_guid\", \"address\"")
+    }}.Check(request);
+
+    const bool fFilterAsset = !request.params[0].isNull();
+    const uint32_t nFilterAsset = fFilterAsset ? request.params[0].get_uint() : 0;
+    std::string strFilterAddress;
+    if (!request.params[1].isNull())
+        strFilterAddress = DescribeWitnessAddress(request.params[1].get_str()).ToString();
+
+    const WalletAssetBalanceMap mapBalances = pwallet->GetAssetBalances();
+    UniValue ret(UniValue::VARR);
+    uint32_t nLastAsset = 0;
+    int nPrecision = 8;
+    for (const auto& balance : mapBalances) {
+        const uint32_t nAsset = balance.first.first;
+        if (fFilterAsset && nAsset != nFilterAsset)
+            continue;
+        if (!strFilterAddress.empty() && balance.first.second != strFilterAddress)
+            continue;
+        // balances are ordered by asset, look each one up once
+        if (ret.empty() || nAsset != nLastAsset) {
+            CAsset theAsset;
+            nPrecision = GetAsset(nAsset, theAsset) ? theAsset.nPrecision : 8;
+            nLastAsset = nAsset;
+        }
+        UniValue oBalance(UniValue::VOBJ);
+        oBalance.pushKV("asset_guid", (int64_t)nAsset);
+        oBalance.pushKV("address", balance.first.second);
+        oBalance.pushKV("balance", ValueFromAssetAmount(balance.second.nConfirmed, nPrecision));
+        oBalance.pushKV("balance_zdag", ValueFromAssetAmount(balance.second.nPending, nPrecision));
+        ret.push_back(oBalance);
+    }
+    return ret;
+}
 
 // clang-format off
 static const CRPCCommand commands[] =
@@ -1456,6 +1538,7 @@ static const CRPCCommand commands[] =
     { "syscoinwallet",            "assetallocationsend",              &assetallocationsend,           {"asset_guid","address_sender","address_receiver","amount"}},
     { "syscoinwallet",            "assetallocationsendmany",          &assetallocationsendmany,       {"asset_guid","address","inputs","witness"}},
     { "syscoinwallet",            "sendfrom",                         &sendfrom,                      {"funding_address","address","amount"}},
+    { "syscoinwallet",            "getassetbalances",                 &getassetbalances,              {"asset_guid","address"}},
 };
 // clang-format on
 
@@ -0,0 +1,255 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <services/txload.h>
+
+#include <consensus/validation.h>
+#include <net_processing.h>
+#include <node/context.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
+#include <services/rpc/assetrpc.h>
+#include <txmempool.h>
+#include <util/system.h>
+#include <util/time.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <unordered_map>
+
+void CLatencyHistogram::Add(int64_t nMicros)
+{
+    nMicros = std::max<int64_t>(nMicros, 0);
+    // bucket i holds the samples below 2^i microseconds, the last one everything above
+    int nBucket = 0;
+    while (nBucket < BUCKETS - 1 && (int64_t(1) << nBucket) <= nMicros) {
+        nBucket++;
+    }
+    arrBuckets[nBucket]++;
+    nCount++;
+    nTotalMicros += nMicros;
+    nMaxMicros = std::max(nMaxMicros, nMicros);
+}
+
+void CLatencyHistogram::Merge(const CLatencyHistogram& other)
+{
+    for (int i = 0; i < BUCKETS; i++) {
+        arrBuckets[i] += other.arrBuckets[i];
+    }
+    nCount += other.nCount;
+    nTotalMicros += other.nTotalMicros;
+    nMaxMicros = std::max(nMaxMicros, other.nMaxMicros);
+}
+
+int64_t CLatencyHistogram::GetPercentile(double dFraction) const
+{
+    if (nCount == 0) {
+        return 0;
+    }
+    const uint64_t nTarget = std::max<uint64_t>(1, std::ceil(dFraction * nCount));
+    uint64_t nSeen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        nSeen += arrBuckets[i];
+        if (nSeen >= nTarget) {
+            return std::min(int64_t(1) << i, nMaxMicros);
+        }
+    }
+    return nMaxMicros;
+}
+
+UniValue CLatencyHistogram::ToJSON() const
+{
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("count", nCount);
+    obj.pushKV("mean_us", nCount > 0 ? nTotalMicros / (int64_t)nCount : 0);
+    obj.pushKV("p50_us", GetPercentile(0.5));
+    obj.pushKV("p90_us", GetPercentile(0.9));
+    obj.pushKV("p99_us", GetPercentile(0.99));
+    obj.pushKV("max_us", nMaxMicros);
+    UniValue buckets(UniValue::VARR);
+    for (int i = 0; i < BUCKETS; i++) {
+        if (arrBuckets[i] == 0) {
+            continue;
+        }
+        UniValue bucket(UniValue::VOBJ);
+        bucket.pushKV("lt_us", int64_t(1) << i);
+        bucket.pushKV("count", arrBuckets[i]);
+        buckets.push_back(bucket);
+    }
+    obj.pushKV("buckets", buckets);
+    return obj;
+}
+
+CTxRelayLatency g_txload_relay;
+
+void CTxRelayLatency::Reset()
+{
+    LOCK(cs);
+    mapAccepted.clear();
+    histogram = CLatencyHistogram();
+    fPending = false;
+}
+
+void CTxRelayLatency::Accepted(const uint256& txid, int64_t nAcceptTimeMicros)
+{
+    LOCK(cs);
+    mapAccepted.emplace(txid, nAcceptTimeMicros);
+    fPending = true;
+}
+
+void CTxRelayLatency::InvPushed(const uint256& txid)
+{
+    if (!fPending) {
+        return;
+    }
+    const int64_t nNow = GetTimeMicros();
+    LOCK(cs);
+    auto it = mapAccepted.find(txid);
+    if (it == mapAccepted.end()) {
+        return;
+    }
+    // only the first peer counts, the others get the inv after their own trickle delay
+    histogram.Add(nNow - it->second);
+    mapAccepted.erase(it);
+    fPending = !mapAccepted.empty();
+}
+
+UniValue CTxRelayLatency::ToJSON() const
+{
+    LOCK(cs);
+    UniValue obj = histogram.ToJSON();
+    obj.pushKV("pending", (uint64_t)mapAccepted.size());
+    return obj;
+}
+
+CTxLoadGenerator::CTxLoadGenerator(const NodeContext& nodeIn, const std::vector<CTransactionRef>& vecTx, int nThreads, bool fRelayIn)
+    : node(nodeIn), fRelay(fRelayIn)
+{
+    vecWorkers.resize(std::max(1, nThreads));
+    // keep chains (such as the change of a ZDAG sender) on one thread, spread the rest round robin.
+    // A transaction joining outputs of two threads may still find one parent missing.
+    std::unordered_map<uint256, size_t, SaltedTxidHasher> mapTxWorker;
+    size_t nNext = 0;
+    for (const CTransactionRef& tx : vecTx) {
+        size_t nWorker = vecWorkers.size();
+        for (const CTxIn& txin : tx->vin) {
+            auto it = mapTxWorker.find(txin.prevout.hash);
+            if (it != mapTxWorker.end()) {
+                nWorker = it->second;
+                break;
+            }
+        }
+        if (nWorker == vecWorkers.size()) {
+            nWorker = nNext;
+            nNext = (nNext + 1) % vecWorkers.size();
+        }
+        mapTxWorker.emplace(tx->GetHash(), nWorker);
+        vecWorkers[nWorker].vecTx.push_back(tx);
+    }
+}
+
+void CTxLoadGenerator::Submit(Worker& worker)
+{
+    for (const CTransactionRef& tx : worker.vecTx) {
+        const uint256& txHash = tx->GetHash();
+        const int64_t nStart = GetTimeMicros();
+        TxValidationState state;
+        bool fAccepted;
+        {
+            LOCK(cs_main);
+            fAccepted = AcceptToMemoryPool(*node.mempool, state, tx, nullptr /* plTxnReplaced */, false /* bypass_limits */, 0 /* nAbsurdFee */);
+        }
+        const int64_t nAcceptTime = GetTimeMicros();
+        worker.accept.Add(nAcceptTime - nStart);
+        if (!fAccepted) {
+            LogPrint(BCLog::MEMPOOL, "%s: %s rejected: %s\n", __func__, txHash.GetHex(), state.ToString());
+            worker.nRejected++;
+            continue;
+        }
+        worker.nAccepted++;
+        if (fRelay && node.connman) {
+            g_txload_relay.Accepted(txHash, nAcceptTime);
+            RelayTransaction(txHash, *node.connman);
+        }
+        if (tx->nVersion == SYSCOIN_TX_VERSION_ALLOCATION_SEND) {
+            const int64_t nZdagStart = GetTimeMicros();
+            if (VerifyTransactionGraph(txHash) == ZDAG_STATUS_OK) {
+                worker.nZdagOk++;
+            }
+            worker.zdag.Add(GetTimeMicros() - nZdagStart);
+        }
+    }
+}
+
+void CTxLoadGenerator::Run(int64_t nStartTimeMicros)
+{
+    if (nStartTimeMicros > 0) {
+        std::this_thread::sleep_until(std::chrono::time_point<std::chrono::system_clock, std::chrono::microseconds>(std::chrono::microseconds(nStartTimeMicros)));
+    }
+    if (fRelay) {
+        g_txload_relay.Reset();
+    }
+    const int64_t nStart = GetTimeMicros();
+    std::vector<std::thread> vecThreads;
+    for (size_t i = 1; i < vecWorkers.size(); i++) {
+        vecThreads.emplace_back([this, i] {
+            util::ThreadRename(strprintf("txload.%d", i));
+            Submit(vecWorkers[i]);
+        });
+    }
+    Submit(vecWorkers[0]);
+    for (std::thread& thread : vecThreads) {
+        thread.join();
+    }
+    nElapsedMicros = GetTimeMicros() - nStart;
+    LogPrint(BCLog::BENCH, "%s: submitted %u transactions from %u threads in %.2fms (%u accepted)\n", __func__,
+        GetAccepted() + GetRejected(), vecWorkers.size(), nElapsedMicros * 0.001, GetAccepted());
+}
+
+uint64_t CTxLoadGenerator::GetAccepted() const
+{
+    uint64_t nAccepted = 0;
+    for (const Worker& worker : vecWorkers) {
+        nAccepted += worker.nAccepted;
+    }
+    return nAccepted;
+}
+
+uint64_t CTxLoadGenerator::GetRejected() const
+{
+    uint64_t nRejected = 0;
+    for (const Worker& worker : vecWorkers) {
+        nRejected += worker.nRejected;
+    }
+    return nRejected;
+}
+
+UniValue CTxLoadGenerator::ToJSON() const
+{
+    CLatencyHistogram accept, zdag;
+    uint64_t nZdagOk = 0;
+    for (const Worker& worker : vecWorkers) {
+        accept.Merge(worker.accept);
+        zdag.Merge(worker.zdag);
+        nZdagOk += worker.nZdagOk;
+    }
+    const uint64_t nAccepted = GetAccepted();
+    UniValue obj(UniValue::VOBJ);
+    obj.pushKV("threads", (uint64_t)vecWorkers.size());
+    obj.pushKV("accepted", nAccepted);
+    obj.pushKV("rejected", GetRejected());
+    obj.pushKV("zdag_ok", nZdagOk);
+    obj.pushKV("elapsed_us", nElapsedMicros);
+    obj.pushKV("tps", nElapsedMicros > 0 ? nAccepted * 1000000.0 / nElapsedMicros : 0.0);
+    obj.pushKV("accept", accept.ToJSON());
+    obj.pushKV("zdag", zdag.ToJSON());
+    if (fRelay) {
+        // still filling up while the invs go out
+        obj.pushKV("relay", g_txload_relay.ToJSON());
+    }
+    return obj;
+}
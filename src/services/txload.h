@@ -0,0 +1,111 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef SYSCOIN_SERVICES_TXLOAD_H
+#define SYSCOIN_SERVICES_TXLOAD_H
+
+#include <primitives/transaction.h>
+#include <sync.h>
+#include <txmempool.h>
+#include <univalue.h>
+
+#include <array>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
+
+struct NodeContext;
+
+/** Default number of threads submitting a transaction load */
+static const int DEFAULT_TXLOAD_THREADS = 4;
+
+/** Latency histogram with one bucket per power of two microseconds */
+class CLatencyHistogram
+{
+public:
+    static const int BUCKETS = 32;
+
+private:
+    std::array<uint64_t, BUCKETS> arrBuckets{};
+    uint64_t nCount{0};
+    int64_t nTotalMicros{0};
+    int64_t nMaxMicros{0};
+
+public:
+    void Add(int64_t nMicros);
+    void Merge(const CLatencyHistogram& other);
+    uint64_t GetCount() const { return nCount; }
+    /** Upper bound in microseconds of the bucket reached by dFraction of the samples */
+    int64_t GetPercentile(double dFraction) const;
+    UniValue ToJSON() const;
+};
+
+/**
+ * Time from the acceptance of each relayed transaction of a load until SendMessages pushes the first inv
+ * announcing it to a peer. Transactions that were not announced yet are only counted as pending.
+ */
+class CTxRelayLatency
+{
+private:
+    mutable Mutex cs;
+    std::unordered_map<uint256, int64_t, SaltedTxidHasher> mapAccepted GUARDED_BY(cs);
+    CLatencyHistogram histogram GUARDED_BY(cs);
+    // lets InvPushed skip the lock while no transaction of a load waits for its inv
+    std::atomic<bool> fPending{false};
+
+public:
+    /** Forget the transactions of the previous load */
+    void Reset();
+    /** Called before the transaction is queued for relay */
+    void Accepted(const uint256& txid, int64_t nAcceptTimeMicros);
+    /** Called by SendMessages for every transaction inv it pushes to a peer */
+    void InvPushed(const uint256& txid);
+    UniValue ToJSON() const;
+};
+
+extern CTxRelayLatency g_txload_relay;
+
+/**
+ * Submits pre-decoded transactions straight to the mempool from several threads and records how long
+ * acceptance and ZDAG verification take for each of them. A transaction spending an output of an earlier
+ * transaction of the load is submitted by the same thread, after its parent.
+ * AcceptToMemoryPool runs under cs_main, so the threads only overlap outside of it and the acceptance
+ * itself is serialized; more threads do not raise the throughput of mempool admission.
+ */
+class CTxLoadGenerator
+{
+private:
+    struct Worker {
+        std::vector<CTransactionRef> vecTx;
+        CLatencyHistogram accept;
+        CLatencyHistogram zdag;
+        uint64_t nAccepted{0};
+        uint64_t nRejected{0};
+        uint64_t nZdagOk{0};
+    };
+
+    const NodeContext& node;
+    const bool fRelay;
+    std::vector<Worker> vecWorkers;
+    int64_t nElapsedMicros{0};
+
+    void Submit(Worker& worker);
+
+public:
+    /**
+     * With fRelay accepted transactions are queued for announcement to the peers of node.connman. The invs go
+     * out later from the message handler thread, g_txload_relay records when the first one is pushed
+     */
+    CTxLoadGenerator(const NodeContext& nodeIn, const std::vector<CTransactionRef>& vecTx, int nThreads, bool fRelayIn);
+
+    /** Submit all transactions, waiting until nStartTimeMicros (if set) before the first one */
+    void Run(int64_t nStartTimeMicros = 0);
+
+    uint64_t GetAccepted() const;
+    uint64_t GetRejected() const;
+    /** Counts, throughput and latency histograms of the last run */
+    UniValue ToJSON() const;
+};
+
+#endif // SYSCOIN_SERVICES_TXLOAD_H
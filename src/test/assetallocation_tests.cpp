@@ -0,0 +1,181 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <services/asset.h>
+#include <services/assetallocation.h>
+#include <streams.h>
+#include <version.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(assetallocation_tests, TestingSetup)
+
+static const uint32_t ASSET_GUID = 1234;
+static const CWitnessAddress SENDER(0, std::vector<unsigned char>(20, 1));
+static const CWitnessAddress RECEIVER1(0, std::vector<unsigned char>(20, 2));
+static const CWitnessAddress RECEIVER2(0, std::vector<unsigned char>(20, 3));
+
+static CMutableTransaction PayloadTx(int nVersion, const std::vector<unsigned char>& vchData)
+{
+    CMutableTransaction mtx;
+    mtx.nVersion = nVersion;
+    mtx.vin.resize(1);
+    mtx.vout.resize(2);
+    mtx.vout[0].nValue = 1000;
+    mtx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+    mtx.vout[1].nValue = 0;
+    mtx.vout[1].scriptPubKey = CScript() << OP_RETURN << vchData;
+    return mtx;
+}
+
+static CMutableTransaction AllocationTx(int nVersion, const CWitnessAddress& sender, const RangeAmountTuples& listReceivers)
+{
+    CAssetAllocation assetAllocation;
+    assetAllocation.assetAllocationTuple = CAssetAllocationTuple(ASSET_GUID, sender);
+    assetAllocation.listSendingAllocationAmounts = listReceivers;
+    std::vector<unsigned char> vchData;
+    assetAllocation.Serialize(vchData);
+    return PayloadTx(nVersion, vchData);
+}
+
+static void CheckDeltaEvent(const CTransaction& tx, const RangeAmountTuples& vecExpected)
+{
+    std::string strEvent;
+    BOOST_REQUIRE(BuildAssetAllocationDeltaEvent(tx, SYSCOIN_EVENT_CONNECTED, strEvent));
+    CDataStream ss(strEvent.data(), strEvent.data() + strEvent.size(), SER_NETWORK, PROTOCOL_VERSION);
+    uint256 txHash;
+    uint8_t nStatus;
+    uint32_t nAsset;
+    RangeAmountTuples vecDeltas;
+    ss >> txHash >> nStatus >> nAsset >> vecDeltas;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(txHash == tx.GetHash());
+    BOOST_CHECK_EQUAL(nStatus, SYSCOIN_EVENT_CONNECTED);
+    BOOST_CHECK_EQUAL(nAsset, ASSET_GUID);
+    BOOST_REQUIRE_EQUAL(vecDeltas.size(), vecExpected.size());
+    for (size_t i = 0; i < vecDeltas.size(); i++) {
+        BOOST_CHECK(vecDeltas[i].first == vecExpected[i].first);
+        BOOST_CHECK_EQUAL(vecDeltas[i].second, vecExpected[i].second);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(assetallocation_send_event)
+{
+    const CTransaction tx(AllocationTx(SYSCOIN_TX_VERSION_ALLOCATION_SEND, SENDER, {{RECEIVER1, 100}, {RECEIVER2, 250}}));
+    // the receivers gain their amounts and the sender loses the total
+    CheckDeltaEvent(tx, {{RECEIVER1, 100}, {RECEIVER2, 250}, {SENDER, -350}});
+
+    std::string strEvent;
+    BOOST_CHECK(!BuildAssetMintEvent(tx, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(!BuildAssetBurnEvent(tx, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(strEvent.empty());
+}
+
+BOOST_AUTO_TEST_CASE(assetallocation_burn_events)
+{
+    std::string strEvent;
+
+    const CTransaction txToSyscoin(AllocationTx(SYSCOIN_TX_VERSION_ALLOCATION_BURN_TO_SYSCOIN, SENDER, {{burnWitness, 500}}));
+    CheckDeltaEvent(txToSyscoin, {{burnWitness, 500}, {SENDER, -500}});
+    // only burns to Ethereum are bridge events
+    BOOST_CHECK(!BuildAssetBurnEvent(txToSyscoin, SYSCOIN_EVENT_CONNECTED, strEvent));
+
+    const CTransaction txToAllocation(AllocationTx(SYSCOIN_TX_VERSION_SYSCOIN_BURN_TO_ALLOCATION, burnWitness, {{RECEIVER1, 600}}));
+    CheckDeltaEvent(txToAllocation, {{RECEIVER1, 600}, {burnWitness, -600}});
+    BOOST_CHECK(!BuildAssetBurnEvent(txToAllocation, SYSCOIN_EVENT_CONNECTED, strEvent));
+
+    // burns to Ethereum carry their data as separate pushes instead of a serialized allocation
+    const std::vector<unsigned char> vchEthAddress(20, 0xaa);
+    const std::vector<unsigned char> vchEthContract(20, 0xbb);
+    const CAmount nAmount = 700;
+    CMutableTransaction mtx = PayloadTx(SYSCOIN_TX_VERSION_ALLOCATION_BURN_TO_ETHEREUM, {});
+    mtx.vout[1].scriptPubKey = CScript() << OP_RETURN
+        << std::vector<unsigned char>{0, 0, ASSET_GUID >> 8, ASSET_GUID & 0xff}
+        << std::vector<unsigned char>{0, 0, 0, 0, 0, 0, nAmount >> 8, nAmount & 0xff}
+        << vchEthAddress << std::vector<unsigned char>{8} << vchEthContract
+        << std::vector<unsigned char>{SENDER.nVersion} << SENDER.vchWitnessProgram;
+    const CTransaction txToEthereum(mtx);
+    CheckDeltaEvent(txToEthereum, {{burnWitness, nAmount}, {SENDER, -nAmount}});
+
+    BOOST_REQUIRE(BuildAssetBurnEvent(txToEthereum, SYSCOIN_EVENT_MEMPOOL, strEvent));
+    CDataStream ss(strEvent.data(), strEvent.data() + strEvent.size(), SER_NETWORK, PROTOCOL_VERSION);
+    uint256 txHash;
+    uint8_t nStatus;
+    uint32_t nAsset;
+    CWitnessAddress burnWitnessAddress;
+    CAmount nBurnAmount;
+    std::vector<unsigned char> vchEventEthAddress, vchEventEthContract;
+    ss >> txHash >> nStatus >> nAsset >> burnWitnessAddress >> nBurnAmount >> vchEventEthAddress >> vchEventEthContract;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(txHash == txToEthereum.GetHash());
+    BOOST_CHECK_EQUAL(nStatus, SYSCOIN_EVENT_MEMPOOL);
+    BOOST_CHECK_EQUAL(nAsset, ASSET_GUID);
+    BOOST_CHECK(burnWitnessAddress == SENDER);
+    BOOST_CHECK_EQUAL(nBurnAmount, nAmount);
+    BOOST_CHECK(vchEventEthAddress == vchEthAddress);
+    BOOST_CHECK(vchEventEthContract == vchEthContract);
+    BOOST_CHECK(!BuildAssetMintEvent(txToEthereum, SYSCOIN_EVENT_MEMPOOL, strEvent));
+}
+
+BOOST_AUTO_TEST_CASE(assetallocation_mint_event)
+{
+    CMintSyscoin mintSyscoin;
+    mintSyscoin.assetAllocationTuple = CAssetAllocationTuple(ASSET_GUID, RECEIVER1);
+    mintSyscoin.vchTxValue = {1};
+    mintSyscoin.vchReceiptValue = {1};
+    mintSyscoin.nBlockNumber = 42;
+    mintSyscoin.nValueAsset = 800;
+    std::vector<unsigned char> vchData;
+    mintSyscoin.Serialize(vchData);
+    const CTransaction tx(PayloadTx(SYSCOIN_TX_VERSION_ALLOCATION_MINT, vchData));
+    // nothing is taken from an allocation
+    CheckDeltaEvent(tx, {{RECEIVER1, 800}});
+
+    std::string strEvent;
+    BOOST_REQUIRE(BuildAssetMintEvent(tx, SYSCOIN_EVENT_DISCONNECTED, strEvent));
+    CDataStream ss(strEvent.data(), strEvent.data() + strEvent.size(), SER_NETWORK, PROTOCOL_VERSION);
+    uint256 txHash;
+    uint8_t nStatus;
+    uint32_t nAsset;
+    CWitnessAddress witnessAddress;
+    CAmount nValueAsset;
+    uint32_t nBlockNumber;
+    ss >> txHash >> nStatus >> nAsset >> witnessAddress >> nValueAsset >> nBlockNumber;
+    BOOST_CHECK(ss.empty());
+    BOOST_CHECK(txHash == tx.GetHash());
+    BOOST_CHECK_EQUAL(nStatus, SYSCOIN_EVENT_DISCONNECTED);
+    BOOST_CHECK_EQUAL(nAsset, ASSET_GUID);
+    BOOST_CHECK(witnessAddress == RECEIVER1);
+    BOOST_CHECK_EQUAL(nValueAsset, 800);
+    BOOST_CHECK_EQUAL(nBlockNumber, 42U);
+    BOOST_CHECK(!BuildAssetBurnEvent(tx, SYSCOIN_EVENT_DISCONNECTED, strEvent));
+}
+
+BOOST_AUTO_TEST_CASE(assetallocation_no_event)
+{
+    std::string strEvent;
+
+    // a lock moves no balance
+    CAssetAllocation assetAllocation;
+    assetAllocation.assetAllocationTuple = CAssetAllocationTuple(ASSET_GUID, SENDER);
+    assetAllocation.lockedOutpoint = COutPoint(uint256S("01"), 0);
+    std::vector<unsigned char> vchData;
+    assetAllocation.Serialize(vchData);
+    const CTransaction txLock(PayloadTx(SYSCOIN_TX_VERSION_ALLOCATION_LOCK, vchData));
+    BOOST_CHECK(!BuildAssetAllocationDeltaEvent(txLock, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(!BuildAssetMintEvent(txLock, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(!BuildAssetBurnEvent(txLock, SYSCOIN_EVENT_CONNECTED, strEvent));
+
+    const CTransaction txPlain(PayloadTx(CTransaction::CURRENT_VERSION, vchData));
+    BOOST_CHECK(!BuildAssetAllocationDeltaEvent(txPlain, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(!BuildAssetMintEvent(txPlain, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(!BuildAssetBurnEvent(txPlain, SYSCOIN_EVENT_CONNECTED, strEvent));
+    BOOST_CHECK(strEvent.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,6 +20,7 @@
 #include <test/util/setup_common.h>
 
 #include <boost/test/unit_test.hpp>
+#include <boost/thread/thread.hpp>
 
 #include <algorithm>
 #include <vector>
@@ -507,6 +508,56 @@ BOOST_FIXTURE_TEST_CASE (auxpow_pow, BasicTestingSetup)
   BOOST_CHECK (!CheckProofOfWork (block, params));
 }
 
+BOOST_FIXTURE_TEST_CASE (auxpow_headersBatch, TestingSetup)
+{
+  SelectParams (CBaseChainParams::REGTEST);
+  const Consensus::Params& params = Params ().GetConsensus ();
+
+  /* A batch of merge-mined headers with minimal auxpows.  */
+  const arith_uint256 target = (~arith_uint256 (0) >> 1);
+  std::vector<CBlockHeader> headers(50);
+  for (unsigned i = 0; i < headers.size (); ++i)
+    {
+      CBlockHeader& block = headers[i];
+      block.SetBaseVersion (2, params.nAuxpowChainId);
+      block.nTime = i;
+      block.nBits = target.GetCompact ();
+      CPureBlockHeader& parent = CAuxPow::initAuxPow (block);
+      while (!CheckProofOfWork (parent.GetHash (), block.nBits, params))
+        ++parent.nNonce;
+      BOOST_CHECK (CheckProofOfWork (block, params));
+    }
+
+  /* Verify them on a few header-checking threads as during headers sync.  */
+  boost::thread_group threads;
+  for (int i = 0; i < 3; ++i)
+    threads.create_thread ([i] () { ThreadHeaderCheck (i); });
+
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork (headers, params), headers.size ());
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork ({}, params), 0U);
+
+  /* The first bad header is reported, whatever comes after it.  */
+  tamperWith (headers[40].hashMerkleRoot);
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork (headers, params), 40U);
+  tamperWith (headers[27].hashMerkleRoot);
+  BOOST_CHECK (!CheckProofOfWork (headers[27], params));
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork (headers, params), 27U);
+
+  /* Headers already in the block index are not checked again.  */
+  {
+    LOCK (cs_main);
+    CBlockIndex* pindex = new CBlockIndex (headers[27]);
+    pindex->phashBlock = &BlockIndex ().emplace (headers[27].GetHash (), pindex).first->first;
+  }
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork (headers, params), 40U);
+
+  headers.resize (27);
+  BOOST_CHECK_EQUAL (CheckHeadersProofOfWork (headers, params), headers.size ());
+
+  threads.interrupt_all ();
+  threads.join_all ();
+}
+
 /* ************************************************************************** */
 
 /**
@@ -520,6 +571,7 @@ public:
 
   using AuxpowMiner::cs;
 
+  using AuxpowMiner::buildBackgroundBlocks;
   using AuxpowMiner::getCurrentBlock;
   using AuxpowMiner::lookupSavedBlock;
 
@@ -602,6 +654,77 @@ BOOST_FIXTURE_TEST_CASE (auxpow_miner_createAndLookupBlock, TestChain100Setup)
   BOOST_CHECK_THROW (miner.lookupSavedBlock ("foobar"), UniValue);
 }
 
+BOOST_FIXTURE_TEST_CASE (auxpow_miner_backgroundBlocks, TestChain100Setup)
+{
+  CTxMemPool mempool;
+  AuxpowMinerForTest miner;
+  miner.startBackgroundBlocks (mempool, DEFAULT_AUXPOW_TEMPLATE_MEMORY << 20);
+
+  /* Asking for a block registers the payout script.  */
+  const CScript scriptPubKey = CScript () << OP_TRUE;
+  uint256 target;
+  {
+    LOCK (miner.cs);
+    miner.getCurrentBlock (mempool, scriptPubKey, target);
+  }
+
+  /* After a new tip, the blocks for it are built in the background (or
+     explicitly, in case the tip signal was skipped for being in IBD).  */
+  CreateAndProcessBlock ({}, scriptPubKey);
+  SyncWithValidationInterfaceQueue ();
+  miner.buildBackgroundBlocks (true);
+
+  const CBlock* pblock;
+  {
+    LOCK (miner.cs);
+    pblock = miner.getCurrentBlock (mempool, scriptPubKey, target);
+  }
+  BOOST_CHECK (pblock->hashPrevBlock
+                == WITH_LOCK (cs_main,
+                              return ::ChainActive ().Tip ()->GetBlockHash ()));
+
+  const UniValue info = miner.getTemplateInfo ();
+  BOOST_CHECK (info["background"].get_bool ());
+  BOOST_CHECK_EQUAL (info["served"].get_int64 (), 2);
+  BOOST_CHECK_EQUAL (info["servedprebuilt"].get_int64 (), 1);
+  BOOST_CHECK_EQUAL (info["builtondemand"].get_int64 (), 1);
+  BOOST_CHECK (info["builtbackground"].get_int64 () >= 2);
+
+  miner.stopBackgroundBlocks ();
+  BOOST_CHECK (!miner.getTemplateInfo ()["background"].get_bool ());
+}
+
+BOOST_FIXTURE_TEST_CASE (auxpow_miner_templateMemory, TestChain100Setup)
+{
+  CTxMemPool mempool;
+  AuxpowMinerForTest miner;
+  miner.startBackgroundBlocks (mempool, 1);
+
+  {
+    LOCK (miner.cs);
+    uint256 target;
+    const CBlock* pblock
+        = miner.getCurrentBlock (mempool, CScript () << OP_TRUE, target);
+    const std::string hash1 = pblock->GetHash ().GetHex ();
+
+    /* Only the newest block is kept, the older one can no longer be
+       submitted and is built again when asked for.  */
+    pblock = miner.getCurrentBlock (mempool, CScript () << OP_FALSE, target);
+    BOOST_CHECK (miner.lookupSavedBlock (pblock->GetHash ().GetHex ())
+                  == pblock);
+    BOOST_CHECK_THROW (miner.lookupSavedBlock (hash1), UniValue);
+    BOOST_CHECK_EQUAL (miner.getTemplateInfo ()["templates"].get_int64 (), 1);
+
+    pblock = miner.getCurrentBlock (mempool, CScript () << OP_TRUE, target);
+    BOOST_CHECK (miner.lookupSavedBlock (pblock->GetHash ().GetHex ())
+                  == pblock);
+    BOOST_CHECK_EQUAL (miner.getTemplateInfo ()["builtondemand"].get_int64 (),
+                       3);
+  }
+
+  miner.stopBackgroundBlocks ();
+}
+
 /* ************************************************************************** */
 
 BOOST_AUTO_TEST_SUITE_END ()
\ No newline at end of file
@@ -0,0 +1,92 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <blockcache.h>
+#include <chainparams.h>
+#include <validation.h>
+
+#include <test/util/setup_common.h>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(blockcache_tests, BasicTestingSetup)
+
+static std::shared_ptr<const CBlock> MakeBlock(int nTxs)
+{
+    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
+    pblock->nNonce = InsecureRand32();
+    for (int i = 0; i < nTxs; i++) {
+        CMutableTransaction mtx;
+        mtx.vin.emplace_back(COutPoint(InsecureRand256(), i));
+        mtx.vout.emplace_back(i, CScript() << OP_TRUE);
+        pblock->vtx.push_back(MakeTransactionRef(mtx));
+    }
+    return pblock;
+}
+
+BOOST_AUTO_TEST_CASE(blockcache_lru)
+{
+    CRecentBlockCache cache;
+    const std::shared_ptr<const CBlock> pblock1 = MakeBlock(100), pblock2 = MakeBlock(100), pblock3 = MakeBlock(100);
+
+    // room for two of the blocks
+    cache.Add(pblock1);
+    const size_t nBlockMemory = cache.ToJSON()["usage"].get_int64();
+    cache.SetMaxMemory(2 * nBlockMemory + nBlockMemory / 2);
+    cache.Add(pblock2);
+    BOOST_CHECK_EQUAL(cache.ToJSON()["blocks"].get_int64(), 2);
+
+    // a lookup makes the first block the most recently used one, so the second is evicted
+    BOOST_CHECK(cache.Get(pblock1->GetHash()) == pblock1);
+    cache.Add(pblock3);
+    BOOST_CHECK(cache.Get(pblock2->GetHash()) == nullptr);
+    BOOST_CHECK(cache.Get(pblock1->GetHash()) == pblock1);
+    BOOST_CHECK(cache.Get(pblock3->GetHash()) == pblock3);
+
+    UniValue stats = cache.ToJSON();
+    BOOST_CHECK_EQUAL(stats["blocks"].get_int64(), 2);
+    BOOST_CHECK_EQUAL(stats["usage"].get_int64(), 2 * nBlockMemory);
+    BOOST_CHECK_EQUAL(stats["hits"].get_int64(), 3);
+    BOOST_CHECK_EQUAL(stats["misses"].get_int64(), 1);
+
+    // adding a cached block again changes nothing, a block larger than the cache is not added
+    cache.Add(pblock3);
+    BOOST_CHECK_EQUAL(cache.ToJSON()["usage"].get_int64(), 2 * nBlockMemory);
+    cache.Add(MakeBlock(1000));
+    BOOST_CHECK_EQUAL(cache.ToJSON()["blocks"].get_int64(), 2);
+
+    // shrinking evicts the least recently used blocks, evicted blocks stay usable
+    cache.SetMaxMemory(nBlockMemory);
+    BOOST_CHECK(cache.Get(pblock1->GetHash()) == nullptr);
+    BOOST_CHECK(cache.Get(pblock3->GetHash()) == pblock3);
+    BOOST_CHECK_EQUAL(pblock1->vtx.size(), 100U);
+
+    cache.Clear();
+    stats = cache.ToJSON();
+    BOOST_CHECK_EQUAL(stats["blocks"].get_int64(), 0);
+    BOOST_CHECK_EQUAL(stats["usage"].get_int64(), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(blockcache_connected_blocks, TestChain100Setup)
+{
+    // the blocks connected by the fixture are read from the cache, and match what is on disk
+    const CBlockIndex* pindex = WITH_LOCK(cs_main, return ::ChainActive().Tip());
+    const int64_t nHits = recentblockcache.ToJSON()["hits"].get_int64();
+    CBlock block, blockDisk;
+    BOOST_CHECK(ReadBlockFromCacheOrDisk(block, pindex, Params().GetConsensus()));
+    BOOST_CHECK(ReadBlockFromDisk(blockDisk, pindex, Params().GetConsensus()));
+    BOOST_CHECK_EQUAL(recentblockcache.ToJSON()["hits"].get_int64(), nHits + 1);
+    BOOST_CHECK(block.GetHash() == blockDisk.GetHash());
+    BOOST_CHECK(block.vtx.size() == blockDisk.vtx.size());
+    BOOST_CHECK(block.vtx[0]->GetHash() == blockDisk.vtx[0]->GetHash());
+
+    // blocks that are not cached are read from disk
+    recentblockcache.Clear();
+    const int64_t nMisses = recentblockcache.ToJSON()["misses"].get_int64();
+    BOOST_CHECK(ReadBlockFromCacheOrDisk(block, pindex, Params().GetConsensus()));
+    BOOST_CHECK(block.GetHash() == blockDisk.GetHash());
+    BOOST_CHECK_EQUAL(recentblockcache.ToJSON()["misses"].get_int64(), nMisses + 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,257 @@
+// Copyright (c) 2020 The Syscoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <cachemap.h>
+#include <cachemultimap.h>
+#include <clientversion.h>
+#include <crypto/common.h>
+#include <streams.h>
+
+#include <test/util/setup_common.h>
+
+#include <list>
+#include <map>
+#include <set>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_FIXTURE_TEST_SUITE(cachemap_tests, BasicTestingSetup)
+
+static uint256 Key(uint32_t n)
+{
+    uint256 key;
+    WriteLE32(key.begin(), n);
+    return key;
+}
+
+BOOST_AUTO_TEST_CASE(cachemap_test)
+{
+    CacheMap<uint256, int> cache(10);
+    BOOST_CHECK_EQUAL(cache.GetMaxSize(), 10U);
+    BOOST_CHECK_EQUAL(cache.GetSize(), 0U);
+
+    for (int i = 0; i < 10; ++i) {
+        BOOST_CHECK(cache.Insert(Key(i), i));
+    }
+    BOOST_CHECK_EQUAL(cache.GetSize(), 10U);
+    // duplicate keys are rejected and keep the old value
+    BOOST_CHECK(!cache.Insert(Key(3), 33));
+    int nValue = 0;
+    BOOST_CHECK(cache.Get(Key(3), nValue));
+    BOOST_CHECK_EQUAL(nValue, 3);
+
+    // the least recently added item is pruned first
+    BOOST_CHECK(cache.Insert(Key(10), 10));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 10U);
+    BOOST_CHECK(!cache.HasKey(Key(0)));
+    BOOST_CHECK(cache.HasKey(Key(1)));
+
+    cache.Erase(Key(5));
+    BOOST_CHECK(!cache.HasKey(Key(5)));
+    BOOST_CHECK(!cache.Get(Key(5), nValue));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 9U);
+
+    // items are listed from the most to the least recently added one
+    std::vector<int> vecOrder;
+    for (const auto& item : cache.GetItemList()) {
+        vecOrder.push_back(item.value);
+    }
+    BOOST_CHECK(vecOrder == std::vector<int>({10, 9, 8, 7, 6, 4, 3, 2, 1}));
+
+    CacheMap<uint256, int> copy(cache);
+    BOOST_CHECK_EQUAL(copy.GetSize(), 9U);
+    BOOST_CHECK(copy.Get(Key(10), nValue));
+    BOOST_CHECK_EQUAL(nValue, 10);
+
+    cache.Clear();
+    BOOST_CHECK_EQUAL(cache.GetSize(), 0U);
+    BOOST_CHECK(!cache.HasKey(Key(10)));
+    BOOST_CHECK(copy.HasKey(Key(10)));
+}
+
+BOOST_AUTO_TEST_CASE(cachemap_random_test)
+{
+    // compare against a std::map/std::list reference under heavy churn
+    CacheMap<uint256, int> cache(500);
+    std::list<std::pair<uint256, int>> listRef;
+    std::map<uint256, int> mapRef;
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint256 key = Key(InsecureRandRange(2000));
+        if (InsecureRandBool()) {
+            const bool fInserted = cache.Insert(key, i);
+            BOOST_CHECK_EQUAL(fInserted, mapRef.count(key) == 0);
+            if (fInserted) {
+                if (listRef.size() == 500) {
+                    mapRef.erase(listRef.back().first);
+                    listRef.pop_back();
+                }
+                listRef.emplace_front(key, i);
+                mapRef.emplace(key, i);
+            }
+        } else {
+            cache.Erase(key);
+            if (mapRef.erase(key)) {
+                listRef.remove_if([&key](const std::pair<uint256, int>& item) { return item.first == key; });
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL(cache.GetSize(), listRef.size());
+    auto itRef = listRef.begin();
+    for (const auto& item : cache.GetItemList()) {
+        BOOST_CHECK(item.key == itRef->first);
+        BOOST_CHECK_EQUAL(item.value, itRef->second);
+        ++itRef;
+    }
+    for (uint32_t n = 0; n < 2000; ++n) {
+        int nValue;
+        BOOST_CHECK_EQUAL(cache.Get(Key(n), nValue), mapRef.count(Key(n)) > 0);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cachemap_serialize_test)
+{
+    CacheMap<uint256, int> cache(5);
+    std::list<CacheItem<uint256, int>> listItems;
+    for (int i = 0; i < 8; ++i) {
+        cache.Insert(Key(i), i);
+    }
+    for (int i = 7; i >= 3; --i) {
+        listItems.emplace_back(Key(i), i);
+    }
+
+    // same layout as the former std::list based implementation
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << cache;
+    CDataStream ssExpected(SER_DISK, CLIENT_VERSION);
+    ssExpected << uint32_t{5} << listItems;
+    BOOST_CHECK(ss.str() == ssExpected.str());
+
+    CacheMap<uint256, int> cacheLoaded;
+    ss >> cacheLoaded;
+    BOOST_CHECK_EQUAL(cacheLoaded.GetMaxSize(), 5U);
+    BOOST_CHECK_EQUAL(cacheLoaded.GetSize(), 5U);
+    auto it = listItems.begin();
+    for (const auto& item : cacheLoaded.GetItemList()) {
+        BOOST_CHECK(item.key == it->key);
+        BOOST_CHECK_EQUAL(item.value, it->value);
+        ++it;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cachemultimap_test)
+{
+    CacheMultiMap<uint256, int> cache(6);
+
+    BOOST_CHECK(cache.Insert(Key(1), 3));
+    BOOST_CHECK(cache.Insert(Key(1), 1));
+    BOOST_CHECK(cache.Insert(Key(1), 2));
+    BOOST_CHECK(!cache.Insert(Key(1), 2));
+    BOOST_CHECK(cache.Insert(Key(2), 7));
+    BOOST_CHECK(cache.Insert(Key(0), 9));
+    BOOST_CHECK_EQUAL(cache.GetSize(), 5U);
+
+    // Get returns the lowest value, GetAll returns them in ascending order
+    int nValue = 0;
+    BOOST_CHECK(cache.Get(Key(1), nValue));
+    BOOST_CHECK_EQUAL(nValue, 1);
+    std::vector<int> vecValues;
+    BOOST_CHECK(cache.GetAll(Key(1), vecValues));
+    BOOST_CHECK(vecValues == std::vector<int>({1, 2, 3}));
+
+    std::vector<uint256> vecKeys;
+    cache.GetKeys(vecKeys);
+    BOOST_CHECK(vecKeys == std::vector<uint256>({Key(0), Key(1), Key(2)}));
+
+    cache.Erase(Key(1), 1);
+    BOOST_CHECK(cache.Get(Key(1), nValue));
+    BOOST_CHECK_EQUAL(nValue, 2);
+    cache.Erase(Key(1), 2);
+    cache.Erase(Key(1), 3);
+    BOOST_CHECK(!cache.HasKey(Key(1)));
+    BOOST_CHECK(cache.HasKey(Key(2)));
+
+    // pruning removes single values of a key, starting with the oldest
+    for (int i = 0; i < 6; ++i) {
+        BOOST_CHECK(cache.Insert(Key(3), i));
+    }
+    BOOST_CHECK_EQUAL(cache.GetSize(), 6U);
+    BOOST_CHECK(!cache.HasKey(Key(2)));
+    BOOST_CHECK(!cache.HasKey(Key(0)));
+    BOOST_CHECK(cache.Insert(Key(4), 0));
+    BOOST_CHECK(cache.Get(Key(3), nValue));
+    BOOST_CHECK_EQUAL(nValue, 1);
+
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << cache;
+    CacheMultiMap<uint256, int> cacheLoaded;
+    ss >> cacheLoaded;
+    BOOST_CHECK_EQUAL(cacheLoaded.GetMaxSize(), 6U);
+    BOOST_CHECK_EQUAL(cacheLoaded.GetSize(), 6U);
+    vecValues.clear();
+    BOOST_CHECK(cacheLoaded.GetAll(Key(3), vecValues));
+    BOOST_CHECK(vecValues == std::vector<int>({1, 2, 3, 4, 5}));
+
+    cacheLoaded.Erase(Key(3));
+    BOOST_CHECK_EQUAL(cacheLoaded.GetSize(), 1U);
+    BOOST_CHECK(cacheLoaded.HasKey(Key(4)));
+}
+
+BOOST_AUTO_TEST_CASE(cachemultimap_random_test)
+{
+    // a few keys with hundreds of values each, which get indexed, against a reference
+    CacheMultiMap<uint256, int> cache(2000);
+    std::list<std::pair<uint256, int>> listRef;
+    std::map<uint256, std::set<int>> mapRef;
+
+    for (int i = 0; i < 20000; ++i) {
+        const uint256 key = Key(InsecureRandRange(8));
+        const int nValue = InsecureRandRange(1000);
+        if (InsecureRandRange(3) != 0) {
+            const bool fInserted = cache.Insert(key, nValue);
+            BOOST_CHECK_EQUAL(fInserted, mapRef[key].count(nValue) == 0);
+            if (fInserted) {
+                if (listRef.size() == 2000) {
+                    mapRef[listRef.back().first].erase(listRef.back().second);
+                    listRef.pop_back();
+                }
+                listRef.emplace_front(key, nValue);
+                mapRef[key].insert(nValue);
+            }
+        } else {
+            cache.Erase(key, nValue);
+            if (mapRef[key].erase(nValue)) {
+                listRef.remove(std::make_pair(key, nValue));
+            }
+        }
+    }
+
+    BOOST_CHECK_EQUAL(cache.GetSize(), listRef.size());
+    auto itRef = listRef.begin();
+    for (const auto& item : cache.GetItemList()) {
+        BOOST_CHECK(item.key == itRef->first);
+        BOOST_CHECK_EQUAL(item.value, itRef->second);
+        ++itRef;
+    }
+    CacheMultiMap<uint256, int> copy(cache);
+    for (const auto& entry : mapRef) {
+        std::vector<int> vecValues;
+        BOOST_CHECK_EQUAL(cache.GetAll(entry.first, vecValues), !entry.second.empty());
+        BOOST_CHECK(vecValues == std::vector<int>(entry.second.begin(), entry.second.end()));
+        int nValue;
+        BOOST_CHECK_EQUAL(copy.Get(entry.first, nValue), !entry.second.empty());
+        BOOST_CHECK(entry.second.empty() || nValue == *entry.second.begin());
+        // duplicates are found through the index of the copy as well
+        BOOST_CHECK(entry.second.empty() || !copy.Insert(entry.first, *entry.second.rbegin()));
+    }
+
+    // erasing all values of a key drops its index with them
+    copy.Erase(Key(0));
+    BOOST_CHECK(!copy.HasKey(Key(0)));
+    BOOST_CHECK(copy.Insert(Key(0), 1));
+    BOOST_CHECK(!copy.Insert(Key(0), 1));
+}
+
+BOOST_AUTO_TEST_SUITE_END()